@@ -0,0 +1,44 @@
+/**
+ * @file altai_lif_population.h
+ * @brief AltAILIF neuron procedures for the CPU backends.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <knp/backends/cpu-library/impl/altai_lif_population_impl.h>
+
+/**
+ * @brief Namespace for CPU backends.
+ */
+namespace knp::backends::cpu
+{
+/**
+ * @brief Make one execution step for a population of AltAILIF neurons.
+ * @details Neurons are calculated in 16-bit integer arithmetic with saturation, so results don't depend on the
+ * instruction set.
+ * @param population population to update.
+ * @param endpoint message endpoint used for message exchange.
+ * @param step_n execution step.
+ * @return message with indexes of spiked neurons, if any.
+ */
+inline std::optional<core::messaging::SpikeMessage> calculate_altai_lif_population(
+    knp::core::Population<neuron_traits::AltAILIF> &population, knp::core::MessageEndpoint &endpoint, size_t step_n)
+{
+    return calculate_altai_lif_population_impl(population, endpoint, step_n);
+}
+
+}  // namespace knp::backends::cpu
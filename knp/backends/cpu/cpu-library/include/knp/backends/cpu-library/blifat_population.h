@@ -33,13 +33,15 @@ namespace knp::backends::cpu
  * @param population population to update.
  * @param endpoint message endpoint used for message exchange.
  * @param step_n execution step.
+ * @param dense_input dense inputs accumulated by projections of the same backend, or `nullptr`.
  * @return indexes of spiked neurons.
  */
 template <class BlifatLikeNeuron>
 std::optional<core::messaging::SpikeMessage> calculate_blifat_population(
-    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint, size_t step_n)
+    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint, size_t step_n,
+    core::DenseSynapticInput *dense_input = nullptr)
 {
-    return calculate_blifat_population_impl(population, endpoint, step_n);
+    return calculate_blifat_population_impl(population, endpoint, step_n, dense_input);
 }
 
 
@@ -101,14 +101,15 @@ private:
 template <class DeltaLikeSynapse>
 inline void append_spike_times(
     knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse> &projection, const SpikeMessage &message,
-    const std::function<std::vector<size_t>(uint32_t)> &synapse_index_getter,
+    const std::function<core::SynapseIndex::Range(uint32_t)> &synapse_index_getter,
     std::vector<uint32_t> knp::synapse_traits::STDPAdditiveRule<DeltaLikeSynapse>::*spike_queue)
 {
+    // Synapses are materialized before the lookup, as materialization invalidates index ranges.
+    projection.materialize();
     // Fill synapses spike queue.
     for (auto neuron_index : message.neuron_indexes_)
     {
         // Might be able to change it into "traces".
-        // TODO: Inefficient, MUST be cached.
         for (auto synapse_index : synapse_index_getter(neuron_index))
         {
             auto &rule = std::get<core::SynapseElementAccess::synapse_data>(projection[synapse_index]).rule_;
@@ -124,7 +125,7 @@ inline void append_spike_times(
 
 inline void append_spike_times(
     knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse> &projection,
-    const std::vector<SpikeMessage> &spikes, const std::function<std::vector<size_t>(uint32_t)> &syn_index_getter,
+    const std::vector<SpikeMessage> &spikes, const std::function<core::SynapseIndex::Range(uint32_t)> &syn_index_getter,
     std::vector<uint32_t> knp::synapse_traits::STDPAdditiveRule<knp::synapse_traits::DeltaSynapse>::*spike_queue)
 {
     for (const auto &msg : spikes)
@@ -183,7 +184,7 @@ void register_additive_stdp_spikes(
             append_spike_times(
                 projection, msg,
                 [&projection](uint32_t neuron_index)
-                { return projection.find_synapses(neuron_index, ProjectionType::Search::by_postsynaptic); },
+                { return projection.get_postsynaptic_synapses(neuron_index); },
                 &knp::synapse_traits::STDPAdditiveRule<knp::synapse_traits::DeltaSynapse>::postsynaptic_spike_times_);
         }
         if (processing_type == ProcessingType::STDPAndSpike)
@@ -192,7 +193,7 @@ void register_additive_stdp_spikes(
             append_spike_times(
                 projection, msg,
                 [&projection](uint32_t neuron_index)
-                { return projection.find_synapses(neuron_index, ProjectionType::Search::by_postsynaptic); },
+                { return projection.get_postsynaptic_synapses(neuron_index); },
                 &knp::synapse_traits::STDPAdditiveRule<knp::synapse_traits::DeltaSynapse>::presynaptic_spike_times_);
         }
         if (processing_type == ProcessingType::STDPOnly)
@@ -0,0 +1,311 @@
+/**
+ * @file altai_lif_population_impl.h
+ * @brief Definition of AltAILIF neuron calculation routines.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/message_bus.h>
+#include <knp/core/population.h>
+#include <knp/neuron-traits/altai_lif.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "synaptic_impact_bucketing_impl.h"
+
+
+/**
+ * @brief Namespace for CPU backends.
+ */
+namespace knp::backends::cpu
+{
+
+/**
+ * @brief Number of AltAILIF neurons that are copied to 16-bit lanes and calculated together.
+ */
+constexpr size_t altai_lif_block_size = 256;
+
+
+/**
+ * @brief Saturate a value to the range of a neuron potential.
+ * @param value value to saturate.
+ * @return saturated value.
+ */
+constexpr int16_t saturate_altai_lif_potential(int32_t value)
+{
+    return static_cast<int16_t>(std::clamp<int32_t>(
+        value, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max()));
+}
+
+
+/**
+ * @brief Add two 16-bit values with saturation.
+ * @details All operations are done on 16-bit values, so a loop calling the function can be vectorized with 16-bit
+ * lanes.
+ * @param left first value.
+ * @param right second value.
+ * @return saturated sum.
+ */
+constexpr int16_t add_altai_lif_potential(int16_t left, int16_t right)
+{
+    const auto sum = static_cast<int16_t>(static_cast<uint16_t>(left) + static_cast<uint16_t>(right));
+    // The sum overflows if both values have the same sign, which differs from the sign of the sum.
+    const bool is_overflow = static_cast<int16_t>((left ^ sum) & (right ^ sum)) < 0;
+    const auto limit = static_cast<int16_t>((left >> 15) ^ std::numeric_limits<int16_t>::max());
+    return is_overflow ? limit : sum;
+}
+
+
+/**
+ * @brief Apply a synaptic impact to an AltAILIF neuron.
+ * @details The impact is rounded to an integer and added to the neuron potential. `EXCITATORY` impacts increase the
+ * potential, `INHIBITORY_CURRENT` impacts decrease it, and impacts of other synapse types are ignored, as AltAILIF
+ * neurons don't have conductances, dopamine, or blocking. The addition saturates to 16 bits.
+ * @param neuron neuron parameters.
+ * @param impact synaptic impact on the neuron.
+ */
+inline void impact_altai_lif_neuron(
+    neuron_traits::neuron_parameters<neuron_traits::AltAILIF> &neuron, const TargetedImpact &impact)
+{
+    constexpr float max_impact = 2.0F * std::numeric_limits<uint16_t>::max();
+    auto value = static_cast<int32_t>(std::lround(std::clamp(impact.impact_value_, -max_impact, max_impact)));
+    switch (impact.synapse_type_)
+    {
+        case synapse_traits::OutputType::EXCITATORY:
+            break;
+        case synapse_traits::OutputType::INHIBITORY_CURRENT:
+            value = -value;
+            break;
+        default:
+            return;
+    }
+    neuron.potential_ = saturate_altai_lif_potential(neuron.potential_ + value);
+}
+
+
+/**
+ * @brief Process messages sent to the current population.
+ * @details Impacts are applied in the order of messages, see `impact_altai_lif_neuron`.
+ * @param population population to update.
+ * @param messages synaptic impact messages sent to the population.
+ */
+inline void process_altai_lif_inputs(
+    knp::core::Population<neuron_traits::AltAILIF> &population,
+    const std::vector<core::messaging::SynapticImpactMessage> &messages)
+{
+    SPDLOG_TRACE("Process AltAILIF inputs.");
+    auto &neurons = population.get_neuron_states();
+    for_each_impact_in_message_order(
+        messages, [&neurons](const TargetedImpact &impact)
+        { impact_altai_lif_neuron(neurons[impact.postsynaptic_neuron_index_], impact); });
+}
+
+
+/**
+ * @brief Process impacts on a range of AltAILIF population neurons.
+ * @param population population to update.
+ * @param impacts synaptic impacts partitioned by ranges of postsynaptic neurons.
+ * @param part_index index of the neuron range.
+ * @note The method is used for parallelization.
+ */
+inline void process_altai_lif_inputs_part(
+    knp::core::Population<neuron_traits::AltAILIF> &population, const PartitionedImpacts &impacts, size_t part_index)
+{
+    SPDLOG_TRACE("Process AltAILIF inputs part.");
+    auto &neurons = population.get_neuron_states();
+    impacts.for_each_impact(
+        part_index, [&neurons](const TargetedImpact &impact)
+        { impact_altai_lif_neuron(neurons[impact.postsynaptic_neuron_index_], impact); });
+}
+
+
+/**
+ * @brief Calculate a block of AltAILIF neurons after they get synaptic impacts.
+ * @details Neuron states are copied to 16-bit arrays, and the update loop uses only 16-bit arithmetic and selects, so
+ * that the compiler can process as many neurons with a single SIMD instruction as fit into 16-bit lanes. Thresholds
+ * that don't fit into 16 bits are replaced with bounds that the potential can never cross. The leak addition
+ * saturates to 16 bits, so results are the same for any block size and instruction set. A neuron leaks, then emits a
+ * spike if its potential reaches the activation threshold, or saturates or resets if its potential falls below the
+ * negative threshold, see `neuron_parameters<AltAILIF>::is_diff_`. Potentials of neurons that don't save them are
+ * reset at the end of the step.
+ * @param neurons population neurons.
+ * @param block_start index of the first neuron in the block.
+ * @param block_size number of neurons in the block, not greater than `altai_lif_block_size`.
+ * @param neuron_indexes output parameter, indexes of spiked neurons.
+ */
+inline void calculate_altai_lif_block(
+    std::vector<neuron_traits::neuron_parameters<neuron_traits::AltAILIF>> &neurons, size_t block_start,
+    size_t block_size, knp::core::messaging::SpikeData &neuron_indexes)
+{
+    constexpr int32_t max_value = std::numeric_limits<int16_t>::max();
+    constexpr int32_t min_value = std::numeric_limits<int16_t>::min();
+    std::array<int16_t, altai_lif_block_size> potential;
+    std::array<int16_t, altai_lif_block_size> leak;
+    std::array<int16_t, altai_lif_block_size> negated_leak;
+    // A neuron spikes if its potential is greater than the spike bound.
+    std::array<int16_t, altai_lif_block_size> spike_bound;
+    // A neuron potential is negative if it is less than the negative bound.
+    std::array<int16_t, altai_lif_block_size> negative_bound;
+    std::array<int16_t, altai_lif_block_size> reset_value;
+    std::array<int16_t, altai_lif_block_size> flags;
+    std::array<int16_t, altai_lif_block_size> spiked;
+    enum : int16_t
+    {
+        is_diff = 1,
+        is_reset = 2,
+        leak_rev = 4,
+        saturate = 8,
+        do_not_save = 16
+    };
+
+    for (size_t i = 0; i < block_size; ++i)
+    {
+        const auto &neuron = neurons[block_start + i];
+        potential[i] = neuron.potential_;
+        leak[i] = neuron.potential_leak_;
+        negated_leak[i] = saturate_altai_lif_potential(-int32_t{neuron.potential_leak_});
+        spike_bound[i] = static_cast<int16_t>(std::min<int32_t>(neuron.activation_threshold_ - 1, max_value));
+        negative_bound[i] = static_cast<int16_t>(std::max<int32_t>(-neuron.negative_activation_threshold_, min_value));
+        reset_value[i] = static_cast<int16_t>(std::min<int32_t>(neuron.potential_reset_value_, max_value));
+        flags[i] = static_cast<int16_t>(
+            neuron.is_diff_ * is_diff | neuron.is_reset_ * is_reset | neuron.leak_rev_ * leak_rev |
+            neuron.saturate_ * saturate | neuron.do_not_save_ * do_not_save);
+    }
+
+    // All array elements are loaded before they are selected, as conditional loads prevent vectorization.
+    for (size_t i = 0; i < block_size; ++i)
+    {
+        const int16_t flag = flags[i];
+        const int16_t old_value = potential[i];
+        const int16_t positive_leak = leak[i];
+        const int16_t negative_leak = negated_leak[i];
+        const int16_t upper_bound = spike_bound[i];
+        const int16_t lower_bound = negative_bound[i];
+        const int16_t reset = reset_value[i];
+
+        const bool is_leak_reversed = ((flag & leak_rev) != 0) & (old_value < 0);
+        const int16_t value = add_altai_lif_potential(old_value, is_leak_reversed ? negative_leak : positive_leak);
+        const bool is_positive = value > upper_bound;
+        const bool is_negative = value < lower_bound;
+
+        // Differences don't overflow, as they are used only if the value crosses the bound.
+        const auto positive_diff = static_cast<int16_t>(static_cast<uint16_t>(value) - upper_bound - 1);
+        const auto negative_diff = static_cast<int16_t>(static_cast<uint16_t>(value) - lower_bound);
+        int16_t positive_value = (flag & is_diff) ? positive_diff : value;
+        positive_value = (flag & is_reset) ? reset : positive_value;
+        int16_t negative_value = (flag & is_diff) ? negative_diff : value;
+        negative_value = (flag & is_reset) ? static_cast<int16_t>(-reset) : negative_value;
+        negative_value = (flag & saturate) ? lower_bound : negative_value;
+
+        int16_t new_value = is_negative ? negative_value : value;
+        new_value = is_positive ? positive_value : new_value;
+        potential[i] = (flag & do_not_save) ? reset : new_value;
+        spiked[i] = is_positive;
+    }
+
+    for (size_t i = 0; i < block_size; ++i)
+    {
+        neurons[block_start + i].potential_ = potential[i];
+        if (spiked[i]) neuron_indexes.push_back(block_start + i);
+    }
+}
+
+
+/**
+ * @brief Partially calculate AltAILIF population after it receives synaptic impact messages.
+ * @details Indexes of spiked neurons are added in the increasing order.
+ * @param population population to update.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_end index of the neuron after the last neuron to calculate.
+ * @param neuron_indexes output parameter, indexes of spiked neurons.
+ * @note The method is used for parallelization.
+ */
+inline void calculate_altai_lif_post_input_state_part(
+    knp::core::Population<neuron_traits::AltAILIF> &population, size_t part_start, size_t part_end,
+    knp::core::messaging::SpikeData &neuron_indexes)
+{
+    SPDLOG_TRACE("Calculate AltAILIF neuron post-input state part.");
+    auto &neurons = population.get_neuron_states();
+    part_end = std::min(part_end, neurons.size());
+    for (size_t block_start = part_start; block_start < part_end; block_start += altai_lif_block_size)
+    {
+        calculate_altai_lif_block(
+            neurons, block_start, std::min(altai_lif_block_size, part_end - block_start), neuron_indexes);
+    }
+}
+
+
+/**
+ * @brief Partially calculate AltAILIF population after it receives synaptic impact messages.
+ * @param population population to update.
+ * @param message output spike message to update.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_size number of neurons to calculate in a single call.
+ * @param mutex mutex that is locked to update a message.
+ * @note The method is used for parallelization. Indexes of spiked neurons are added in the order in which parts are
+ * finished.
+ */
+inline void calculate_altai_lif_post_input_state_part(
+    knp::core::Population<neuron_traits::AltAILIF> &population, knp::core::messaging::SpikeMessage &message,
+    size_t part_start, size_t part_size, std::mutex &mutex)
+{
+    knp::core::messaging::SpikeData output;
+    calculate_altai_lif_post_input_state_part(population, part_start, part_start + part_size, output);
+
+    // Updating common neuron indexes.
+    const std::lock_guard<std::mutex> lock(mutex);
+    message.neuron_indexes_.insert(message.neuron_indexes_.end(), output.begin(), output.end());
+}
+
+
+/**
+ * @brief Make one execution step for a population of AltAILIF neurons.
+ * @param population population to update.
+ * @param endpoint message endpoint used for message exchange.
+ * @param step_n execution step.
+ * @return message with indexes of spiked neurons, if any.
+ */
+inline std::optional<core::messaging::SpikeMessage> calculate_altai_lif_population_impl(
+    knp::core::Population<neuron_traits::AltAILIF> &population, knp::core::MessageEndpoint &endpoint, size_t step_n)
+{
+    SPDLOG_DEBUG("Calculating AltAILIF population {}...", std::string{population.get_uid()});
+    process_altai_lif_inputs(
+        population, endpoint.unload_messages<core::messaging::SynapticImpactMessage>(population.get_uid()));
+    knp::core::messaging::SpikeData neuron_indexes;
+    calculate_altai_lif_post_input_state_part(population, 0, population.size(), neuron_indexes);
+    if (neuron_indexes.empty()) return {};
+
+    knp::core::messaging::SpikeMessage res_message{{population.get_uid(), step_n}, neuron_indexes};
+    endpoint.send_message(res_message);
+    SPDLOG_DEBUG("Sent {} spike(s).", res_message.neuron_indexes_.size());
+    return res_message;
+}
+
+}  // namespace knp::backends::cpu
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <knp/core/dense_synaptic_input.h>
 #include <knp/core/message_bus.h>
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
@@ -28,14 +29,17 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <mutex>
 #include <optional>
 #include <queue>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "synaptic_impact_bucketing_impl.h"
 #include "synaptic_resource_stdp_impl.h"
 
 /**
@@ -110,55 +114,448 @@ void impact_neuron(
 
 
 /**
- * @brief Process messages sent to the current population.
- * @param population population to update.
- * @param messages synaptic impact messages sent to the population.
- * @note The method is used for parallelization. See later if this method serves as a bottleneck.
+ * @brief Calculate the result of a synaptic impact on a neuron stored in columns.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Scalar type of floating-point neuron parameters.
+ * @param columns neuron columns.
+ * @param index neuron index.
+ * @param synapse_type type of input signal.
+ * @param impact_value value of input signal.
+ */
+template <class BlifatLikeNeuron, class Scalar>
+void impact_neuron_columns(
+    knp::core::BasicBLIFATNeuronColumns<Scalar> &columns, size_t index,
+    const knp::synapse_traits::OutputType &synapse_type, float impact_value)
+{
+    switch (synapse_type)
+    {
+        case knp::synapse_traits::OutputType::EXCITATORY:
+            columns.potential_[index] += static_cast<Scalar>(impact_value);
+            break;
+        case knp::synapse_traits::OutputType::INHIBITORY_CURRENT:
+            columns.potential_[index] -= static_cast<Scalar>(impact_value);
+            break;
+        case knp::synapse_traits::OutputType::INHIBITORY_CONDUCTANCE:
+            columns.inhibitory_conductance_[index] += static_cast<Scalar>(impact_value);
+            break;
+        case knp::synapse_traits::OutputType::DOPAMINE:
+            columns.dopamine_value_[index] += static_cast<Scalar>(impact_value);
+            break;
+        case knp::synapse_traits::OutputType::BLOCKING:
+            columns.total_blocking_period_[index] = static_cast<unsigned int>(impact_value);
+            break;
+    }
+}
+
+
+/**
+ * @brief Call a function with a bit mask of BLIFAT features as a compile-time constant.
+ * @details The function is instantiated for each combination of features, so kernels called by it don't contain
+ * code of unused features.
+ * @tparam Features feature combination to check.
+ * @tparam Function type of function that accepts `std::integral_constant<unsigned, Features>`.
+ * @param features bit mask of `core::BLIFATFeatures` values.
+ * @param function function to call.
+ */
+template <unsigned Features = 0, class Function>
+void dispatch_blifat_features(unsigned features, Function &&function)
+{
+    if constexpr (core::BLIFATFeatures::all == Features)
+    {
+        function(std::integral_constant<unsigned, Features>{});
+    }
+    else
+    {
+        if (Features == features)
+        {
+            function(std::integral_constant<unsigned, Features>{});
+        }
+        else
+        {
+            dispatch_blifat_features<Features + 1>(features, std::forward<Function>(function));
+        }
+    }
+}
+
+
+/**
+ * @brief Get features that are used by a neuron after it receives a synaptic input.
+ * @param synapse_type type of input signal.
+ * @return bit mask of `core::BLIFATFeatures` values.
+ */
+constexpr unsigned get_input_features(knp::synapse_traits::OutputType synapse_type)
+{
+    switch (synapse_type)
+    {
+        case knp::synapse_traits::OutputType::INHIBITORY_CONDUCTANCE:
+            return core::BLIFATFeatures::inhibitory_conductance;
+        case knp::synapse_traits::OutputType::BLOCKING:
+            return core::BLIFATFeatures::blocking;
+        default:
+            return 0;
+    }
+}
+
+
+/**
+ * @brief Call a function for each set of neuron columns used by a population.
+ * @details In the precision validation mode, the function is called for double-precision columns first.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Function type of function that accepts neuron columns of any precision.
+ * @param population population of BLIFAT-like neurons.
+ * @param function function to call.
+ * @return `false` if the population is stored as an array of structures.
+ */
+template <class BlifatLikeNeuron, class Function>
+bool for_each_neuron_columns(knp::core::Population<BlifatLikeNeuron> &population, Function &&function)
+{
+    const auto storage = population.get_storage();
+    if (core::NeuronStorage::array_of_structures == storage) return false;
+    if (core::NeuronStorage::single_precision_structure_of_arrays != storage)
+    {
+        function(population.template get_neuron_columns<double>());
+    }
+    if (core::NeuronStorage::single_precision_structure_of_arrays == storage ||
+        core::NeuronStorage::precision_validation == storage)
+    {
+        function(population.template get_neuron_columns<float>());
+    }
+    return true;
+}
+
+
+/**
+ * @brief Check if only active neurons of a population are updated on each step.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @param population population of BLIFAT-like neurons.
+ * @return `true` if the population is event-driven.
  */
 template <class BlifatLikeNeuron>
-void process_inputs(
-    knp::core::Population<BlifatLikeNeuron> &population,
-    const std::vector<core::messaging::SynapticImpactMessage> &messages)
+bool is_event_driven(const knp::core::Population<BlifatLikeNeuron> &population)
 {
-    SPDLOG_TRACE("Process inputs.");
-    for (const auto &message : messages)
+    if constexpr (std::is_same_v<BlifatLikeNeuron, neuron_traits::BLIFATNeuron>)
+    {
+        return population.is_event_driven();
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+/**
+ * @brief Call a function for each neuron in the index range that must be updated on the current step.
+ * @details All neurons are updated unless the population is event-driven.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Function type of function that accepts a neuron index.
+ * @param population population of BLIFAT-like neurons.
+ * @param part_start index of the first neuron in the range.
+ * @param part_end index of the neuron after the last neuron in the range.
+ * @param function function to call.
+ */
+template <class BlifatLikeNeuron, class Function>
+void for_each_updated_neuron(
+    knp::core::Population<BlifatLikeNeuron> &population, size_t part_start, size_t part_end, Function &&function)
+{
+    if (is_event_driven(population))
+    {
+        population.get_active_set().for_each_active_neuron(part_start, part_end, function);
+        return;
+    }
+    for (size_t i = part_start; i < part_end; ++i) function(i);
+}
+
+
+/**
+ * @brief Call a function for each non-zero dense input of neurons in the index range that a population processes on a
+ * step.
+ * @tparam Function type of function that accepts a neuron index, an output type and an impact value.
+ * @param dense_input dense inputs of the population.
+ * @param step_n step on which the population processes inputs.
+ * @param part_start index of the first neuron in the range.
+ * @param part_end index of the neuron after the last neuron in the range.
+ * @param function function to call.
+ */
+template <class Function>
+void for_each_dense_impact(
+    const core::DenseSynapticInput &dense_input, uint64_t step_n, size_t part_start, size_t part_end,
+    Function &&function)
+{
+    dense_input.for_each_input(
+        step_n,
+        [&function, part_start, part_end](
+            knp::synapse_traits::OutputType synapse_type, const std::vector<float> &values)
+        {
+            const size_t values_end = std::min(part_end, values.size());
+            for (size_t index = part_start; index < values_end; ++index)
+            {
+                if (0.0F != values[index]) function(index, synapse_type, values[index]);
+            }
+        });
+}
+
+
+/**
+ * @brief Apply synaptic impacts and dense inputs to neurons in the index range.
+ * @details Dense inputs are applied after impacts. Features used by inputs are returned instead of being enabled, so
+ * that different ranges can be processed in parallel.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam ForEachImpact type of function that accepts a function to call for each `TargetedImpact`.
+ * @param population population to update.
+ * @param for_each_impact function that calls its argument for each impact on neurons of the range.
+ * @param dense_input dense inputs of the population, or `nullptr` if the population receives only messages.
+ * @param step_n current step.
+ * @param part_start index of the first neuron in the range.
+ * @param part_end index of the neuron after the last neuron in the range.
+ * @param woken_neurons output parameter, indexes of woken neurons of an event-driven population.
+ * @return bit mask of `core::BLIFATFeatures` values used by inputs.
+ */
+template <class BlifatLikeNeuron, class ForEachImpact>
+unsigned process_inputs_range(
+    knp::core::Population<BlifatLikeNeuron> &population, ForEachImpact &&for_each_impact,
+    const core::DenseSynapticInput *dense_input, uint64_t step_n, size_t part_start, size_t part_end,
+    std::vector<size_t> &woken_neurons)
+{
+    unsigned input_features = 0;
+    auto process_column_inputs =
+        [&for_each_impact, &input_features, dense_input, step_n, part_start, part_end](auto &columns)
     {
-        for (const auto &impact : message.impacts_)
+        for_each_impact(
+            [&columns, &input_features](const TargetedImpact &impact)
+            {
+                const size_t index = impact.postsynaptic_neuron_index_;
+                input_features |= get_input_features(impact.synapse_type_);
+                impact_neuron_columns<BlifatLikeNeuron>(columns, index, impact.synapse_type_, impact.impact_value_);
+                if constexpr (has_dopamine_plasticity<BlifatLikeNeuron>())
+                {
+                    if (impact.synapse_type_ == synapse_traits::OutputType::EXCITATORY)
+                    {
+                        columns.is_being_forced_[index] |= static_cast<uint8_t>(impact.is_forcing_);
+                    }
+                }
+            });
+        if (!dense_input) return;
+        for_each_dense_impact(
+            *dense_input, step_n, part_start, part_end,
+            [&columns, &input_features](size_t index, knp::synapse_traits::OutputType synapse_type, float value)
+            {
+                input_features |= get_input_features(synapse_type);
+                impact_neuron_columns<BlifatLikeNeuron>(columns, index, synapse_type, value);
+            });
+    };
+    if (for_each_neuron_columns(population, process_column_inputs)) return input_features;
+
+    auto &neurons = population.get_neuron_states();
+    const bool event_driven = is_event_driven(population);
+    // Returns a neuron that receives an input, waking it if it sleeps.
+    auto get_input_neuron = [&population, &neurons, &input_features, &woken_neurons, event_driven](
+                                size_t index, knp::synapse_traits::OutputType synapse_type) -> auto &
+    {
+        auto &neuron = neurons[index];
+        if (event_driven) population.get_active_set().wake(index, neuron, woken_neurons);
+        input_features |= get_input_features(synapse_type);
+        return neuron;
+    };
+    for_each_impact(
+        [&get_input_neuron](const TargetedImpact &impact)
         {
-            auto &neuron = population[impact.postsynaptic_neuron_index_];
+            auto &neuron = get_input_neuron(impact.postsynaptic_neuron_index_, impact.synapse_type_);
             impact_neuron<BlifatLikeNeuron>(neuron, impact.synapse_type_, impact.impact_value_);
             if constexpr (has_dopamine_plasticity<BlifatLikeNeuron>())
             {
                 if (impact.synapse_type_ == synapse_traits::OutputType::EXCITATORY)
                 {
-                    neuron.is_being_forced_ |= message.is_forcing_;
+                    neuron.is_being_forced_ |= impact.is_forcing_;
                 }
             }
-        }
+        });
+    if (!dense_input) return input_features;
+    for_each_dense_impact(
+        *dense_input, step_n, part_start, part_end,
+        [&get_input_neuron](size_t index, knp::synapse_traits::OutputType synapse_type, float value)
+        { impact_neuron<BlifatLikeNeuron>(get_input_neuron(index, synapse_type), synapse_type, value); });
+    return input_features;
+}
+
+
+/**
+ * @brief Finish processing of population inputs on the current step.
+ * @details Processed dense inputs are removed, woken neurons become active, and features used by inputs are enabled,
+ * as they must be enabled before neuron states are calculated.
+ * @param population population to update.
+ * @param input_features bit mask of `core::BLIFATFeatures` values used by inputs.
+ * @param dense_input dense inputs of the population, or `nullptr` if the population receives only messages.
+ * @param step_n current step.
+ */
+template <class BlifatLikeNeuron>
+void finish_inputs(
+    knp::core::Population<BlifatLikeNeuron> &population, unsigned input_features,
+    core::DenseSynapticInput *dense_input, uint64_t step_n)
+{
+    if (dense_input) dense_input->finish_step(step_n);
+    if (is_event_driven(population)) population.get_active_set().finish_inputs();
+    population.enable_features(input_features);
+}
+
+
+/**
+ * @brief Process messages sent to the current population.
+ * @details Impacts are applied in the order of messages. Dense inputs accumulated by projections of the same backend
+ * are processed after messages and removed.
+ * @param population population to update.
+ * @param messages synaptic impact messages sent to the population.
+ * @param dense_input dense inputs of the population, or `nullptr` if the population receives only messages.
+ * @param step_n current step.
+ * @note Inputs of large populations are processed in parallel by `process_inputs_part`.
+ */
+template <class BlifatLikeNeuron>
+void process_inputs(
+    knp::core::Population<BlifatLikeNeuron> &population,
+    const std::vector<core::messaging::SynapticImpactMessage> &messages,
+    core::DenseSynapticInput *dense_input = nullptr, uint64_t step_n = 0)
+{
+    SPDLOG_TRACE("Process inputs.");
+    const size_t neurons_count = population.size();
+    if (is_event_driven(population)) population.get_active_set().start_step();
+    std::vector<size_t> woken_neurons;
+    const unsigned input_features = process_inputs_range(
+        population,
+        [&messages](auto &&function) { for_each_impact_in_message_order(messages, function); },
+        dense_input, step_n, 0, neurons_count, woken_neurons);
+    if (!woken_neurons.empty()) population.get_active_set().add_woken_neurons(woken_neurons);
+    finish_inputs(population, input_features, dense_input, step_n);
+}
+
+
+/**
+ * @brief Inputs of a population that are processed in parallel by ranges of neurons.
+ */
+struct PartitionedInputs
+{
+    /**
+     * @brief Synaptic impacts partitioned by ranges of postsynaptic neurons.
+     */
+    PartitionedImpacts impacts_;
+
+    /**
+     * @brief Bit masks of features used by inputs of each range.
+     */
+    std::vector<unsigned> input_features_;
+
+    /**
+     * @brief Indexes of neurons woken in each range of an event-driven population.
+     */
+    std::vector<std::vector<size_t>> woken_neurons_;
+};
+
+
+/**
+ * @brief Prepare inputs of a population to be processed in parallel by ranges of neurons.
+ * @details Impacts of messages are partitioned by ranges, so that each range gets only impacts on its neurons.
+ * @param population population to update.
+ * @param messages synaptic impact messages sent to the population.
+ * @param part_size number of neurons in a range.
+ * @param inputs output parameter, partitioned inputs.
+ */
+template <class BlifatLikeNeuron>
+void start_partitioned_inputs(
+    knp::core::Population<BlifatLikeNeuron> &population,
+    const std::vector<core::messaging::SynapticImpactMessage> &messages, size_t part_size, PartitionedInputs &inputs)
+{
+    SPDLOG_TRACE("Partition inputs.");
+    if (is_event_driven(population)) population.get_active_set().start_step();
+    inputs.impacts_.partition(messages, population.size(), part_size);
+    inputs.input_features_.assign(inputs.impacts_.parts_count(), 0);
+    inputs.woken_neurons_.resize(inputs.impacts_.parts_count());
+    for (auto &woken_neurons : inputs.woken_neurons_) woken_neurons.clear();
+}
+
+
+/**
+ * @brief Process inputs of a range of population neurons.
+ * @details Impacts on the same neuron are applied in the same order as by `process_inputs`, so results are exactly
+ * the same.
+ * @param population population to update.
+ * @param inputs partitioned inputs.
+ * @param part_index index of the neuron range.
+ * @param dense_input dense inputs of the population, or `nullptr` if the population receives only messages.
+ * @param step_n current step.
+ * @note The method is used for parallelization. Different ranges can be processed in parallel between
+ * `start_partitioned_inputs` and `finish_partitioned_inputs`.
+ */
+template <class BlifatLikeNeuron>
+void process_inputs_part(
+    knp::core::Population<BlifatLikeNeuron> &population, PartitionedInputs &inputs, size_t part_index,
+    const core::DenseSynapticInput *dense_input, uint64_t step_n)
+{
+    SPDLOG_TRACE("Process inputs part.");
+    const size_t part_start = part_index * inputs.impacts_.part_size();
+    const size_t part_end = std::min(part_start + inputs.impacts_.part_size(), population.size());
+    inputs.input_features_[part_index] = process_inputs_range(
+        population,
+        [&inputs, part_index](auto &&function) { inputs.impacts_.for_each_impact(part_index, function); },
+        dense_input, step_n, part_start, part_end, inputs.woken_neurons_[part_index]);
+}
+
+
+/**
+ * @brief Finish processing of population inputs that were processed by ranges of neurons.
+ * @param population population to update.
+ * @param inputs partitioned inputs.
+ * @param dense_input dense inputs of the population, or `nullptr` if the population receives only messages.
+ * @param step_n current step.
+ */
+template <class BlifatLikeNeuron>
+void finish_partitioned_inputs(
+    knp::core::Population<BlifatLikeNeuron> &population, const PartitionedInputs &inputs,
+    core::DenseSynapticInput *dense_input, uint64_t step_n)
+{
+    unsigned input_features = 0;
+    for (const unsigned part_features : inputs.input_features_) input_features |= part_features;
+    // Ranges follow each other, so woken neurons are added in the increasing order of their indexes.
+    for (const auto &woken_neurons : inputs.woken_neurons_)
+    {
+        if (!woken_neurons.empty()) population.get_active_set().add_woken_neurons(woken_neurons);
     }
+    finish_inputs(population, input_features, dense_input, step_n);
 }
 
 
 /**
  * @brief Calculate a single neuron state before impacts.
  * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Features bit mask of `core::BLIFATFeatures` values used by the neuron. Other features are not calculated.
  * @param neuron neuron parameters.
  */
-template <class BlifatLikeNeuron>
+template <class BlifatLikeNeuron, unsigned Features = core::BLIFATFeatures::all>
 void calculate_single_neuron_state(typename knp::core::Population<BlifatLikeNeuron>::NeuronParameters &neuron)
 {
-    neuron.dynamic_threshold_ *= neuron.threshold_decay_;
+    if constexpr (Features & core::BLIFATFeatures::dynamic_threshold)
+    {
+        neuron.dynamic_threshold_ *= neuron.threshold_decay_;
+    }
     neuron.postsynaptic_trace_ *= neuron.postsynaptic_trace_decay_;
-    neuron.inhibitory_conductance_ *= neuron.inhibitory_conductance_decay_;
+    if constexpr (Features & core::BLIFATFeatures::inhibitory_conductance)
+    {
+        neuron.inhibitory_conductance_ *= neuron.inhibitory_conductance_decay_;
+    }
     if constexpr (has_dopamine_plasticity<BlifatLikeNeuron>())
     {
         neuron.dopamine_value_ = 0.0;
         neuron.is_being_forced_ = false;
     }
 
-    if (neuron.bursting_phase_ && !--neuron.bursting_phase_)
+    if constexpr (Features & core::BLIFATFeatures::bursting)
     {
-        neuron.potential_ = neuron.potential_ * neuron.potential_decay_ + neuron.reflexive_weight_;
+        if (neuron.bursting_phase_ && !--neuron.bursting_phase_)
+        {
+            neuron.potential_ = neuron.potential_ * neuron.potential_decay_ + neuron.reflexive_weight_;
+        }
+        else
+        {
+            neuron.potential_ *= neuron.potential_decay_;
+        }
     }
     else
     {
@@ -168,6 +565,137 @@ void calculate_single_neuron_state(typename knp::core::Population<BlifatLikeNeur
 }
 
 
+/**
+ * @brief Read-only access to an array of constant neuron parameters.
+ * @details If the parameter is shared by all neurons, its value is kept in a local variable, so the compiler can
+ * broadcast it to a vector register once per loop.
+ * @tparam Value parameter type.
+ * @tparam IsShared `true` if the array contains a single value shared by all neurons.
+ */
+template <class Value, bool IsShared>
+class ParameterColumn
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param column parameter array.
+     */
+    explicit ParameterColumn(const std::vector<Value> &column)
+        : values_(column.data()), shared_value_(IsShared ? column.front() : Value{})
+    {
+    }
+
+    /**
+     * @brief Get parameter value of a neuron.
+     * @param index neuron index.
+     * @return parameter value.
+     */
+    Value operator[](size_t index) const
+    {
+        if constexpr (IsShared)
+        {
+            return shared_value_;
+        }
+        else
+        {
+            return values_[index];
+        }
+    }
+
+private:
+    const Value *values_;
+    Value shared_value_;
+};
+
+
+/**
+ * @brief Calculate states of neurons stored in columns before impacts.
+ * @details Each loop changes a few arrays without branches, so the compiler can vectorize it. Loops of unused
+ * features are skipped, which costs a single branch per loop.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Scalar type of floating-point neuron parameters.
+ * @param columns neuron columns.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_end index of the neuron after the last neuron to calculate.
+ * @param features bit mask of `core::BLIFATFeatures` values used by neurons.
+ * @param shared_parameters tag which is `std::true_type` if constant parameters are shared.
+ */
+template <class BlifatLikeNeuron, class Scalar, bool SharedParameters>
+void calculate_neuron_columns_state(
+    knp::core::BasicBLIFATNeuronColumns<Scalar> &columns, size_t part_start, size_t part_end, unsigned features,
+    [[maybe_unused]] std::bool_constant<SharedParameters> shared_parameters)
+{
+    const ParameterColumn<Scalar, SharedParameters> threshold_decay(columns.threshold_decay_);
+    const ParameterColumn<Scalar, SharedParameters> trace_decay(columns.postsynaptic_trace_decay_);
+    const ParameterColumn<Scalar, SharedParameters> conductance_decay(columns.inhibitory_conductance_decay_);
+    for (size_t i = part_start; i < part_end; ++i) ++columns.n_time_steps_since_last_firing_[i];
+    if (features & core::BLIFATFeatures::dynamic_threshold)
+    {
+        for (size_t i = part_start; i < part_end; ++i) columns.dynamic_threshold_[i] *= threshold_decay[i];
+    }
+    for (size_t i = part_start; i < part_end; ++i) columns.postsynaptic_trace_[i] *= trace_decay[i];
+    if (features & core::BLIFATFeatures::inhibitory_conductance)
+    {
+        for (size_t i = part_start; i < part_end; ++i) columns.inhibitory_conductance_[i] *= conductance_decay[i];
+    }
+    if constexpr (has_dopamine_plasticity<BlifatLikeNeuron>())
+    {
+        std::fill(columns.dopamine_value_.begin() + part_start, columns.dopamine_value_.begin() + part_end, Scalar{0});
+        std::fill(columns.is_being_forced_.begin() + part_start, columns.is_being_forced_.begin() + part_end, 0);
+    }
+
+    const ParameterColumn<Scalar, SharedParameters> potential_decay(columns.potential_decay_);
+    const ParameterColumn<Scalar, SharedParameters> reflexive_weight(columns.reflexive_weight_);
+    if (!(features & core::BLIFATFeatures::bursting))
+    {
+        for (size_t i = part_start; i < part_end; ++i)
+        {
+            const Scalar potential = columns.potential_[i] * potential_decay[i];
+            columns.potential_[i] = potential;
+            columns.pre_impact_potential_[i] = potential;
+        }
+        return;
+    }
+
+    for (size_t i = part_start; i < part_end; ++i)
+    {
+        const unsigned bursting_phase = columns.bursting_phase_[i];
+        const Scalar decayed_potential = columns.potential_[i] * potential_decay[i];
+        const Scalar bursting_potential = decayed_potential + reflexive_weight[i];
+        // The bursting phase is decreased if it is not zero, and the reflexive weight is added when it ends.
+        const Scalar potential = 1 == bursting_phase ? bursting_potential : decayed_potential;
+        columns.bursting_phase_[i] = bursting_phase - (bursting_phase > 0);
+        columns.potential_[i] = potential;
+        columns.pre_impact_potential_[i] = potential;
+    }
+}
+
+
+/**
+ * @brief Calculate states of neurons stored in columns before impacts.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Scalar type of floating-point neuron parameters.
+ * @param columns neuron columns.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_end index of the neuron after the last neuron to calculate.
+ * @param features bit mask of `core::BLIFATFeatures` values used by neurons.
+ */
+template <class BlifatLikeNeuron, class Scalar>
+void calculate_neuron_columns_state(
+    knp::core::BasicBLIFATNeuronColumns<Scalar> &columns, size_t part_start, size_t part_end,
+    unsigned features = core::BLIFATFeatures::all)
+{
+    if (columns.has_shared_parameters_)
+    {
+        calculate_neuron_columns_state<BlifatLikeNeuron>(columns, part_start, part_end, features, std::true_type{});
+    }
+    else
+    {
+        calculate_neuron_columns_state<BlifatLikeNeuron>(columns, part_start, part_end, features, std::false_type{});
+    }
+}
+
+
 /**
  * @brief Partially calculate population before it receives synaptic impact messages.
  * @param population population to update.
@@ -181,12 +709,28 @@ void calculate_neurons_state_part(
 {
     size_t part_end = std::min(part_start + part_size, population.size());
     SPDLOG_TRACE("Calculate neuron state part.");
-    for (size_t i = part_start; i < part_end; ++i)
+    const unsigned features = population.get_features();
+    if (for_each_neuron_columns(
+            population, [part_start, part_end, features](auto &columns)
+            { calculate_neuron_columns_state<BlifatLikeNeuron>(columns, part_start, part_end, features); }))
     {
-        auto &neuron = population[i];
-        ++neuron.n_time_steps_since_last_firing_;
-        calculate_single_neuron_state<BlifatLikeNeuron>(neuron);
+        return;
     }
+
+    auto &neurons = population.get_neuron_states();
+    dispatch_blifat_features(
+        features,
+        [&population, &neurons, part_start, part_end](auto used_features)
+        {
+            for_each_updated_neuron(
+                population, part_start, part_end,
+                [&neurons](size_t i)
+                {
+                    auto &neuron = neurons[i];
+                    ++neuron.n_time_steps_since_last_firing_;
+                    calculate_single_neuron_state<BlifatLikeNeuron, decltype(used_features)::value>(neuron);
+                });
+        });
 }
 
 
@@ -195,22 +739,37 @@ void calculate_neurons_state_part(
  * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
  * @param population neurons population.
  * @param messages messages from the projection to the populations.
+ * @param dense_input dense inputs of the population or `nullptr`.
+ * @param step_n current step.
  */
 template <class BlifatLikeNeuron>
 void calculate_neurons_state(
     knp::core::Population<BlifatLikeNeuron> &population,
-    const std::vector<core::messaging::SynapticImpactMessage> &messages)
+    const std::vector<core::messaging::SynapticImpactMessage> &messages,
+    core::DenseSynapticInput *dense_input = nullptr, uint64_t step_n = 0)
 {
     calculate_neurons_state_part(population, 0, population.size());
-    process_inputs(population, messages);
+    process_inputs(population, messages, dense_input, step_n);
 }
 
 
-template <class BlifatLikeNeuron>
+/**
+ * @brief Finish calculation of a single neuron after it gets synaptic impacts.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Features bit mask of `core::BLIFATFeatures` values used by the neuron. Other features are not calculated.
+ * @param neuron neuron parameters.
+ * @return `true` if the neuron spiked.
+ */
+template <class BlifatLikeNeuron, unsigned Features = core::BLIFATFeatures::all>
 bool calculate_neuron_post_input_state(typename knp::core::Population<BlifatLikeNeuron>::NeuronParameters &neuron)
 {
     bool spike = false;
-    if (neuron.total_blocking_period_ <= 0)
+    if constexpr (!(Features & core::BLIFATFeatures::blocking))
+    {
+        // The neuron is not going to be unblocked.
+        neuron.total_blocking_period_ -= 1;
+    }
+    else if (neuron.total_blocking_period_ <= 0)
     {
         // TODO: Make it more readable, don't be afraid to use if operators.
         // Restore potential that the neuron had before impacts.
@@ -227,26 +786,41 @@ bool calculate_neuron_post_input_state(typename knp::core::Population<BlifatLike
         neuron.total_blocking_period_ -= 1;
     }
 
-    if (neuron.inhibitory_conductance_ < 1.0)
+    if constexpr (Features & core::BLIFATFeatures::inhibitory_conductance)
     {
-        neuron.potential_ -=
-            (neuron.potential_ - neuron.reversal_inhibitory_potential_) * neuron.inhibitory_conductance_;
+        if (neuron.inhibitory_conductance_ < 1.0)
+        {
+            neuron.potential_ -=
+                (neuron.potential_ - neuron.reversal_inhibitory_potential_) * neuron.inhibitory_conductance_;
+        }
+        else
+        {
+            neuron.potential_ = neuron.reversal_inhibitory_potential_;
+        }
     }
-    else
+
+    double threshold = neuron.activation_threshold_;
+    if constexpr (Features & core::BLIFATFeatures::dynamic_threshold)
     {
-        neuron.potential_ = neuron.reversal_inhibitory_potential_;
+        threshold += neuron.dynamic_threshold_;
     }
 
     if ((neuron.n_time_steps_since_last_firing_ > neuron.absolute_refractory_period_) &&
-        (neuron.potential_ >= neuron.activation_threshold_ + neuron.dynamic_threshold_))
+        (neuron.potential_ >= threshold))
     {
         SPDLOG_TRACE("Neuron spiked.");
         // Spike.
-        neuron.dynamic_threshold_ += neuron.threshold_increment_;
+        if constexpr (Features & core::BLIFATFeatures::dynamic_threshold)
+        {
+            neuron.dynamic_threshold_ += neuron.threshold_increment_;
+        }
         neuron.postsynaptic_trace_ += neuron.postsynaptic_trace_increment_;
 
         neuron.potential_ = neuron.potential_reset_value_;
-        neuron.bursting_phase_ = neuron.bursting_period_;
+        if constexpr (Features & core::BLIFATFeatures::bursting)
+        {
+            neuron.bursting_phase_ = neuron.bursting_period_;
+        }
         neuron.n_time_steps_since_last_firing_ = 0;
         spike = true;
     }
@@ -261,23 +835,339 @@ bool calculate_neuron_post_input_state(typename knp::core::Population<BlifatLike
 
 
 /**
- * @brief Finish calculation after the neurons get synaptic impacts.
+ * @brief Type of spike flags of neurons stored in columns.
+ * @details Spike flags have the same width as neuron parameters, as the compiler doesn't vectorize loops mixing them
+ * with byte arrays.
+ * @tparam Scalar type of floating-point neuron parameters.
+ */
+template <class Scalar>
+using BLIFATSpikeFlag = std::conditional_t<sizeof(Scalar) == sizeof(uint32_t), uint32_t, uint64_t>;
+
+
+/**
+ * @brief Number of neurons stored in columns that are calculated in a single block.
+ * @details Spike flags of a block are kept on the stack.
+ */
+constexpr size_t blifat_column_block_size = 1024;
+
+
+/**
+ * @brief Finish calculation of a block of neurons stored in columns after they get synaptic impacts.
+ * @details Neuron states are calculated without branches, so the compiler can vectorize the loops. Indexes of spiked
+ * neurons are collected in a separate loop. Loops of unused features are skipped.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Scalar type of floating-point neuron parameters.
+ * @tparam IndexContainer type of container for neuron indexes.
+ * @param columns neuron columns.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_end index of the neuron after the last neuron to calculate.
+ * @param spiked buffer for spike flags of the block neurons.
+ * @param neuron_indexes output parameter, indexes of spiked neurons.
+ * @param features bit mask of `core::BLIFATFeatures` values used by neurons.
+ * @param shared_parameters tag which is `std::true_type` if constant parameters are shared.
+ */
+template <class BlifatLikeNeuron, class Scalar, class IndexContainer, bool SharedParameters>
+void calculate_neuron_block_post_input_state(
+    knp::core::BasicBLIFATNeuronColumns<Scalar> &columns, size_t part_start, size_t part_end,
+    BLIFATSpikeFlag<Scalar> *const spiked, IndexContainer &neuron_indexes, unsigned features,
+    [[maybe_unused]] std::bool_constant<SharedParameters> shared_parameters)
+{
+    using Parameter = ParameterColumn<Scalar, SharedParameters>;
+    // Each loop reads and writes a few arrays, so the compiler can check them for aliasing and vectorize the loop.
+    Scalar *const potential = columns.potential_.data();
+    int64_t *const blocking_period = columns.total_blocking_period_.data();
+    const Scalar *const pre_impact_potential = columns.pre_impact_potential_.data();
+    if (features & core::BLIFATFeatures::blocking)
+    {
+        for (size_t i = part_start; i < part_end; ++i)
+        {
+            const int64_t period = blocking_period[i];
+            // Restore potential that the neuron had before impacts if the neuron is blocked.
+            potential[i] = period <= 0 ? pre_impact_potential[i] : potential[i];
+            // A negative blocking period increases to zero, and then the neuron is unblocked. A zero blocking period
+            // blocks the neuron forever.
+            const int64_t negative_period = -1 == period ? std::numeric_limits<int64_t>::max() : period + 1;
+            blocking_period[i] = period > 0 ? period - 1 : (period < 0 ? negative_period : 0);
+        }
+    }
+    else
+    {
+        // Neurons are not going to be unblocked.
+        for (size_t i = part_start; i < part_end; ++i) --blocking_period[i];
+    }
+
+    const Scalar *const conductance = columns.inhibitory_conductance_.data();
+    const Parameter reversal_potential(columns.reversal_inhibitory_potential_);
+    if (features & core::BLIFATFeatures::inhibitory_conductance)
+    {
+        for (size_t i = part_start; i < part_end; ++i)
+        {
+            const Scalar inhibited_potential = potential[i] - (potential[i] - reversal_potential[i]) * conductance[i];
+            potential[i] = conductance[i] < Scalar{1} ? inhibited_potential : reversal_potential[i];
+        }
+    }
+
+    size_t *const steps_since_firing = columns.n_time_steps_since_last_firing_.data();
+    const ParameterColumn<unsigned, SharedParameters> refractory_period(columns.absolute_refractory_period_);
+    const Parameter activation_threshold(columns.activation_threshold_);
+    Scalar *const dynamic_threshold = columns.dynamic_threshold_.data();
+    const Parameter threshold_increment(columns.threshold_increment_);
+    if (features & core::BLIFATFeatures::dynamic_threshold)
+    {
+        for (size_t i = part_start; i < part_end; ++i)
+        {
+            spiked[i - part_start] = (steps_since_firing[i] > refractory_period[i]) &
+                                     (potential[i] >= activation_threshold[i] + dynamic_threshold[i]);
+        }
+        for (size_t i = part_start; i < part_end; ++i)
+        {
+            const bool spike = spiked[i - part_start];
+            dynamic_threshold[i] = spike ? dynamic_threshold[i] + threshold_increment[i] : dynamic_threshold[i];
+        }
+    }
+    else
+    {
+        for (size_t i = part_start; i < part_end; ++i)
+        {
+            spiked[i - part_start] =
+                (steps_since_firing[i] > refractory_period[i]) & (potential[i] >= activation_threshold[i]);
+        }
+    }
+
+    Scalar *const trace = columns.postsynaptic_trace_.data();
+    const Parameter trace_increment(columns.postsynaptic_trace_increment_);
+    for (size_t i = part_start; i < part_end; ++i)
+    {
+        const bool spike = spiked[i - part_start];
+        trace[i] = spike ? trace[i] + trace_increment[i] : trace[i];
+        steps_since_firing[i] = spike ? 0 : steps_since_firing[i];
+    }
+
+    unsigned *const bursting_phase = columns.bursting_phase_.data();
+    const ParameterColumn<unsigned, SharedParameters> bursting_period(columns.bursting_period_);
+    if (features & core::BLIFATFeatures::bursting)
+    {
+        for (size_t i = part_start; i < part_end; ++i)
+        {
+            bursting_phase[i] = spiked[i - part_start] ? bursting_period[i] : bursting_phase[i];
+        }
+    }
+
+    const Parameter reset_value(columns.potential_reset_value_);
+    const Parameter min_potential(columns.min_potential_);
+    for (size_t i = part_start; i < part_end; ++i)
+    {
+        const bool spike = spiked[i - part_start];
+        const Scalar new_potential = spike ? reset_value[i] : potential[i];
+        potential[i] = new_potential < min_potential[i] ? min_potential[i] : new_potential;
+    }
+
+    for (size_t i = part_start; i < part_end; ++i)
+    {
+        if (spiked[i - part_start]) neuron_indexes.push_back(static_cast<typename IndexContainer::value_type>(i));
+    }
+}
+
+
+/**
+ * @brief Finish calculation of neurons stored in columns after they get synaptic impacts.
+ * @details Neurons are calculated in blocks of `blifat_column_block_size`, so spike flags don't have to be allocated.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Scalar type of floating-point neuron parameters.
+ * @tparam IndexContainer type of container for neuron indexes.
+ * @param columns neuron columns.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_end index of the neuron after the last neuron to calculate.
+ * @param neuron_indexes output parameter, indexes of spiked neurons.
+ * @param features bit mask of `core::BLIFATFeatures` values used by neurons.
+ * @param shared_parameters tag which is `std::true_type` if constant parameters are shared.
+ */
+template <class BlifatLikeNeuron, class Scalar, class IndexContainer, bool SharedParameters>
+void calculate_neuron_columns_post_input_state(
+    knp::core::BasicBLIFATNeuronColumns<Scalar> &columns, size_t part_start, size_t part_end,
+    IndexContainer &neuron_indexes, unsigned features, std::bool_constant<SharedParameters> shared_parameters)
+{
+    std::array<BLIFATSpikeFlag<Scalar>, blifat_column_block_size> spikes;
+    for (size_t block_start = part_start; block_start < part_end; block_start += blifat_column_block_size)
+    {
+        calculate_neuron_block_post_input_state<BlifatLikeNeuron>(
+            columns, block_start, std::min(part_end, block_start + blifat_column_block_size), spikes.data(),
+            neuron_indexes, features, shared_parameters);
+    }
+}
+
+
+/**
+ * @brief Finish calculation of neurons stored in columns after they get synaptic impacts.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam Scalar type of floating-point neuron parameters.
+ * @tparam IndexContainer type of container for neuron indexes.
+ * @param columns neuron columns.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_end index of the neuron after the last neuron to calculate.
+ * @param neuron_indexes output parameter, indexes of spiked neurons.
+ * @param features bit mask of `core::BLIFATFeatures` values used by neurons.
+ */
+template <class BlifatLikeNeuron, class Scalar, class IndexContainer>
+void calculate_neuron_columns_post_input_state(
+    knp::core::BasicBLIFATNeuronColumns<Scalar> &columns, size_t part_start, size_t part_end,
+    IndexContainer &neuron_indexes, unsigned features = core::BLIFATFeatures::all)
+{
+    if (columns.has_shared_parameters_)
+    {
+        calculate_neuron_columns_post_input_state<BlifatLikeNeuron>(
+            columns, part_start, part_end, neuron_indexes, features, std::true_type{});
+    }
+    else
+    {
+        calculate_neuron_columns_post_input_state<BlifatLikeNeuron>(
+            columns, part_start, part_end, neuron_indexes, features, std::false_type{});
+    }
+}
+
+
+/**
+ * @brief Finish calculation of population neurons stored in columns after they get synaptic impacts.
+ * @details In the precision validation mode, spikes are defined by double-precision columns, and single-precision
+ * spikes are compared with them.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @tparam IndexContainer type of container for neuron indexes.
+ * @param population population of BLIFAT-like neurons stored in columns.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_end index of the neuron after the last neuron to calculate.
+ * @param neuron_indexes output parameter, indexes of spiked neurons.
+ * @return divergence of single-precision spikes, which is empty if the population is not validated.
+ */
+template <class BlifatLikeNeuron, class IndexContainer>
+core::PrecisionDivergence calculate_population_columns_post_input_state(
+    knp::core::Population<BlifatLikeNeuron> &population, size_t part_start, size_t part_end,
+    IndexContainer &neuron_indexes)
+{
+    const unsigned features = population.get_features();
+    if (core::NeuronStorage::single_precision_structure_of_arrays == population.get_storage())
+    {
+        calculate_neuron_columns_post_input_state<BlifatLikeNeuron>(
+            population.template get_neuron_columns<float>(), part_start, part_end, neuron_indexes, features);
+        return {};
+    }
+
+    const size_t first_spike = neuron_indexes.size();
+    calculate_neuron_columns_post_input_state<BlifatLikeNeuron>(
+        population.template get_neuron_columns<double>(), part_start, part_end, neuron_indexes, features);
+    if (core::NeuronStorage::precision_validation != population.get_storage()) return {};
+
+    std::vector<size_t> float_indexes;
+    calculate_neuron_columns_post_input_state<BlifatLikeNeuron>(
+        population.template get_neuron_columns<float>(), part_start, part_end, float_indexes, features);
+
+    // Both index sequences are sorted, so they are compared in a single pass.
+    core::PrecisionDivergence divergence;
+    divergence.reference_spikes_ = neuron_indexes.size() - first_spike;
+    auto reference_iter = neuron_indexes.begin() + static_cast<std::ptrdiff_t>(first_spike);
+    auto float_iter = float_indexes.begin();
+    while (reference_iter != neuron_indexes.end() && float_iter != float_indexes.end())
+    {
+        if (*reference_iter == *float_iter)
+        {
+            ++reference_iter;
+            ++float_iter;
+            continue;
+        }
+        ++divergence.divergent_spikes_;
+        if (*reference_iter < *float_iter)
+        {
+            ++reference_iter;
+        }
+        else
+        {
+            ++float_iter;
+        }
+    }
+    divergence.divergent_spikes_ += (neuron_indexes.end() - reference_iter) + (float_indexes.end() - float_iter);
+    return divergence;
+}
+
+
+/**
+ * @brief Add divergence of single-precision spikes to population statistics.
  * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
  * @param population population of BLIFAT-like neurons.
+ * @param divergence spike divergence of a population part.
+ */
+template <class BlifatLikeNeuron>
+void add_precision_divergence(
+    knp::core::Population<BlifatLikeNeuron> &population, const core::PrecisionDivergence &divergence)
+{
+    if (core::NeuronStorage::precision_validation != population.get_storage()) return;
+    auto &population_divergence = population.get_precision_divergence();
+    population_divergence.reference_spikes_ += divergence.reference_spikes_;
+    population_divergence.divergent_spikes_ += divergence.divergent_spikes_;
+    if (divergence.divergent_spikes_)
+    {
+        SPDLOG_DEBUG(
+            "Single-precision spikes of population {} diverge: {} of {} spikes differ.",
+            std::string(population.get_uid()), divergence.divergent_spikes_, divergence.reference_spikes_);
+    }
+}
+
+
+/**
+ * @brief Partially calculate population after it receives synaptic impact messages.
+ * @details Indexes of spiked neurons are added in the increasing order, so outputs of consecutive parts can be
+ * concatenated into a sorted sequence.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @param population population of BLIFAT-like neurons.
+ * @param part_start index of the first neuron to update.
+ * @param part_end index of the neuron after the last neuron to update.
  * @param neuron_indexes output parameter, indexes of spiked neurons.
+ * @return divergence of single-precision spikes, which must be added by `add_precision_divergence`.
+ * @note This method is used for parallelization.
  */
 template <class BlifatLikeNeuron>
-void calculate_neurons_post_input_state(
-    knp::core::Population<BlifatLikeNeuron> &population, knp::core::messaging::SpikeData &neuron_indexes)
+core::PrecisionDivergence calculate_neurons_post_input_state_part(
+    knp::core::Population<BlifatLikeNeuron> &population, size_t part_start, size_t part_end,
+    knp::core::messaging::SpikeData &neuron_indexes)
 {
     SPDLOG_TRACE("Calculate neuron post-input state part.");
-    for (size_t index = 0; index < population.size(); ++index)
+    part_end = std::min(part_end, population.size());
+    if (core::NeuronStorage::array_of_structures != population.get_storage())
     {
-        if (calculate_neuron_post_input_state<BlifatLikeNeuron>(population[index]))
-        {
-            neuron_indexes.push_back(index);
-        }
+        return calculate_population_columns_post_input_state(population, part_start, part_end, neuron_indexes);
     }
+
+    auto &neurons = population.get_neuron_states();
+    dispatch_blifat_features(
+        population.get_features(),
+        [&population, &neurons, &neuron_indexes, part_start, part_end](auto used_features)
+        {
+            for_each_updated_neuron(
+                population, part_start, part_end,
+                [&population, &neurons, &neuron_indexes](size_t index)
+                {
+                    if (calculate_neuron_post_input_state<BlifatLikeNeuron, decltype(used_features)::value>(
+                            neurons[index]))
+                    {
+                        neuron_indexes.push_back(index);
+                    }
+                    if (is_event_driven(population)) population.get_active_set().try_sleep(index, neurons[index]);
+                });
+        });
+    return {};
+}
+
+
+/**
+ * @brief Finish calculation after the neurons get synaptic impacts.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @param population population of BLIFAT-like neurons.
+ * @param neuron_indexes output parameter, indexes of spiked neurons.
+ */
+template <class BlifatLikeNeuron>
+void calculate_neurons_post_input_state(
+    knp::core::Population<BlifatLikeNeuron> &population, knp::core::messaging::SpikeData &neuron_indexes)
+{
+    add_precision_divergence(
+        population, calculate_neurons_post_input_state_part(population, 0, population.size(), neuron_indexes));
 }
 
 
@@ -288,26 +1178,21 @@ void calculate_neurons_post_input_state(
  * @param part_start index of the first neuron to update.
  * @param part_size number of neurons to calculate in a single call.
  * @param mutex mutex that is locked to update a message.
- * @note This method is used for parallelization.
+ * @note This method is used for parallelization. Indexes of spiked neurons are added in the order in which parts
+ * are finished.
  */
 template <class BlifatLikeNeuron>
 void calculate_neurons_post_input_state_part(
     knp::core::Population<BlifatLikeNeuron> &population, knp::core::messaging::SpikeMessage &message, size_t part_start,
     size_t part_size, std::mutex &mutex)
 {
-    SPDLOG_TRACE("Calculate neuron post-input state part.");
-    size_t part_end = std::min(part_start + part_size, population.size());
-    std::vector<size_t> output;
-    for (size_t i = part_start; i < part_end; ++i)
-    {
-        if (calculate_neuron_post_input_state<BlifatLikeNeuron>(population[i]))
-        {
-            output.push_back(i);
-        }
-    }
+    knp::core::messaging::SpikeData output;
+    const auto divergence =
+        calculate_neurons_post_input_state_part(population, part_start, part_start + part_size, output);
 
     // Updating common neuron indexes.
     const std::lock_guard<std::mutex> lock(mutex);
+    add_precision_divergence(population, divergence);
     message.neuron_indexes_.reserve(message.neuron_indexes_.size() + output.size());
     message.neuron_indexes_.insert(message.neuron_indexes_.end(), output.begin(), output.end());
 }
@@ -318,18 +1203,21 @@ void calculate_neurons_post_input_state_part(
  * @tparam BlifatLikeNeuron type of neuron which inference can be calculated the same as BLIFAT.
  * @param population population of BLIFAT-like neurons.
  * @param endpoint message endpoint.
+ * @param dense_input dense inputs of the population or `nullptr`.
+ * @param step_n current step.
  * @return indexes of spiked neurons.
  */
 template <class BlifatLikeNeuron>
 knp::core::messaging::SpikeData calculate_blifat_population_data(
-    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint)
+    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint,
+    core::DenseSynapticInput *dense_input = nullptr, uint64_t step_n = 0)
 {
     SPDLOG_DEBUG("Calculating BLIFAT population {}...", std::string{population.get_uid()});
-    // This whole function might be optimizable if we find a way to not loop over the whole population.
+    // Event-driven populations loop only over neurons that can spike, see `core::BLIFATActiveSet`.
     std::vector<core::messaging::SynapticImpactMessage> messages =
         endpoint.unload_messages<core::messaging::SynapticImpactMessage>(population.get_uid());
 
-    calculate_neurons_state(population, messages);
+    calculate_neurons_state(population, messages, dense_input, step_n);
     knp::core::messaging::SpikeData neuron_indexes;
     calculate_neurons_post_input_state(population, neuron_indexes);
 
@@ -339,9 +1227,10 @@ knp::core::messaging::SpikeData calculate_blifat_population_data(
 
 template <class BlifatLikeNeuron>
 std::optional<core::messaging::SpikeMessage> calculate_blifat_population_impl(
-    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint, size_t step_n)
+    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint, size_t step_n,
+    core::DenseSynapticInput *dense_input = nullptr)
 {
-    auto neuron_indexes{calculate_blifat_population_data(population, endpoint)};
+    auto neuron_indexes{calculate_blifat_population_data(population, endpoint, dense_input, step_n)};
     std::optional<knp::core::messaging::SpikeMessage> message_opt = {};
     if (!neuron_indexes.empty())
     {
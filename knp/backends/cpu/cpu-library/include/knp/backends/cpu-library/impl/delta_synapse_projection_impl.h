@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <knp/core/dense_synaptic_input.h>
 #include <knp/core/message_bus.h>
 #include <knp/core/projection.h>
 #include <knp/synapse-traits/delta.h>
@@ -29,6 +30,7 @@
 
 #include <algorithm>
 #include <mutex>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -50,13 +52,14 @@ using MessageQueue = std::unordered_map<uint64_t, knp::core::messaging::Synaptic
 template <class DeltaLikeSynapse>
 void calculate_projection_part_impl(
     knp::core::Projection<DeltaLikeSynapse> &projection, const std::unordered_map<size_t, size_t> &message_in_data,
-    MessageQueue &future_messages, uint64_t step_n, size_t part_start, size_t part_size, std::mutex &mutex);
+    MessageQueue &future_messages, uint64_t step_n, size_t part_start, size_t part_size, std::mutex &mutex,
+    core::DenseSynapticInput *dense_input = nullptr);
 
 
 template <class DeltaLikeSynapse>
 void calculate_delta_synapse_projection_impl(
     knp::core::Projection<DeltaLikeSynapse> &projection, knp::core::MessageEndpoint &endpoint,
-    MessageQueue &future_messages, size_t step_n);
+    MessageQueue &future_messages, size_t step_n, core::DenseSynapticInput *dense_input = nullptr);
 
 
 template <class ProjectionType>
@@ -73,10 +76,85 @@ constexpr bool is_forcing<knp::core::Projection<synapse_traits::DeltaSynapse>>()
 }
 
 
+/**
+ * @brief Find dense inputs to which a projection adds impacts instead of sending messages.
+ * @details Only impacts of synapses without plasticity are accumulated. The postsynaptic population must have dense
+ * inputs and must be subscribed to messages of the projection via the backend endpoint.
+ * @tparam ProjectionType projection type.
+ * @tparam DenseInputContainer type of a map from population UIDs to dense inputs.
+ * @param projection projection that sends impacts.
+ * @param dense_inputs dense inputs of backend populations.
+ * @param endpoint backend message endpoint.
+ * @return dense inputs of the postsynaptic population, or `nullptr` if the projection sends messages.
+ */
+template <class ProjectionType, class DenseInputContainer>
+core::DenseSynapticInput *find_dense_input(
+    const ProjectionType &projection, DenseInputContainer &dense_inputs, const core::MessageEndpoint &endpoint)
+{
+    using SynapseType = typename ProjectionType::ProjectionSynapseType;
+    if (!std::is_same_v<SynapseType, synapse_traits::DeltaSynapse> || !projection.is_dense_delivery()) return nullptr;
+    auto input_iter = dense_inputs.find(projection.get_postsynaptic());
+    if (input_iter == dense_inputs.end()) return nullptr;
+
+    constexpr size_t subscription_index = core::MessageEndpoint::get_type_index<
+        core::MessageEndpoint::SubscriptionVariant, core::Subscription<core::messaging::SynapticImpactMessage>>;
+    const auto &subscriptions = endpoint.get_endpoint_subscriptions();
+    auto sub_iter = subscriptions.find(std::make_pair(subscription_index, projection.get_postsynaptic()));
+    if (sub_iter == subscriptions.end() ||
+        !std::get<subscription_index>(sub_iter->second).has_sender(projection.get_uid()))
+    {
+        return nullptr;
+    }
+    return &input_iter->second;
+}
+
+
+/**
+ * @brief Call a function for each synapse of a presynaptic neuron of a procedural projection.
+ * @details Targets of a convolutional projection are computed from its kernel without creating synapses. Synapses of
+ * other procedural projections are generated into a buffer.
+ * @tparam ProjectionType projection type.
+ * @tparam Function type of the function.
+ * @param projection procedural projection.
+ * @param neuron_index presynaptic neuron index.
+ * @param synapses buffer for generated synapses.
+ * @param function function that receives synapse index, synapse parameters, presynaptic and postsynaptic neuron
+ * indexes.
+ */
+template <class ProjectionType, class Function>
+void for_each_procedural_synapse(
+    const ProjectionType &projection, size_t neuron_index, std::vector<typename ProjectionType::Synapse> &synapses,
+    Function &&function)
+{
+    size_t synapse_index = projection.get_procedural_synapse_index(neuron_index);
+    if (const auto *convolution = projection.get_convolution())
+    {
+        convolution->for_each_synapse(
+            neuron_index,
+            [&function, &synapse_index, neuron_index](const auto &synapse_params, size_t target_index)
+            {
+                function(
+                    synapse_index++, synapse_params, static_cast<uint32_t>(neuron_index),
+                    static_cast<uint32_t>(target_index));
+            });
+        return;
+    }
+
+    projection.generate_presynaptic_synapses(neuron_index, synapses);
+    for (const auto &synapse : synapses)
+    {
+        function(
+            synapse_index++, std::get<core::synapse_data>(synapse),
+            static_cast<uint32_t>(std::get<core::source_neuron_id>(synapse)),
+            static_cast<uint32_t>(std::get<core::target_neuron_id>(synapse)));
+    }
+}
+
+
 template <typename ProjectionType>
 MessageQueue::const_iterator calculate_delta_synapse_projection_data(
     ProjectionType &projection, std::vector<core::messaging::SpikeMessage> &messages, MessageQueue &future_messages,
-    size_t step_n,
+    size_t step_n, core::DenseSynapticInput *dense_input = nullptr,
     std::function<knp::synapse_traits::synapse_parameters<knp::synapse_traits::DeltaSynapse>(
         const typename ProjectionType::SynapseParameters &)>
         sp_getter = [](const typename ProjectionType::SynapseParameters &synapse_params) { return synapse_params; })
@@ -84,41 +162,117 @@ MessageQueue::const_iterator calculate_delta_synapse_projection_data(
     SPDLOG_TRACE("Calculating delta synapse projection data...");
     using SynapseType = typename ProjectionType::ProjectionSynapseType;
     WeightUpdateSTDP<SynapseType>::init_projection(projection, messages, step_n);
+    // Synapses with plasticity are modified, so a procedural projection must store them.
+    if constexpr (!std::is_same_v<SynapseType, synapse_traits::DeltaSynapse>) projection.materialize();
+
+    auto add_impact = [&projection, &future_messages, step_n, dense_input](
+                          size_t synapse_index, const auto &synapse_params, uint32_t source_neuron,
+                          uint32_t target_neuron)
+    {
+        // The message is sent on step N - 1, received on step N.
+        size_t future_step = synapse_params.delay_ + step_n - 1;
+        if (dense_input && core::DenseSynapticInput::is_accumulated(synapse_params.output_type_))
+        {
+            // The population processes the impact on the step when the message would be received.
+            dense_input->add_impact(
+                future_step + 1, synapse_params.output_type_, target_neuron, synapse_params.weight_);
+            return;
+        }
+        knp::core::messaging::SynapticImpact impact{
+            synapse_index, synapse_params.weight_, synapse_params.output_type_, source_neuron, target_neuron};
+
+        auto iter = future_messages.find(future_step);
+        if (iter != future_messages.end())
+        {
+            iter->second.impacts_.push_back(impact);
+        }
+        else
+        {
+            knp::core::messaging::SynapticImpactMessage message_out{
+                {projection.get_uid(), step_n},
+                projection.get_postsynaptic(),
+                projection.get_presynaptic(),
+                is_forcing<ProjectionType>(),
+                {impact}};
+            future_messages.insert(std::make_pair(future_step, message_out));
+        }
+    };
+
+    // Synapses without plasticity are read from columns to avoid rebuilding synapse tuples.
+    const bool use_columns = std::is_same_v<SynapseType, synapse_traits::DeltaSynapse> &&
+                             core::SynapseStorage::structure_of_arrays == projection.get_storage();
+    // Synapses without plasticity of a procedural projection are regenerated instead of being materialized.
+    const bool use_generator = std::is_same_v<SynapseType, synapse_traits::DeltaSynapse> && projection.is_procedural();
+    // Synapses without plasticity of a mapped projection are read from the mapped file.
+    const core::MappedSynapseFile *mapped_file =
+        std::is_same_v<SynapseType, synapse_traits::DeltaSynapse> ? projection.get_mapped_file() : nullptr;
+    // Quantized weights are converted to 32-bit floats when impacts are created.
+    const core::QuantizedSynapses *quantized = projection.get_quantized_synapses();
+    std::vector<typename ProjectionType::Synapse> generated_synapses;
 
     for (const auto &message : messages)
     {
         const auto &message_data = message.neuron_indexes_;
         for (const auto &spiked_neuron_index : message_data)
         {
-            auto synapses = projection.find_synapses(spiked_neuron_index, ProjectionType::Search::by_presynaptic);
-            for (auto synapse_index : synapses)
+            if (use_generator)
             {
-                auto &synapse = projection[synapse_index];
-                WeightUpdateSTDP<SynapseType>::init_synapse(std::get<core::synapse_data>(synapse), step_n);
-                const auto &synapse_params = sp_getter(std::get<core::synapse_data>(synapse));
+                for_each_procedural_synapse(
+                    std::as_const(projection), spiked_neuron_index, generated_synapses,
+                    [&add_impact, &sp_getter](
+                        size_t synapse_index, const auto &synapse_params, uint32_t source_neuron,
+                        uint32_t target_neuron)
+                    { add_impact(synapse_index, sp_getter(synapse_params), source_neuron, target_neuron); });
+                continue;
+            }
 
-                // The message is sent on step N - 1, received on step N.
-                size_t future_step = synapse_params.delay_ + step_n - 1;
-                knp::core::messaging::SynapticImpact impact{
-                    synapse_index, synapse_params.weight_, synapse_params.output_type_,
-                    static_cast<uint32_t>(std::get<core::source_neuron_id>(synapse)),
-                    static_cast<uint32_t>(std::get<core::target_neuron_id>(synapse))};
+            if (mapped_file)
+            {
+                const auto *parameters = mapped_file->get_parameters<typename ProjectionType::SynapseParameters>();
+                for (auto synapse_index : mapped_file->find_presynaptic(spiked_neuron_index))
+                {
+                    add_impact(
+                        synapse_index, sp_getter(parameters[synapse_index]),
+                        mapped_file->get_source_neurons()[synapse_index],
+                        mapped_file->get_target_neurons()[synapse_index]);
+                }
+                continue;
+            }
 
-                auto iter = future_messages.find(future_step);
-                if (iter != future_messages.end())
+            if constexpr (std::is_same_v<SynapseType, synapse_traits::DeltaSynapse>)
+            {
+                if (quantized)
                 {
-                    iter->second.impacts_.push_back(impact);
+                    for (auto synapse_index : projection.get_presynaptic_synapses(spiked_neuron_index))
+                    {
+                        add_impact(
+                            synapse_index, sp_getter(quantized->get_parameters(synapse_index)),
+                            quantized->source_neurons_[synapse_index], quantized->target_neurons_[synapse_index]);
+                    }
+                    continue;
                 }
-                else
+            }
+
+            if (use_columns)
+            {
+                const auto &columns = std::as_const(projection).get_synapse_columns();
+                for (auto synapse_index : projection.get_presynaptic_synapses(spiked_neuron_index))
                 {
-                    knp::core::messaging::SynapticImpactMessage message_out{
-                        {projection.get_uid(), step_n},
-                        projection.get_postsynaptic(),
-                        projection.get_presynaptic(),
-                        is_forcing<ProjectionType>(),
-                        {impact}};
-                    future_messages.insert(std::make_pair(future_step, message_out));
+                    add_impact(
+                        synapse_index, sp_getter(columns.parameters_[synapse_index]),
+                        columns.source_neurons_[synapse_index], columns.target_neurons_[synapse_index]);
                 }
+                continue;
+            }
+
+            for (auto synapse_index : projection.get_presynaptic_synapses(spiked_neuron_index))
+            {
+                auto &synapse = projection[synapse_index];
+                WeightUpdateSTDP<SynapseType>::init_synapse(std::get<core::synapse_data>(synapse), step_n);
+                add_impact(
+                    synapse_index, sp_getter(std::get<core::synapse_data>(synapse)),
+                    static_cast<uint32_t>(std::get<core::source_neuron_id>(synapse)),
+                    static_cast<uint32_t>(std::get<core::target_neuron_id>(synapse)));
             }
         }
     }
@@ -130,34 +284,92 @@ MessageQueue::const_iterator calculate_delta_synapse_projection_data(
 template <class DeltaLikeSynapse>
 void calculate_projection_part_impl(
     knp::core::Projection<DeltaLikeSynapse> &projection, const std::unordered_map<size_t, size_t> &message_in_data,
-    MessageQueue &future_messages, uint64_t step_n, size_t part_start, size_t part_size, std::mutex &mutex)
+    MessageQueue &future_messages, uint64_t step_n, size_t part_start, size_t part_size, std::mutex &mutex,
+    core::DenseSynapticInput *dense_input)
 {
     size_t part_end = std::min(part_start + part_size, projection.size());
     std::vector<std::pair<uint64_t, knp::core::messaging::SynapticImpact>> container;
-    for (size_t synapse_index = part_start; synapse_index < part_end; ++synapse_index)
+    auto add_impact = [&container, &message_in_data, step_n](
+                          size_t synapse_index, const auto &synapse_params, uint32_t source_neuron,
+                          uint32_t target_neuron)
     {
-        auto &synapse = projection[synapse_index];
-        // update_step(synapse.params_, step_n);
-        // TODO: Move update logic here too.
-        auto iter = message_in_data.find(std::get<core::source_neuron_id>(synapse));
+        auto iter = message_in_data.find(source_neuron);
         if (iter == message_in_data.end())
         {
-            continue;
+            return;
         }
 
         // Add new impact.
         // The message is sent on step N - 1, received on step N.
-        uint64_t key = std::get<core::synapse_data>(synapse).delay_ + step_n - 1;
+        uint64_t key = synapse_params.delay_ + step_n - 1;
 
         knp::core::messaging::SynapticImpact impact{
-            synapse_index, std::get<core::synapse_data>(synapse).weight_ * iter->second,
-            std::get<core::synapse_data>(synapse).output_type_,
-            static_cast<uint32_t>(std::get<core::source_neuron_id>(synapse)),
-            static_cast<uint32_t>(std::get<core::target_neuron_id>(synapse))};
+            synapse_index, synapse_params.weight_ * iter->second, synapse_params.output_type_, source_neuron,
+            target_neuron};
 
         container.emplace_back(key, impact);
+    };
+
+    if (projection.is_procedural())
+    {
+        // Parts of a procedural projection are ranges of presynaptic neurons, so each row is generated once.
+        std::vector<typename core::Projection<DeltaLikeSynapse>::Synapse> synapses;
+        const size_t neurons_end = std::min(part_start + part_size, projection.get_procedural_presynaptic_size());
+        for (size_t neuron_index = part_start; neuron_index < neurons_end; ++neuron_index)
+        {
+            if (message_in_data.find(neuron_index) == message_in_data.end())
+            {
+                continue;
+            }
+            for_each_procedural_synapse(std::as_const(projection), neuron_index, synapses, add_impact);
+        }
     }
-    // Add impacts to future messages queue, it is a shared resource.
+    else if (const core::MappedSynapseFile *mapped_file = projection.get_mapped_file())
+    {
+        const auto *parameters =
+            mapped_file->get_parameters<typename core::Projection<DeltaLikeSynapse>::SynapseParameters>();
+        for (size_t synapse_index = part_start; synapse_index < part_end; ++synapse_index)
+        {
+            add_impact(
+                synapse_index, parameters[synapse_index], mapped_file->get_source_neurons()[synapse_index],
+                mapped_file->get_target_neurons()[synapse_index]);
+        }
+    }
+    else if (const core::QuantizedSynapses *quantized = projection.get_quantized_synapses())
+    {
+        for (size_t synapse_index = part_start; synapse_index < part_end; ++synapse_index)
+        {
+            add_impact(
+                synapse_index, quantized->get_parameters(synapse_index), quantized->source_neurons_[synapse_index],
+                quantized->target_neurons_[synapse_index]);
+        }
+    }
+    else if (core::SynapseStorage::structure_of_arrays == projection.get_storage())
+    {
+        // Columns are expected to be up to date, as parts of the projection can be processed in parallel.
+        const auto &columns = std::as_const(projection).get_synapse_columns();
+        for (size_t synapse_index = part_start; synapse_index < part_end; ++synapse_index)
+        {
+            add_impact(
+                synapse_index, columns.parameters_[synapse_index], columns.source_neurons_[synapse_index],
+                columns.target_neurons_[synapse_index]);
+        }
+    }
+    else
+    {
+        for (size_t synapse_index = part_start; synapse_index < part_end; ++synapse_index)
+        {
+            const auto &synapse = std::as_const(projection)[synapse_index];
+            // update_step(synapse.params_, step_n);
+            // TODO: Move update logic here too.
+            add_impact(
+                synapse_index, std::get<core::synapse_data>(synapse),
+                static_cast<uint32_t>(std::get<core::source_neuron_id>(synapse)),
+                static_cast<uint32_t>(std::get<core::target_neuron_id>(synapse)));
+        }
+    }
+
+    // Add impacts to future messages queue and dense inputs, they are shared resources.
     const std::lock_guard lock_guard(mutex);
     const auto &projection_uid = projection.get_uid();
     const auto &presynaptic_uid = projection.get_presynaptic();
@@ -165,6 +377,13 @@ void calculate_projection_part_impl(
 
     for (auto value : container)
     {
+        if (dense_input && core::DenseSynapticInput::is_accumulated(value.second.synapse_type_))
+        {
+            dense_input->add_impact(
+                value.first + 1, value.second.synapse_type_, value.second.postsynaptic_neuron_index_,
+                value.second.impact_value_);
+            continue;
+        }
         auto iter = future_messages.find(value.first);
         if (iter != future_messages.end())
         {
@@ -211,12 +430,12 @@ inline std::unordered_map<uint64_t, size_t> convert_spikes(const core::messaging
 template <class DeltaLikeSynapseType>
 void calculate_delta_synapse_projection_impl(
     knp::core::Projection<DeltaLikeSynapseType> &projection, knp::core::MessageEndpoint &endpoint,
-    MessageQueue &future_messages, size_t step_n)
+    MessageQueue &future_messages, size_t step_n, core::DenseSynapticInput *dense_input)
 {
     SPDLOG_DEBUG("Calculating delta synapse projection...");
 
     auto messages = endpoint.unload_messages<core::messaging::SpikeMessage>(projection.get_uid());
-    auto out_iter = calculate_delta_synapse_projection_data(projection, messages, future_messages, step_n);
+    auto out_iter = calculate_delta_synapse_projection_data(projection, messages, future_messages, step_n, dense_input);
     if (out_iter != future_messages.end())
     {
         SPDLOG_TRACE("Projection is sending an impact message.");
@@ -0,0 +1,168 @@
+/**
+ * @file synaptic_impact_bucketing_impl.h
+ * @brief Grouping of synaptic impacts by postsynaptic neurons.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/messaging/messaging.h>
+
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * @brief Namespace for CPU backends.
+ */
+namespace knp::backends::cpu
+{
+
+/**
+ * @brief Synaptic impact on a postsynaptic neuron.
+ */
+struct TargetedImpact
+{
+    /**
+     * @brief Index of the postsynaptic neuron.
+     */
+    uint32_t postsynaptic_neuron_index_;
+
+    /**
+     * @brief Value of the impact.
+     */
+    float impact_value_;
+
+    /**
+     * @brief Synapse type of the impact.
+     */
+    knp::synapse_traits::OutputType synapse_type_;
+
+    /**
+     * @brief `true` if the impact message is forcing.
+     */
+    bool is_forcing_;
+};
+
+
+/**
+ * @brief Make a targeted impact from an impact of a message.
+ * @param impact synaptic impact.
+ * @param is_forcing `true` if the impact message is forcing.
+ * @return targeted impact.
+ */
+inline TargetedImpact make_targeted_impact(const core::messaging::SynapticImpact &impact, bool is_forcing)
+{
+    return TargetedImpact{impact.postsynaptic_neuron_index_, impact.impact_value_, impact.synapse_type_, is_forcing};
+}
+
+
+/**
+ * @brief Call a function for each impact of messages in the order of messages.
+ * @tparam Function type of function that accepts `TargetedImpact`.
+ * @param messages synaptic impact messages sent to a population.
+ * @param function function to call.
+ */
+template <class Function>
+void for_each_impact_in_message_order(
+    const std::vector<core::messaging::SynapticImpactMessage> &messages, Function &&function)
+{
+    for (const auto &message : messages)
+    {
+        for (const auto &impact : message.impacts_) function(make_targeted_impact(impact, message.is_forcing_));
+    }
+}
+
+
+/**
+ * @brief Synaptic impacts on a population, partitioned by ranges of postsynaptic neurons.
+ * @details Ranges of the same size are processed in parallel, each by a task that gets only impacts on its neurons.
+ */
+class PartitionedImpacts
+{
+public:
+    /**
+     * @brief Partition impacts of messages by ranges of postsynaptic neurons.
+     * @details Impacts are stably partitioned, so impacts on the same neuron keep the order of messages, and results
+     * are exactly the same as if impacts were applied message by message.
+     * @param messages synaptic impact messages sent to a population.
+     * @param neurons_count number of population neurons.
+     * @param part_size number of neurons in a range.
+     */
+    void partition(
+        const std::vector<core::messaging::SynapticImpactMessage> &messages, size_t neurons_count, size_t part_size)
+    {
+        part_size_ = part_size;
+        // Counting partition: the first pass counts impacts in each part, the second one places them.
+        part_offsets_.assign((neurons_count + part_size - 1) / part_size + 1, 0);
+        for (const auto &message : messages)
+        {
+            for (const auto &impact : message.impacts_)
+            {
+                ++part_offsets_[impact.postsynaptic_neuron_index_ / part_size + 1];
+            }
+        }
+        for (size_t part = 1; part < part_offsets_.size(); ++part) part_offsets_[part] += part_offsets_[part - 1];
+
+        impacts_.resize(part_offsets_.back());
+        std::vector<size_t> positions(part_offsets_.begin(), part_offsets_.end() - 1);
+        for (const auto &message : messages)
+        {
+            for (const auto &impact : message.impacts_)
+            {
+                impacts_[positions[impact.postsynaptic_neuron_index_ / part_size]++] =
+                    make_targeted_impact(impact, message.is_forcing_);
+            }
+        }
+    }
+
+    /**
+     * @brief Count number of neuron ranges.
+     * @return number of ranges.
+     */
+    [[nodiscard]] size_t parts_count() const { return part_offsets_.empty() ? 0 : part_offsets_.size() - 1; }
+
+    /**
+     * @brief Get number of neurons in a range.
+     * @return number of neurons in a range.
+     */
+    [[nodiscard]] size_t part_size() const { return part_size_; }
+
+    /**
+     * @brief Call a function for each impact on neurons of a range.
+     * @tparam Function type of function that accepts `TargetedImpact`.
+     * @param part_index index of the neuron range.
+     * @param function function to call.
+     */
+    template <class Function>
+    void for_each_impact(size_t part_index, Function &&function) const
+    {
+        for (size_t index = part_offsets_[part_index]; index < part_offsets_[part_index + 1]; ++index)
+        {
+            function(impacts_[index]);
+        }
+    }
+
+private:
+    std::vector<TargetedImpact> impacts_;
+    // Impacts on neurons of range `i` are stored in `impacts_` from `part_offsets_[i]` to `part_offsets_[i + 1]`.
+    std::vector<size_t> part_offsets_;
+    size_t part_size_ = 1;
+};
+
+}  // namespace knp::backends::cpu
@@ -88,20 +88,16 @@ using STDPSynapseParams = knp::synapse_traits::synapse_parameters<
 
 
 /**
- * @brief Recalculate synapse weights from synaptic resource.
+ * @brief Recalculate synapse weight from synaptic resource.
  * @tparam WeightedSynapse synapse that has `weight_` parameter.
- * @param synapse_params synapse parameters.
+ * @param synapse synapse parameters.
  */
 template <class WeightedSynapse>
-void recalculate_synapse_weights(std::vector<STDPSynapseParams<WeightedSynapse> *> &synapse_params)
+void recalculate_synapse_weight(STDPSynapseParams<WeightedSynapse> &synapse)
 {
-    // Synapse weight recalculation.
-    for (auto synapse_ptr : synapse_params)
-    {
-        const auto syn_w = std::max(synapse_ptr->rule_.synaptic_resource_, 0.F);
-        const auto weight_diff = synapse_ptr->rule_.w_max_ - synapse_ptr->rule_.w_min_;
-        synapse_ptr->weight_ = synapse_ptr->rule_.w_min_ + weight_diff * syn_w / (weight_diff + syn_w);
-    }
+    const auto syn_w = std::max(synapse.rule_.synaptic_resource_, 0.F);
+    const auto weight_diff = synapse.rule_.w_max_ - synapse.rule_.w_min_;
+    synapse.weight_ = synapse.rule_.w_min_ + weight_diff * syn_w / (weight_diff + syn_w);
 }
 
 
@@ -119,17 +115,47 @@ inline bool is_point_in_interval(uint64_t interval_begin, uint64_t interval_end,
 }
 
 
+/**
+ * @brief Call a function for each synapse that leads to a neuron.
+ * @details Synapses are found with the postsynaptic index of each projection, so the function doesn't allocate memory.
+ * @tparam SynapseType synapse type.
+ * @tparam Function type of the function.
+ * @param projections_to_neuron projections that lead to the neuron population.
+ * @param neuron_index postsynaptic neuron index.
+ * @param function function that receives modifiable synapse parameters.
+ */
+template <class SynapseType, class Function>
+void for_each_connected_synapse(
+    const std::vector<core::Projection<SynapseType> *> &projections_to_neuron, size_t neuron_index,
+    Function &&function)
+{
+    for (auto *projection : projections_to_neuron)
+    {
+        // Synapses are materialized before the lookup, as materialization invalidates index ranges.
+        projection->materialize();
+        for (const auto synapse_index : projection->get_postsynaptic_synapses(neuron_index))
+        {
+            function(std::get<core::synapse_data>((*projection)[synapse_index]));
+        }
+    }
+}
+
+
+/**
+ * @brief Count synapses that lead to a neuron.
+ * @tparam SynapseType synapse type.
+ * @param projections_to_neuron projections that lead to the neuron population.
+ * @param neuron_index postsynaptic neuron index.
+ * @return number of synapses.
+ */
 template <class SynapseType>
-std::vector<synapse_traits::synapse_parameters<SynapseType> *> get_all_connected_synapses(
+size_t count_connected_synapses(
     const std::vector<core::Projection<SynapseType> *> &projections_to_neuron, size_t neuron_index)
 {
-    std::vector<synapse_traits::synapse_parameters<SynapseType> *> result;
-    for (auto *projection : projections_to_neuron)
+    size_t result = 0;
+    for (const auto *projection : projections_to_neuron)
     {
-        auto synapses = projection->find_synapses(neuron_index, core::Projection<SynapseType>::Search::by_postsynaptic);
-        std::transform(
-            synapses.begin(), synapses.end(), std::back_inserter(result),
-            [&projection](auto const &index) { return &std::get<core::synapse_data>((*projection)[index]); });
+        result += projection->get_postsynaptic_synapses(neuron_index).size();
     }
     return result;
 }
@@ -204,7 +230,6 @@ void process_spiking_neurons(
     // Loop over neurons.
     for (const auto &spiked_neuron_index : msg.neuron_indexes_)
     {
-        auto synapse_params = get_all_connected_synapses<SynapseType>(working_projections, spiked_neuron_index);
         auto &neuron = population[spiked_neuron_index];
         // Calculate neuron ISI status.
         update_isi<neuron_traits::BLIFATNeuron>(neuron, step);
@@ -213,40 +238,41 @@ void process_spiking_neurons(
             neuron.stability_ -= neuron.stability_change_at_isi_;
         }
 
-        // This is a new spiking sequence, we can update synapses now.
-        if (neuron.isi_status_ != neuron_traits::ISIPeriodType::period_continued)
-        {
-            for (auto *synapse : synapse_params)
+        // Each synapse update depends only on the synapse and the neuron, so all updates are done in a single pass.
+        for_each_connected_synapse<SynapseType>(
+            working_projections, spiked_neuron_index,
+            [&neuron, step](auto &synapse)
             {
-                synapse->rule_.had_hebbian_update_ = false;
-            }
-        }
+                // This is a new spiking sequence, we can update synapses now.
+                if (neuron.isi_status_ != neuron_traits::ISIPeriodType::period_continued)
+                {
+                    synapse.rule_.had_hebbian_update_ = false;
+                }
 
-        // Update synapse-only data.
-        if (neuron.isi_status_ != neuron_traits::ISIPeriodType::is_forced)
-        {
-            for (auto *synapse : synapse_params)
-            {
-                // Unconditional decreasing synaptic resource.
-                // TODO: NOT HERE. This shouldn't matter now as d_u_ is zero for our task, but the logic is wrong.
-                synapse->rule_.synaptic_resource_ -= synapse->rule_.d_u_;
-                neuron.free_synaptic_resource_ += synapse->rule_.d_u_;
-                // Hebbian plasticity.
-                // 1. Check if synapse ever got a spike in the current ISI period.
-
-                if (is_point_in_interval(
-                        neuron.first_isi_spike_ - neuron.isi_max_, step, synapse->rule_.last_spike_step_) &&
-                    !synapse->rule_.had_hebbian_update_)
+                // Update synapse-only data.
+                if (neuron.isi_status_ != neuron_traits::ISIPeriodType::is_forced)
                 {
-                    // 2. If it did, then update synaptic resource value.
-                    const float d_h = neuron.d_h_ * std::min(static_cast<float>(std::pow(2, -neuron.stability_)), 1.F);
-                    synapse->rule_.synaptic_resource_ += d_h;
-                    neuron.free_synaptic_resource_ -= d_h;
+                    // Unconditional decreasing synaptic resource.
+                    // TODO: NOT HERE. This shouldn't matter now as d_u_ is zero for our task, but the logic is wrong.
+                    synapse.rule_.synaptic_resource_ -= synapse.rule_.d_u_;
+                    neuron.free_synaptic_resource_ += synapse.rule_.d_u_;
+                    // Hebbian plasticity.
+                    // 1. Check if synapse ever got a spike in the current ISI period.
+
+                    if (is_point_in_interval(
+                            neuron.first_isi_spike_ - neuron.isi_max_, step, synapse.rule_.last_spike_step_) &&
+                        !synapse.rule_.had_hebbian_update_)
+                    {
+                        // 2. If it did, then update synaptic resource value.
+                        const float d_h =
+                            neuron.d_h_ * std::min(static_cast<float>(std::pow(2, -neuron.stability_)), 1.F);
+                        synapse.rule_.synaptic_resource_ += d_h;
+                        neuron.free_synaptic_resource_ -= d_h;
+                    }
                 }
-            }
-        }
-        // Recalculating synapse weights. Sometimes it probably doesn't need to happen, check it later.
-        recalculate_synapse_weights<knp::synapse_traits::DeltaSynapse>(synapse_params);
+                // Recalculating synapse weights. Sometimes it probably doesn't need to happen, check it later.
+                recalculate_synapse_weight<knp::synapse_traits::DeltaSynapse>(synapse);
+            });
     }
 }
 
@@ -280,19 +306,21 @@ void renormalize_resource(
             continue;
         }
 
-        auto synapse_params = get_all_connected_synapses<SynapseType>(working_projections, neuron_index);
-
         // Divide free resource between all synapses.
         auto add_resource_value =
-            neuron.free_synaptic_resource_ / (synapse_params.size() + neuron.resource_drain_coefficient_);
+            neuron.free_synaptic_resource_ /
+            (count_connected_synapses<SynapseType>(working_projections, neuron_index) +
+             neuron.resource_drain_coefficient_);
 
-        for (auto *synapse : synapse_params)
-        {
-            synapse->rule_.synaptic_resource_ += add_resource_value;
-        }
+        for_each_connected_synapse<SynapseType>(
+            working_projections, neuron_index,
+            [add_resource_value](auto &synapse)
+            {
+                synapse.rule_.synaptic_resource_ += add_resource_value;
+                recalculate_synapse_weight<knp::synapse_traits::DeltaSynapse>(synapse);
+            });
 
         neuron.free_synaptic_resource_ = 0.0F;
-        recalculate_synapse_weights(synapse_params);
     }
 }
 
@@ -304,7 +332,6 @@ void do_dopamine_plasticity(
 {
     using SynapseType =
         knp::synapse_traits::STDP<knp::synapse_traits::STDPSynapticResourceRule, synapse_traits::DeltaSynapse>;
-    using SynapseParamType = knp::synapse_traits::synapse_parameters<SynapseType>;
     for (size_t neuron_index = 0; neuron_index < population.size(); ++neuron_index)
     {
         auto &neuron = population[neuron_index];
@@ -312,20 +339,22 @@ void do_dopamine_plasticity(
         if (neuron.dopamine_value_ > 0.0 ||
             (neuron.dopamine_value_ < 0.0 && neuron.isi_status_ != neuron_traits::ISIPeriodType::is_forced))
         {
-            std::vector<SynapseParamType *> synapse_params =
-                get_all_connected_synapses<SynapseType>(working_projections, neuron_index);
-            // Change synapse values for both `D > 0` and `D < 0`.
-            for (auto *synapse : synapse_params)
-            {
-                if (step - synapse->rule_.last_spike_step_ < synapse->rule_.dopamine_plasticity_period_)
+            // Change synapse values for both `D > 0` and `D < 0`. Weights depend only on synapse resources, so they
+            // are recalculated in the same pass.
+            for_each_connected_synapse<SynapseType>(
+                working_projections, neuron_index,
+                [&neuron, step](auto &synapse)
                 {
-                    // Change synapse resource.
-                    float d_r =
-                        neuron.dopamine_value_ * std::min(static_cast<float>(std::pow(2, -neuron.stability_)), 1.F);
-                    synapse->rule_.synaptic_resource_ += d_r;
-                    neuron.free_synaptic_resource_ -= d_r;
-                }
-            }
+                    if (step - synapse.rule_.last_spike_step_ < synapse.rule_.dopamine_plasticity_period_)
+                    {
+                        // Change synapse resource.
+                        float d_r = neuron.dopamine_value_ *
+                                    std::min(static_cast<float>(std::pow(2, -neuron.stability_)), 1.F);
+                        synapse.rule_.synaptic_resource_ += d_r;
+                        neuron.free_synaptic_resource_ -= d_r;
+                    }
+                    recalculate_synapse_weight<knp::synapse_traits::DeltaSynapse>(synapse);
+                });
             // Stability changes.
             if (neuron.is_being_forced_ || neuron.dopamine_value_ < 0)
             {
@@ -341,7 +370,6 @@ void do_dopamine_plasticity(
                 neuron.stability_ += neuron.stability_change_parameter_ * neuron.dopamine_value_ *
                                      std::max(dopamine_constant - abs(difference) / neuron.isi_max_, -1.0);
             }
-            recalculate_synapse_weights(synapse_params);
         }
     }
 }
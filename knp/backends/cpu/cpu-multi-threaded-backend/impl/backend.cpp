@@ -19,11 +19,13 @@
  * limitations under the License.
  */
 
+#include <knp/backends/cpu-library/altai_lif_population.h>
 #include <knp/backends/cpu-library/blifat_population.h>
 #include <knp/backends/cpu-library/delta_synapse_projection.h>
 #include <knp/backends/cpu-library/init.h>
 #include <knp/backends/cpu-multi-threaded/backend.h>
-#include <knp/backends/thread_pool/thread_pool.h>
+#include <knp/backends/thread_pool/numa_topology.h>
+#include <knp/backends/thread_pool/work_stealing_pool.h>
 #include <knp/devices/cpu.h>
 #include <knp/meta/assert_helpers.h>
 #include <knp/meta/stringify.h>
@@ -31,7 +33,11 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <functional>
+#include <limits>
 #include <optional>
 #include <vector>
 
@@ -41,15 +47,15 @@
 namespace knp::backends::multi_threaded_cpu
 {
 MultiThreadedCPUBackend::MultiThreadedCPUBackend(
-    size_t thread_count, size_t population_part_size, size_t projection_part_size)
+    size_t thread_count, size_t population_part_size, size_t projection_part_size, bool is_numa_aware)
     : population_part_size_(population_part_size),
       projection_part_size_(projection_part_size),
-      calc_pool_(std::make_unique<cpu_executors::ThreadPool>(
-          thread_count ? thread_count : std::thread::hardware_concurrency()))
+      thread_count_(thread_count ? thread_count : std::thread::hardware_concurrency()),
+      calc_pool_(std::make_unique<cpu_executors::WorkStealingPool>(thread_count_, is_numa_aware))
 {
     SPDLOG_INFO(
-        "Multi-threaded CPU backend instance created, thread count = {}.",
-        thread_count ? thread_count : std::thread::hardware_concurrency());
+        "Multi-threaded CPU backend instance created, thread count = {}, NUMA node count = {}.", thread_count_,
+        calc_pool_->nodes_count());
 }
 
 
@@ -74,15 +80,142 @@ std::vector<std::string> MultiThreadedCPUBackend::get_supported_synapses() const
 }
 
 
+namespace
+{
+// Spikes and single-precision divergence of a population part.
+struct PartOutput
+{
+    knp::core::messaging::SpikeData neuron_indexes_;
+    core::PrecisionDivergence divergence_;
+};
+
+
+// Number of items that are divided into projection parts. Procedural projections are split by presynaptic neurons.
+template <class ProjectionType>
+size_t get_projection_items_count(const ProjectionType &projection)
+{
+    return projection.is_procedural() ? projection.get_procedural_presynaptic_size() : projection.size();
+}
+
+
+// Task that adds its calculation time to the measurement of its entity, if part sizes are tuned.
+template <class Func>
+auto measure_part(PartSizeTuner::Measurement *measurement, size_t items_count, Func func)
+{
+    return [measurement, items_count, func = std::move(func)]() mutable
+    {
+        if (!measurement)
+        {
+            func();
+            return;
+        }
+        const auto start_time = std::chrono::steady_clock::now();
+        func();
+        measurement->add(std::chrono::steady_clock::now() - start_time, items_count);
+    };
+}
+
+
+// Take CPUs from the end of the nodes, so that pools created for the nodes and for the taken CPUs don't share CPUs.
+// At least one CPU is left in the nodes, and if there is only one CPU, the pools share it.
+std::vector<cpu_executors::NumaNode> take_last_cpus(std::vector<cpu_executors::NumaNode> &nodes, size_t count)
+{
+    size_t cpus_count = 0;
+    for (const auto &node : nodes) cpus_count += node.cpus_.size();
+    if (cpus_count <= 1) return nodes;
+    count = std::min(count, cpus_count - 1);
+
+    std::vector<cpu_executors::NumaNode> taken_nodes;
+    for (auto node = nodes.rbegin(); count && node != nodes.rend(); ++node)
+    {
+        const size_t taken_count = std::min(count, node->cpus_.size());
+        const auto taken_start = node->cpus_.end() - static_cast<std::ptrdiff_t>(taken_count);
+        taken_nodes.insert(
+            taken_nodes.begin(), cpu_executors::NumaNode{node->id_, std::vector<int>(taken_start, node->cpus_.end())});
+        node->cpus_.erase(taken_start, node->cpus_.end());
+        count -= taken_count;
+    }
+    return taken_nodes;
+}
+
+
+// Minimal synapse delay of a projection, synapses are read in the same way as they are read by projection parts.
+template <class ProjectionType>
+size_t get_projection_min_delay(const ProjectionType &projection)
+{
+    size_t min_delay = std::numeric_limits<size_t>::max();
+    auto update_delay = [&min_delay](size_t, const auto &synapse_params, uint32_t, uint32_t)
+    { min_delay = std::min<size_t>(min_delay, synapse_params.delay_); };
+
+    if (projection.is_procedural())
+    {
+        std::vector<typename ProjectionType::Synapse> synapses;
+        for (size_t neuron_index = 0; neuron_index < projection.get_procedural_presynaptic_size(); ++neuron_index)
+        {
+            knp::backends::cpu::for_each_procedural_synapse(projection, neuron_index, synapses, update_delay);
+        }
+    }
+    else if (const core::MappedSynapseFile *mapped_file = projection.get_mapped_file())
+    {
+        const auto *parameters = mapped_file->get_parameters<typename ProjectionType::SynapseParameters>();
+        for (size_t synapse_index = 0; synapse_index < mapped_file->size(); ++synapse_index)
+        {
+            update_delay(synapse_index, parameters[synapse_index], 0, 0);
+        }
+    }
+    else if (const core::QuantizedSynapses *quantized = projection.get_quantized_synapses())
+    {
+        for (const auto delay : quantized->delays_) min_delay = std::min<size_t>(min_delay, delay);
+    }
+    else if (core::SynapseStorage::structure_of_arrays == projection.get_storage())
+    {
+        for (const auto &synapse_params : projection.get_synapse_columns().parameters_)
+        {
+            update_delay(0, synapse_params, 0, 0);
+        }
+    }
+    else
+    {
+        for (const auto &synapse : projection) update_delay(0, std::get<core::synapse_data>(synapse), 0, 0);
+    }
+    return min_delay;
+}
+
+
+// Neuron features, columns, and active sets are built lazily by non-constant methods, so they must be updated before
+// parts are processed in parallel.
+template <class PopulationVariant>
+void prepare_population(PopulationVariant &population)
+{
+    std::visit(
+        [](auto &pop)
+        {
+            (void)pop.get_features();
+            if (core::NeuronStorage::array_of_structures != pop.get_storage()) (void)pop.get_neuron_columns();
+            if (pop.is_event_driven()) (void)pop.get_active_set();
+        },
+        population);
+}
+}  // namespace
+
+
 void MultiThreadedCPUBackend::calculate_populations_pre_impact()
 {
-    for (auto &population : populations_)
+    const auto part_offsets = get_population_part_offsets();
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
     {
+        auto &population = populations_[pop_index];
+        prepare_population(population);
         auto pop_size = std::visit([](auto &pop) { return pop.size(); }, population);
-        for (size_t neuron_index = 0; neuron_index < pop_size; neuron_index += population_part_size_)
+        const auto uid = std::visit([](auto &pop) { return pop.get_uid(); }, population);
+        const size_t part_size = get_population_part_size(uid);
+        auto *measurement = part_size_tuner_.get_measurement(uid, pop_size);
+        for (size_t neuron_index = 0; neuron_index < pop_size; neuron_index += part_size)
         {
+            const size_t node = get_part_node(part_offsets[pop_index] + neuron_index / part_size, part_offsets.back());
+            const size_t neurons_count = std::min(part_size, pop_size - neuron_index);
             std::visit(
-                [this, neuron_index](auto &pop)
+                [this, neuron_index, part_size, measurement, neurons_count, node](auto &pop)
                 {
                     // Check if population is supported by backend. We don't need to repeat it.
                     using T = std::decay_t<decltype(pop)>;
@@ -93,72 +226,216 @@ void MultiThreadedCPUBackend::calculate_populations_pre_impact()
                             knp::meta::always_false_v<T>,
                             "Population is not supported by the multi-threaded CPU backend.");
                     }
-
-                    // Start threads.
-                    calc_pool_->post(
-                        knp::backends::cpu::calculate_neurons_state_part<typename T::PopulationNeuronType>,
-                        std::ref(pop), neuron_index, population_part_size_);
+                    // AltAILIF neurons are calculated after impacts only.
+                    if constexpr (!std::is_same_v<typename T::PopulationNeuronType, knp::neuron_traits::AltAILIF>)
+                    {
+                        // Start threads.
+                        calc_pool_->post_to_node_phase(
+                            node, measure_part(
+                                      measurement, neurons_count,
+                                      [&pop, neuron_index, part_size]()
+                                      {
+                                          knp::backends::cpu::calculate_neurons_state_part(
+                                              pop, neuron_index, part_size);
+                                      }));
+                    }
                 },
                 population);
         }
     }
     // Wait for all threads to finish their work.
-    calc_pool_->join();
+    calc_pool_->run_phase();
 }
 
 
 void MultiThreadedCPUBackend::calculate_populations_impact()
 {
-    for (auto &population : populations_)
+    // Inputs of populations larger than a part are partitioned by ranges of neurons, one thread per range.
+    std::vector<knp::backends::cpu::PartitionedInputs> partitioned_inputs(populations_.size());
+    const auto part_offsets = get_population_part_offsets();
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
     {
+        auto &population = populations_[pop_index];
         auto uid = std::visit([](auto &population) { return population.get_uid(); }, population);
         auto messages = get_message_endpoint().unload_messages<knp::core::messaging::SynapticImpactMessage>(uid);
         std::visit(
-            [this, &messages](auto &pop)
+            [this, &messages, &uid, &inputs = partitioned_inputs[pop_index], first_part = part_offsets[pop_index],
+             parts_count = part_offsets.back()](auto &pop)
             {
                 using T = std::decay_t<decltype(pop)>;
-                calc_pool_->post(
-                    knp::backends::cpu::process_inputs<typename T::PopulationNeuronType>, std::ref(pop),
-                    std::move(messages));
+                const size_t part_size = get_population_part_size(uid);
+                auto *measurement = part_size_tuner_.get_measurement(uid, pop.size());
+                auto get_neurons_count = [&pop, part_size](size_t part_index)
+                { return std::min(part_size, pop.size() - part_index * part_size); };
+                const bool is_partitioned = pop.size() > part_size;
+                if constexpr (std::is_same_v<typename T::PopulationNeuronType, knp::neuron_traits::AltAILIF>)
+                {
+                    if (!is_partitioned)
+                    {
+                        calc_pool_->post_to_node_phase(
+                            get_part_node(first_part, parts_count),
+                            measure_part(
+                                measurement, pop.size(),
+                                [&pop, population_messages = std::move(messages)]()
+                                { knp::backends::cpu::process_altai_lif_inputs(pop, population_messages); }));
+                        return;
+                    }
+                    inputs.impacts_.partition(messages, pop.size(), part_size);
+                    for (size_t part_index = 0; part_index < inputs.impacts_.parts_count(); ++part_index)
+                    {
+                        calc_pool_->post_to_node_phase(
+                            get_part_node(first_part + part_index, parts_count),
+                            measure_part(
+                                measurement, get_neurons_count(part_index),
+                                [&pop, &inputs, part_index]()
+                                {
+                                    knp::backends::cpu::process_altai_lif_inputs_part(
+                                        pop, inputs.impacts_, part_index);
+                                }));
+                    }
+                }
+                else
+                {
+                    // Projections calculated later on this step can add impacts to dense inputs of the population.
+                    auto &dense_input = dense_inputs_[uid];
+                    dense_input.resize(pop.size());
+                    if (!is_partitioned)
+                    {
+                        calc_pool_->post_to_node_phase(
+                            get_part_node(first_part, parts_count),
+                            measure_part(
+                                measurement, pop.size(),
+                                [&pop, population_messages = std::move(messages), &dense_input, step = get_step()]()
+                                { knp::backends::cpu::process_inputs(pop, population_messages, &dense_input, step); }));
+                        return;
+                    }
+                    knp::backends::cpu::start_partitioned_inputs(pop, messages, part_size, inputs);
+                    for (size_t part_index = 0; part_index < inputs.impacts_.parts_count(); ++part_index)
+                    {
+                        calc_pool_->post_to_node_phase(
+                            get_part_node(first_part + part_index, parts_count),
+                            measure_part(
+                                measurement, get_neurons_count(part_index),
+                                [&pop, &inputs, part_index, &dense_input, step = get_step()]()
+                                {
+                                    knp::backends::cpu::process_inputs_part(
+                                        pop, inputs, part_index, &dense_input, step);
+                                }));
+                    }
+                }
             },
             population);
     }
-    calc_pool_->join();
+    calc_pool_->run_phase();
+
+    // Features and woken neurons of all ranges are collected after the ranges are processed.
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
+    {
+        const auto &inputs = partitioned_inputs[pop_index];
+        if (!inputs.impacts_.parts_count()) continue;
+        std::visit(
+            [this, &inputs](auto &pop)
+            {
+                using T = std::decay_t<decltype(pop)>;
+                if constexpr (!std::is_same_v<typename T::PopulationNeuronType, knp::neuron_traits::AltAILIF>)
+                {
+                    knp::backends::cpu::finish_partitioned_inputs(
+                        pop, inputs, &dense_inputs_[pop.get_uid()], get_step());
+                }
+            },
+            populations_[pop_index]);
+    }
 }
 
 
 std::vector<knp::core::messaging::SpikeMessage> MultiThreadedCPUBackend::calculate_populations_post_impact()
 {
-    std::vector<knp::core::messaging::SpikeMessage> spike_container(populations_.size());
+    // Each part writes spikes to its own buffer, and buffers are concatenated in the order of parts, so messages
+    // contain sorted neuron indexes that don't depend on thread scheduling.
+    std::vector<std::vector<PartOutput>> part_outputs(populations_.size());
+    const auto part_offsets = get_population_part_offsets();
     for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
     {
         auto &population = populations_[pop_index];
-        auto &message = spike_container[pop_index];
-        message.header_.send_time_ = get_step();
-        message.header_.sender_uid_ = std::visit([](auto &population) { return population.get_uid(); }, population);
+        prepare_population(population);
 
         const size_t population_size = std::visit([](auto &population) { return population.size(); }, population);
-        for (size_t neuron_index = 0; neuron_index < population_size; neuron_index += population_part_size_)
+        const auto uid = std::visit([](auto &population) { return population.get_uid(); }, population);
+        const size_t part_size = get_population_part_size(uid);
+        auto *measurement = part_size_tuner_.get_measurement(uid, population_size);
+        auto &outputs = part_outputs[pop_index];
+        outputs.resize((population_size + part_size - 1) / part_size);
+        for (size_t part_index = 0; part_index < outputs.size(); ++part_index)
         {
+            const size_t part_start = part_index * part_size;
+            const size_t part_end = std::min(part_start + part_size, population_size);
+            const size_t node = get_part_node(part_offsets[pop_index] + part_index, part_offsets.back());
             std::visit(
-                [this, &message, neuron_index](auto &pop)
+                [this, &output = outputs[part_index], part_start, part_end, measurement, node](auto &pop)
                 {
                     using T = std::decay_t<decltype(pop)>;
-#if defined(_MSC_VER)
-#    pragma warning(push)
-#    pragma warning(disable : 4267)
-#endif
-                    calc_pool_->post(
-                        knp::backends::cpu::calculate_neurons_post_input_state_part<typename T::PopulationNeuronType>,
-                        std::ref(pop), std::ref(message), neuron_index, population_part_size_, std::ref(ep_mutex_));
+                    if constexpr (std::is_same_v<typename T::PopulationNeuronType, knp::neuron_traits::AltAILIF>)
+                    {
+                        calc_pool_->post_to_node_phase(
+                            node, measure_part(
+                                      measurement, part_end - part_start,
+                                      [&pop, &output, part_start, part_end]()
+                                      {
+                                          knp::backends::cpu::calculate_altai_lif_post_input_state_part(
+                                              pop, part_start, part_end, output.neuron_indexes_);
+                                      }));
+                    }
+                    else
+                    {
+                        calc_pool_->post_to_node_phase(
+                            node, measure_part(
+                                      measurement, part_end - part_start,
+                                      [&pop, &output, part_start, part_end]()
+                                      {
+                                          output.divergence_ =
+                                              knp::backends::cpu::calculate_neurons_post_input_state_part(
+                                                  pop, part_start, part_end, output.neuron_indexes_);
+                                      }));
+                    }
                 },
                 population);
-#if defined(_MSC_VER)
-#    pragma warning(pop)
-#endif
         }
     }
-    calc_pool_->join();
+    calc_pool_->run_phase();
+
+    std::vector<knp::core::messaging::SpikeMessage> spike_container(populations_.size());
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
+    {
+        auto &population = populations_[pop_index];
+        auto &message = spike_container[pop_index];
+        message.header_.send_time_ = get_step();
+        message.header_.sender_uid_ = std::visit([](auto &population) { return population.get_uid(); }, population);
+
+        size_t spikes_count = 0;
+        core::PrecisionDivergence divergence;
+        for (const auto &output : part_outputs[pop_index])
+        {
+            spikes_count += output.neuron_indexes_.size();
+            divergence.reference_spikes_ += output.divergence_.reference_spikes_;
+            divergence.divergent_spikes_ += output.divergence_.divergent_spikes_;
+        }
+        message.neuron_indexes_.reserve(spikes_count);
+        for (const auto &output : part_outputs[pop_index])
+        {
+            message.neuron_indexes_.insert(
+                message.neuron_indexes_.end(), output.neuron_indexes_.begin(), output.neuron_indexes_.end());
+        }
+        std::visit(
+            [&divergence](auto &pop)
+            {
+                using T = std::decay_t<decltype(pop)>;
+                if constexpr (!std::is_same_v<typename T::PopulationNeuronType, knp::neuron_traits::AltAILIF>)
+                {
+                    knp::backends::cpu::add_precision_divergence(pop, divergence);
+                }
+            },
+            population);
+    }
     return spike_container;
 }
 
@@ -199,11 +476,22 @@ void send_message(ProjectionWrapper &projection, core::MessageEndpoint &endpoint
 void MultiThreadedCPUBackend::calculate_projections()
 {
     SPDLOG_DEBUG("Calculating projections...");
-    std::vector<std::unordered_map<uint64_t, size_t>> converted_message_buffer;
-    converted_message_buffer.reserve(projections_.size());
+    start_projections(*calc_pool_, get_step(), true);
+    calc_pool_->join();
+    send_projection_messages();
+}
 
-    for (auto &projection : projections_)
+
+void MultiThreadedCPUBackend::start_projections(
+    cpu_executors::WorkStealingPool &pool, uint64_t step, bool use_dense_inputs)
+{
+    projection_spikes_.clear();
+    projection_spikes_.reserve(projections_.size());
+    const auto part_offsets = get_projection_part_offsets();
+
+    for (size_t proj_index = 0; proj_index < projections_.size(); ++proj_index)
     {
+        auto &projection = projections_[proj_index];
         auto uid = std::visit([](auto &proj) { return proj.get_uid(); }, projection.arg_);
         auto msg_buf = get_message_endpoint().unload_messages<knp::core::messaging::SpikeMessage>(uid);
         // We might want to add some preliminary function before, even if delta projection doesn't require it.
@@ -213,23 +501,58 @@ void MultiThreadedCPUBackend::calculate_projections()
         }
 
         // Looping over synapses.
-        converted_message_buffer.emplace_back(cpu::convert_spikes(msg_buf[0]));
-        const auto proj_size = std::visit([](const auto &proj) { return proj.size(); }, projection.arg_);
-        for (size_t synapse_index = 0; synapse_index < proj_size; synapse_index += projection_part_size_)
+        projection_spikes_.emplace_back(cpu::convert_spikes(msg_buf[0]));
+        // Synapse columns are rebuilt lazily, so they must be updated before parts are processed in parallel.
+        std::visit(
+            [](const auto &proj)
+            {
+                // Procedural, mapped and quantized synapses are read directly and must not be materialized here.
+                if (proj.is_procedural() || proj.is_mapped() || proj.get_quantized_synapses()) return;
+                if (core::SynapseStorage::structure_of_arrays == proj.get_storage()) (void)proj.get_synapse_columns();
+            },
+            projection.arg_);
+        // Impacts are added to dense inputs of the postsynaptic population under the same mutex as messages.
+        core::DenseSynapticInput *dense_input = nullptr;
+        if (use_dense_inputs)
+        {
+            dense_input = std::visit(
+                [this](const auto &proj)
+                { return knp::backends::cpu::find_dense_input(proj, dense_inputs_, get_message_endpoint()); },
+                projection.arg_);
+        }
+        const auto proj_size =
+            std::visit([](const auto &proj) { return get_projection_items_count(proj); }, projection.arg_);
+        const size_t part_size = get_projection_part_size(uid);
+        auto *measurement = part_size_tuner_.get_measurement(uid, proj_size);
+        for (size_t synapse_index = 0; synapse_index < proj_size; synapse_index += part_size)
         {
+            const size_t node =
+                get_part_node(part_offsets[proj_index] + synapse_index / part_size, part_offsets.back(), pool);
+            const size_t synapses_count = std::min(part_size, proj_size - synapse_index);
             std::visit(
-                [this, synapse_index, &converted_message_buffer, &projection](auto &proj)
+                [this, &pool, step, synapse_index, part_size, measurement, synapses_count,
+                 &message_data = projection_spikes_.back(), &projection, dense_input, node](auto &proj)
                 {
-                    using T = std::decay_t<decltype(proj)>;
-                    calc_pool_->post(
-                        knp::backends::cpu::calculate_projection_part<typename T::ProjectionSynapseType>,
-                        std::ref(proj), std::ref(converted_message_buffer.back()), std::ref(projection.messages_),
-                        get_step(), synapse_index, projection_part_size_, std::ref(ep_mutex_));
+                    pool.post_to_node_phase(
+                        node, measure_part(
+                                  measurement, synapses_count,
+                                  [this, &proj, &message_data, &messages = projection.messages_, step, synapse_index,
+                                   part_size, dense_input]()
+                                  {
+                                      knp::backends::cpu::calculate_projection_part(
+                                          proj, message_data, messages, step, synapse_index, part_size, ep_mutex_,
+                                          dense_input);
+                                  }));
                 },
                 projection.arg_);
         }
     }
-    calc_pool_->join();
+    pool.start_phase();
+}
+
+
+void MultiThreadedCPUBackend::send_projection_messages()
+{
     // Sending messages. It might be possible to parallelize this as well if we use more than one endpoint.
     for (auto &projection : projections_)
     {
@@ -244,6 +567,94 @@ void MultiThreadedCPUBackend::calculate_projections()
 }
 
 
+void MultiThreadedCPUBackend::set_pipelined_execution(bool is_pipelined, size_t projection_thread_count)
+{
+    finish_pipeline();
+    projection_pool_.reset();
+    const bool is_numa_aware = calc_pool_->is_numa_aware();
+    if (!is_pipelined)
+    {
+        // Threads of projections are returned to populations.
+        if (calc_pool_->size() == thread_count_) return;
+        calc_pool_.reset();
+        calc_pool_ = std::make_unique<cpu_executors::WorkStealingPool>(thread_count_, is_numa_aware);
+        place_on_numa_nodes();
+        return;
+    }
+
+    if (!projection_thread_count) projection_thread_count = std::max<size_t>(thread_count_ / 2, 1);
+    // Threads of projections are taken from backend threads, and at least one thread is left for populations.
+    projection_thread_count = std::min(projection_thread_count, std::max<size_t>(thread_count_, 2) - 1);
+    const size_t population_thread_count = std::max<size_t>(thread_count_ - projection_thread_count, 1);
+    auto population_nodes = cpu_executors::get_numa_nodes();
+    auto projection_nodes = take_last_cpus(population_nodes, projection_thread_count);
+
+    // The old pool is stopped first, so that its threads don't compete with threads of the new pools.
+    calc_pool_.reset();
+    calc_pool_ = std::make_unique<cpu_executors::WorkStealingPool>(
+        population_thread_count, is_numa_aware, std::move(population_nodes));
+    projection_pool_ = std::make_unique<cpu_executors::WorkStealingPool>(
+        projection_thread_count, is_numa_aware, std::move(projection_nodes));
+    // Parts are divided among nodes of the new population pool.
+    place_on_numa_nodes();
+    SPDLOG_INFO(
+        "Pipelined execution enabled, population thread count = {}, projection thread count = {}.",
+        population_thread_count, projection_thread_count);
+}
+
+
+size_t MultiThreadedCPUBackend::get_min_synapse_delay()
+{
+    if (!min_synapse_delay_)
+    {
+        size_t min_delay = std::numeric_limits<size_t>::max();
+        for (const auto &projection : projections_)
+        {
+            min_delay = std::min(
+                min_delay, std::visit([](const auto &proj) { return get_projection_min_delay(proj); }, projection.arg_));
+        }
+        min_synapse_delay_ = min_delay;
+    }
+    return *min_synapse_delay_;
+}
+
+
+void MultiThreadedCPUBackend::finish_pipeline()
+{
+    if (!has_pipelined_spikes_) return;
+    has_pipelined_spikes_ = false;
+    // Impacts of these projections are sent on this step or later, as all synapse delays are at least 2.
+    start_projections(*calc_pool_, get_step() - 1, false);
+    calc_pool_->join();
+}
+
+
+void MultiThreadedCPUBackend::pipelined_step()
+{
+    // Spikes received on the previous step are unloaded before populations send spikes of this step.
+    if (has_pipelined_spikes_) start_projections(*projection_pool_, get_step() - 1, false);
+    try
+    {
+        calculate_populations();
+        get_message_bus().route_messages();
+        get_message_endpoint().receive_all_messages();
+    }
+    catch (...)
+    {
+        // Projection parts use backend data, so they must be finished before the error leaves the backend.
+        has_pipelined_spikes_ = false;
+        projection_pool_->join();
+        throw;
+    }
+    projection_pool_->join();
+    has_pipelined_spikes_ = true;
+    // Impacts that populations receive on the next step are complete, as projections of this step don't add them.
+    send_projection_messages();
+    get_message_bus().route_messages();
+    get_message_endpoint().receive_all_messages();
+}
+
+
 std::vector<size_t> MultiThreadedCPUBackend::get_supported_projection_indexes() const
 {
     return knp::meta::get_supported_type_indexes<core::AllProjections, SupportedProjections>();
@@ -259,12 +670,21 @@ std::vector<size_t> MultiThreadedCPUBackend::get_supported_population_indexes()
 void MultiThreadedCPUBackend::_step()
 {
     SPDLOG_DEBUG("Starting step #{}...", get_step());
-    calculate_populations();
-    get_message_bus().route_messages();
-    get_message_endpoint().receive_all_messages();
-    calculate_projections();
-    get_message_bus().route_messages();
-    get_message_endpoint().receive_all_messages();
+    if (is_pipelined() && get_min_synapse_delay() >= 2)
+    {
+        pipelined_step();
+    }
+    else
+    {
+        calculate_populations();
+        get_message_bus().route_messages();
+        get_message_endpoint().receive_all_messages();
+        calculate_projections();
+        get_message_bus().route_messages();
+        get_message_endpoint().receive_all_messages();
+    }
+    // Data of parts are moved to their NUMA nodes again, as tuned parts are divided among nodes differently.
+    if (part_size_tuner_.finish_step(calc_pool_->size())) place_on_numa_nodes();
     auto step = gad_step();
     // Need to suppress "Unused variable" warning.
     (void)step;
@@ -277,6 +697,7 @@ void MultiThreadedCPUBackend::load_populations(const std::vector<PopulationVaria
     SPDLOG_DEBUG("Loading populations [{}]...", populations.size());
     populations_.clear();
     populations_.reserve(populations.size());
+    dense_inputs_.clear();
 
     for (const auto &population : populations)
     {
@@ -289,6 +710,8 @@ void MultiThreadedCPUBackend::load_populations(const std::vector<PopulationVaria
 void MultiThreadedCPUBackend::load_projections(const std::vector<ProjectionVariants> &projections)
 {
     SPDLOG_DEBUG("Loading projections [{}]...", projections.size());
+    finish_pipeline();
+    min_synapse_delay_.reset();
     projections_.clear();
     projections_.reserve(projections.size());
 
@@ -304,6 +727,8 @@ void MultiThreadedCPUBackend::load_projections(const std::vector<ProjectionVaria
 void MultiThreadedCPUBackend::load_all_projections(const std::vector<knp::core::AllProjectionsVariant> &projections)
 {
     SPDLOG_DEBUG("Loading projections [{}]...", projections.size());
+    finish_pipeline();
+    min_synapse_delay_.reset();
     knp::meta::load_from_container<SupportedProjections>(projections, projections_);
     SPDLOG_DEBUG("All projections loaded.");
 }
@@ -312,6 +737,7 @@ void MultiThreadedCPUBackend::load_all_projections(const std::vector<knp::core::
 void MultiThreadedCPUBackend::load_all_populations(const std::vector<knp::core::AllPopulationsVariant> &populations)
 {
     SPDLOG_DEBUG("Loading populations [{}]...", populations.size());
+    dense_inputs_.clear();
     knp::meta::load_from_container<SupportedPopulations>(populations, populations_);
     SPDLOG_DEBUG("All populations loaded.");
 }
@@ -340,13 +766,132 @@ void MultiThreadedCPUBackend::_init()
     SPDLOG_DEBUG("Initializing multi-threaded CPU backend...");
 
     knp::backends::cpu::init(projections_, get_message_endpoint());
+    place_on_numa_nodes();
 
     SPDLOG_DEBUG("Initialization finished.");
 }
 
 
+std::vector<size_t> MultiThreadedCPUBackend::get_population_part_offsets() const
+{
+    std::vector<size_t> offsets(populations_.size() + 1);
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
+    {
+        const size_t pop_size = std::visit([](const auto &pop) { return pop.size(); }, populations_[pop_index]);
+        const size_t part_size = get_population_part_size(
+            std::visit([](const auto &pop) { return pop.get_uid(); }, populations_[pop_index]));
+        offsets[pop_index + 1] = offsets[pop_index] + (pop_size + part_size - 1) / part_size;
+    }
+    return offsets;
+}
+
+
+std::vector<size_t> MultiThreadedCPUBackend::get_projection_part_offsets() const
+{
+    std::vector<size_t> offsets(projections_.size() + 1);
+    for (size_t proj_index = 0; proj_index < projections_.size(); ++proj_index)
+    {
+        const size_t proj_size = std::visit(
+            [](const auto &proj) { return get_projection_items_count(proj); }, projections_[proj_index].arg_);
+        const size_t part_size = get_projection_part_size(
+            std::visit([](const auto &proj) { return proj.get_uid(); }, projections_[proj_index].arg_));
+        offsets[proj_index + 1] = offsets[proj_index] + (proj_size + part_size - 1) / part_size;
+    }
+    return offsets;
+}
+
+
+size_t MultiThreadedCPUBackend::get_part_node(size_t part_index, size_t parts_count) const
+{
+    return get_part_node(part_index, parts_count, *calc_pool_);
+}
+
+
+size_t MultiThreadedCPUBackend::get_part_node(
+    size_t part_index, size_t parts_count, const cpu_executors::WorkStealingPool &pool)
+{
+    if (parts_count <= 1) return 0;
+    return part_index * pool.nodes_count() / parts_count;
+}
+
+
+void MultiThreadedCPUBackend::place_on_numa_nodes()
+{
+    if (calc_pool_->nodes_count() <= 1) return;
+
+    // Vectors are first touched by the thread that loads the network, so their pages are moved after loading.
+    // Column storage, and procedural, mapped and quantized synapses are not moved.
+    const auto population_offsets = get_population_part_offsets();
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
+    {
+        std::visit(
+            [this, first_part = population_offsets[pop_index], parts_count = population_offsets.back()](auto &pop)
+            {
+                if (core::NeuronStorage::array_of_structures != pop.get_storage()) return;
+                // Neuron states are not synchronized, as only their memory is moved.
+                const auto &neurons = pop.get_neuron_states();
+                const size_t part_size = get_population_part_size(pop.get_uid());
+                for (size_t part_start = 0; part_start < neurons.size(); part_start += part_size)
+                {
+                    const size_t neurons_count = std::min(part_size, neurons.size() - part_start);
+                    const size_t node = get_part_node(first_part + part_start / part_size, parts_count);
+                    cpu_executors::move_to_numa_node(
+                        neurons.data() + part_start, neurons_count * sizeof(neurons[0]), calc_pool_->get_node_id(node));
+                }
+            },
+            populations_[pop_index]);
+    }
+
+    const auto projection_offsets = get_projection_part_offsets();
+    for (size_t proj_index = 0; proj_index < projections_.size(); ++proj_index)
+    {
+        std::visit(
+            [this, first_part = projection_offsets[proj_index], parts_count = projection_offsets.back()](
+                const auto &proj)
+            {
+                if (proj.is_procedural() || proj.is_mapped() || proj.get_quantized_synapses()) return;
+                if (core::SynapseStorage::array_of_structures != proj.get_storage() || !proj.size()) return;
+                const auto *synapses = &*proj.begin();
+                const size_t part_size = get_projection_part_size(proj.get_uid());
+                for (size_t part_start = 0; part_start < proj.size(); part_start += part_size)
+                {
+                    const size_t synapses_count = std::min(part_size, proj.size() - part_start);
+                    const size_t node = get_part_node(first_part + part_start / part_size, parts_count);
+                    cpu_executors::move_to_numa_node(
+                        synapses + part_start, synapses_count * sizeof(*synapses), calc_pool_->get_node_id(node));
+                }
+            },
+            projections_[proj_index].arg_);
+    }
+
+    SPDLOG_DEBUG(
+        "{} population part(s) and {} projection part(s) placed on {} NUMA nodes.", population_offsets.back(),
+        projection_offsets.back(), calc_pool_->nodes_count());
+}
+
+
+std::vector<cpu_executors::WorkStealingPool::NodeLoad> MultiThreadedCPUBackend::get_numa_node_loads() const
+{
+    auto loads = calc_pool_->get_node_loads();
+    for (const auto &load : loads)
+    {
+        SPDLOG_INFO(
+            "NUMA node {}: {} worker(s), {} task(s), busy time {} ms.", load.node_id_, load.workers_count_,
+            load.tasks_count_, std::chrono::duration_cast<std::chrono::milliseconds>(load.busy_time_).count());
+    }
+    return loads;
+}
+
+
+void MultiThreadedCPUBackend::synchronize_populations()
+{
+    for (auto &population : populations_) std::visit([](auto &pop) { pop.synchronize_neurons(); }, population);
+}
+
+
 MultiThreadedCPUBackend::PopulationIterator MultiThreadedCPUBackend::begin_populations()
 {
+    synchronize_populations();
     return populations_.begin();
 }
 
@@ -359,6 +904,7 @@ MultiThreadedCPUBackend::PopulationConstIterator MultiThreadedCPUBackend::begin_
 
 MultiThreadedCPUBackend::PopulationIterator MultiThreadedCPUBackend::end_populations()
 {
+    synchronize_populations();
     return populations_.end();
 }
 
@@ -371,6 +917,9 @@ MultiThreadedCPUBackend::PopulationConstIterator MultiThreadedCPUBackend::end_po
 
 MultiThreadedCPUBackend::ProjectionIterator MultiThreadedCPUBackend::begin_projections()
 {
+    // Projections can be changed, so spikes of the previous pipelined step are processed by unchanged synapses.
+    finish_pipeline();
+    min_synapse_delay_.reset();
     return projections_.begin();
 }
 
@@ -383,6 +932,8 @@ MultiThreadedCPUBackend::ProjectionConstIterator MultiThreadedCPUBackend::begin_
 
 MultiThreadedCPUBackend::ProjectionIterator MultiThreadedCPUBackend::end_projections()
 {
+    finish_pipeline();
+    min_synapse_delay_.reset();
     return projections_.end();
 }
 
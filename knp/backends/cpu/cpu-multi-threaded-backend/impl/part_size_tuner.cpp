@@ -0,0 +1,133 @@
+/**
+ * @file part_size_tuner.cpp
+ * @brief Tuner of part sizes of populations and projections implementation.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knp/backends/cpu-multi-threaded/part_size_tuner.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+
+namespace knp::backends::multi_threaded_cpu
+{
+
+void PartSizeTuner::start(size_t tuning_steps)
+{
+    tuning_steps_ = tuning_steps;
+    is_warming_up_ = tuning_steps > 0;
+    for (auto &[uid, entry] : entries_)
+    {
+        entry.time_ = 0;
+        entry.items_count_ = 0;
+    }
+}
+
+
+size_t PartSizeTuner::get_part_size(const core::UID &uid, size_t default_part_size) const
+{
+    const auto entry_iter = entries_.find(uid);
+    if (entries_.end() == entry_iter || !entry_iter->second.part_size_) return default_part_size;
+    return entry_iter->second.part_size_;
+}
+
+
+void PartSizeTuner::set_part_size(const core::UID &uid, size_t part_size)
+{
+    if (!part_size) throw std::logic_error("Part size must be positive.");
+    entries_[uid].part_size_ = part_size;
+}
+
+
+PartSizeTuner::Measurement *PartSizeTuner::get_measurement(const core::UID &uid, size_t entity_size)
+{
+    if (!is_tuning()) return nullptr;
+    auto &entry = entries_[uid];
+    entry.entity_size_ = entity_size;
+    return &entry.measurement_;
+}
+
+
+bool PartSizeTuner::finish_step(size_t threads_count)
+{
+    if (!is_tuning()) return false;
+    threads_count = std::max<size_t>(threads_count, 1);
+    for (auto &[uid, entry] : entries_)
+    {
+        const auto time = entry.measurement_.time_.exchange(0, std::memory_order_relaxed);
+        const auto items_count = entry.measurement_.items_count_.exchange(0, std::memory_order_relaxed);
+        if (is_warming_up_ || !items_count) continue;
+
+        // Time of a neuron or a synapse is averaged over all measured steps, so that part sizes converge.
+        entry.time_ += static_cast<double>(time);
+        entry.items_count_ += static_cast<double>(items_count);
+        const double item_time = std::max(entry.time_ / entry.items_count_, 1e-3);
+        const double target_time = std::chrono::duration<double, std::nano>(target_part_time).count();
+        // Large entities are split into at least one part per thread.
+        const size_t max_part_size =
+            std::max((entry.entity_size_ + threads_count - 1) / threads_count, min_part_size);
+        entry.part_size_ = std::clamp(static_cast<size_t>(target_time / item_time), min_part_size, max_part_size);
+    }
+    if (is_warming_up_)
+    {
+        is_warming_up_ = false;
+        return false;
+    }
+    if (--tuning_steps_) return false;
+
+    const auto tuned_count = std::count_if(
+        entries_.begin(), entries_.end(), [](const auto &entry) { return entry.second.items_count_ > 0; });
+    SPDLOG_INFO("Part sizes of {} entities are tuned.", tuned_count);
+    return true;
+}
+
+
+void PartSizeTuner::save_profile(const std::filesystem::path &path) const
+{
+    std::ofstream stream(path);
+    for (const auto &[uid, entry] : entries_)
+    {
+        if (entry.part_size_) stream << uid << ' ' << entry.part_size_ << '\n';
+    }
+    if (!stream) throw std::runtime_error("Cannot write part size profile \"" + path.string() + "\".");
+}
+
+
+void PartSizeTuner::load_profile(const std::filesystem::path &path)
+{
+    std::ifstream stream(path);
+    if (!stream) throw std::runtime_error("Cannot open part size profile \"" + path.string() + "\".");
+    core::UID uid{false};
+    size_t part_size = 0;
+    while (stream >> uid)
+    {
+        if (!(stream >> part_size) || !part_size)
+        {
+            throw std::runtime_error("Part size profile \"" + path.string() + "\" is corrupted.");
+        }
+        entries_[uid].part_size_ = part_size;
+    }
+    if (!stream.eof()) throw std::runtime_error("Part size profile \"" + path.string() + "\" is corrupted.");
+}
+
+}  // namespace knp::backends::multi_threaded_cpu
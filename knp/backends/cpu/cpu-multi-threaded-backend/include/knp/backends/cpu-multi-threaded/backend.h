@@ -21,8 +21,10 @@
 
 #pragma once
 
-#include <knp/backends/thread_pool/thread_pool.h>
+#include <knp/backends/cpu-multi-threaded/part_size_tuner.h>
+#include <knp/backends/thread_pool/work_stealing_pool.h>
 #include <knp/core/backend.h>
+#include <knp/core/dense_synaptic_input.h>
 #include <knp/core/impexp.h>
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
@@ -30,7 +32,9 @@
 #include <knp/neuron-traits/all_traits.h>
 #include <knp/synapse-traits/all_traits.h>
 
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -49,9 +53,9 @@
 namespace knp::backends::cpu_executors
 {
 /**
- * @brief The ThreadPool class is an internal thread pool class used for task scheduling.
+ * @brief The WorkStealingPool class is an internal thread pool class used for task scheduling.
  */
-class ThreadPool;
+class WorkStealingPool;
 }  // namespace knp::backends::cpu_executors
 
 /**
@@ -69,6 +73,11 @@ const size_t default_population_part_size = 1000;
  */
 const size_t default_projection_part_size = 1000;
 
+/**
+ * @brief Default number of steps on which part sizes are tuned.
+ */
+const size_t default_part_size_tuning_steps = 10;
+
 /**
  * @brief The MultiThreadedCPUBackend class is a definition of an interface to the multi-threaded CPU backend.
  */
@@ -78,7 +87,7 @@ public:
     /**
      * @brief List of neuron types supported by the multi-threaded CPU backend.
      */
-    using SupportedNeurons = boost::mp11::mp_list<knp::neuron_traits::BLIFATNeuron>;
+    using SupportedNeurons = boost::mp11::mp_list<knp::neuron_traits::BLIFATNeuron, knp::neuron_traits::AltAILIF>;
 
     /**
      * @brief List of synapse types supported by the multi-threaded CPU backend.
@@ -164,13 +173,15 @@ public:
     /**
      * @brief Default constructor for multi-threaded CPU backend.
      * @param thread_count number of threads.
-     * @param population_part_size number of synapses that are calculated in a single thread.
-     * @param projection_part_size number of neurons that are calculated in a single thread.
+     * @param population_part_size default number of neurons that are calculated in a single thread.
+     * @param projection_part_size default number of synapses that are calculated in a single thread.
+     * @param is_numa_aware if `true`, threads are pinned to CPUs of NUMA nodes, population and projection parts are
+     * divided among nodes, and their data are moved to memory of their nodes on initialization.
      * @note If `thread_count` equals `0`, then the number of threads is calculated automatically.
      */
     explicit MultiThreadedCPUBackend(
         size_t thread_count = 0, size_t population_part_size = default_population_part_size,
-        size_t projection_part_size = default_projection_part_size);
+        size_t projection_part_size = default_projection_part_size, bool is_numa_aware = false);
     /**
      * @brief Destructor for multi-threaded CPU backend.
      * @note All threads are stopped and joined on destruction by an internal thread pool object.
@@ -241,6 +252,7 @@ public:
 public:
     /**
      * @brief Get an iterator pointing to the first element of the population loaded to backend.
+     * @details Neuron structures of populations are synchronized, so that constant per-neuron methods can be used.
      * @return population iterator.
      */
     [[nodiscard]] PopulationIterator begin_populations();
@@ -251,6 +263,7 @@ public:
     [[nodiscard]] PopulationConstIterator begin_populations() const;
     /**
      * @brief Get an iterator pointing to the last element of the population.
+     * @details Neuron structures of populations are synchronized, so that constant per-neuron methods can be used.
      * @return iterator.
      */
     [[nodiscard]] PopulationIterator end_populations();
@@ -261,6 +274,8 @@ public:
     [[nodiscard]] PopulationConstIterator end_populations() const;
     /**
      * @brief Get an iterator pointing to the first element of the projection loaded to backend.
+     * @details As projections can be changed, projections of the previous pipelined step are calculated, and the
+     * minimal synapse delay is computed again.
      * @return projection iterator.
      */
     [[nodiscard]] ProjectionIterator begin_projections();
@@ -271,6 +286,8 @@ public:
     [[nodiscard]] ProjectionConstIterator begin_projections() const;
     /**
      * @brief Get an iterator pointing to the last element of the projection.
+     * @details As projections can be changed, projections of the previous pipelined step are calculated, and the
+     * minimal synapse delay is computed again.
      * @return iterator.
      */
     [[nodiscard]] ProjectionIterator end_projections();
@@ -301,9 +318,114 @@ public:
      */
     [[nodiscard]] std::vector<std::unique_ptr<knp::core::Device>> get_devices() const override;
 
+    /**
+     * @brief Get load of NUMA nodes.
+     * @details Load is counted only if the backend is NUMA-aware.
+     * @return number of workers, executed tasks and busy time of each node used by the backend.
+     */
+    [[nodiscard]] std::vector<cpu_executors::WorkStealingPool::NodeLoad> get_numa_node_loads() const;
+
+public:
+    /**
+     * @brief Start tuning part sizes of populations and projections.
+     * @details During the tuning steps, calculation time of each part is measured, and part sizes of each population
+     * and projection are updated after each step. Populations and projections loaded later are tuned on the
+     * remaining steps.
+     * @param tuning_steps number of steps on which part sizes are measured.
+     * @see PartSizeTuner.
+     */
+    void start_part_size_tuning(size_t tuning_steps = default_part_size_tuning_steps)
+    {
+        part_size_tuner_.start(tuning_steps);
+    }
+
+    /**
+     * @brief Check if part sizes are being tuned.
+     * @return `true` if the tuning is not finished.
+     */
+    [[nodiscard]] bool is_tuning_part_sizes() const { return part_size_tuner_.is_tuning(); }
+
+    /**
+     * @brief Get part size of a population.
+     * @param uid population UID.
+     * @return number of neurons that are calculated in a single thread.
+     */
+    [[nodiscard]] size_t get_population_part_size(const knp::core::UID &uid) const
+    {
+        return part_size_tuner_.get_part_size(uid, population_part_size_);
+    }
+
+    /**
+     * @brief Get part size of a projection.
+     * @param uid projection UID.
+     * @return number of synapses that are calculated in a single thread.
+     */
+    [[nodiscard]] size_t get_projection_part_size(const knp::core::UID &uid) const
+    {
+        return part_size_tuner_.get_part_size(uid, projection_part_size_);
+    }
+
+    /**
+     * @brief Set part size of a population or a projection.
+     * @param uid population or projection UID.
+     * @param part_size number of neurons or synapses that are calculated in a single thread.
+     * @throw std::logic_error part size is `0`.
+     */
+    void set_part_size(const knp::core::UID &uid, size_t part_size) { part_size_tuner_.set_part_size(uid, part_size); }
+
+    /**
+     * @brief Save tuned and set part sizes to a profile.
+     * @param path profile path.
+     * @throw std::runtime_error profile can't be written.
+     */
+    void save_part_size_profile(const std::filesystem::path &path) const { part_size_tuner_.save_profile(path); }
+
+    /**
+     * @brief Load part sizes from a profile, so that the backend starts with tuned part sizes.
+     * @details Populations and projections that are not in the profile use default part sizes.
+     * @param path profile path.
+     * @throw std::runtime_error profile can't be read or is corrupted.
+     */
+    void load_part_size_profile(const std::filesystem::path &path) { part_size_tuner_.load_profile(path); }
+
+public:
+    /**
+     * @brief Enable or disable pipelined execution of steps.
+     * @details In pipelined mode, projections calculate spikes of the previous step on a separate pool of threads,
+     * while populations are calculated on the current step, and population spikes are routed before projections
+     * finish. Impacts are calculated for the step on which spikes were sent, so the network state is the same as in
+     * serial mode. A step is pipelined only if all synapse delays are at least `2`, because impacts of synapses
+     * with delay `1` are received by populations on the next step. Otherwise, the step is calculated serially.
+     * Projections don't add impacts to dense inputs on pipelined steps, as populations read dense inputs
+     * concurrently.
+     * @param is_pipelined `true` to enable pipelined execution.
+     * @param projection_thread_count number of threads that calculate projections in pipelined mode. If `0`, half of
+     * the backend thread count is used. Projection threads are taken from backend threads, so populations are
+     * calculated by the remaining threads, at least one, and the threads run on disjoint CPUs if there are enough
+     * CPUs.
+     * @note Projections of the previous pipelined step are calculated when pipelined execution is disabled.
+     */
+    void set_pipelined_execution(bool is_pipelined, size_t projection_thread_count = 0);
+
+    /**
+     * @brief Check if pipelined execution is enabled.
+     * @return `true` if steps are pipelined when synapse delays allow it.
+     */
+    [[nodiscard]] bool is_pipelined() const { return nullptr != projection_pool_; }
+
+    /**
+     * @brief Get minimal delay of synapses of all projections.
+     * @details The delay is computed once after projections are loaded or accessed by non-constant iterators, which
+     * requires reading all synapses.
+     * @return minimal synapse delay or maximal `size_t` value if there are no synapses.
+     */
+    [[nodiscard]] size_t get_min_synapse_delay();
+
 public:
     /**
      * @copydoc knp::core::Backend::_step()
+     * @note Populations and projections are calculated by pool workers in phases. Messages are routed by the calling
+     * thread between phases, as routing takes a small part of a step, see `step_overhead_benchmark.cpp`.
      */
     void _step() override;
 
@@ -348,10 +470,28 @@ protected:
 private:
     // Calculating pre-message neuron state, one thread per population_part_size_ neurons or less.
     void calculate_populations_pre_impact();
-    // Processing messages, one thread per population, probably very hard to go deeper unless atomic neuron params.
+    // Processing messages, one thread per population_part_size_ neurons or less, each gets impacts on its neurons only.
     void calculate_populations_impact();
     // Calculating post input changes and outputs.
     std::vector<knp::core::messaging::SpikeMessage> calculate_populations_post_impact();
+    // Calculating projections for spikes of a step without waiting for the pool. Dense inputs are used if allowed.
+    void start_projections(cpu_executors::WorkStealingPool &pool, uint64_t step, bool use_dense_inputs);
+    // Sending impacts that are received by populations on the next step.
+    void send_projection_messages();
+    // Calculating projections for spikes of the previous pipelined step, so that their impacts are not lost.
+    void finish_pipeline();
+    // Pipelined step: projections for the previous step are calculated while populations are calculated.
+    void pipelined_step();
+    // Offsets of the first parts of populations and projections, the last offset is the total number of parts.
+    std::vector<size_t> get_population_part_offsets() const;
+    std::vector<size_t> get_projection_part_offsets() const;
+    // NUMA node of a part, all parts of populations or projections are divided among nodes in contiguous ranges.
+    size_t get_part_node(size_t part_index, size_t parts_count) const;
+    static size_t get_part_node(size_t part_index, size_t parts_count, const cpu_executors::WorkStealingPool &pool);
+    // Move neurons and synapses of each part to memory of its NUMA node.
+    void place_on_numa_nodes();
+    // Update neuron structures of populations after kernels.
+    void synchronize_populations();
     // cppcheck-suppress unusedStructMember
     PopulationContainer populations_;
     ProjectionContainer projections_;
@@ -359,8 +499,21 @@ private:
     const size_t population_part_size_;
     // cppcheck-suppress unusedStructMember
     const size_t projection_part_size_;
-    std::unique_ptr<cpu_executors::ThreadPool> calc_pool_;
+    // Number of backend threads, which are divided between populations and projections in pipelined mode.
+    const size_t thread_count_;
+    std::unique_ptr<cpu_executors::WorkStealingPool> calc_pool_;
+    // Threads that calculate projections in pipelined mode, disjoint from threads of populations.
+    std::unique_ptr<cpu_executors::WorkStealingPool> projection_pool_;
+    // Converted spikes of projections, which are used by projection parts until the pool is joined.
+    std::vector<std::unordered_map<uint64_t, size_t>> projection_spikes_;
+    // Spikes of the previous step are waiting for projections in the endpoint.
+    bool has_pipelined_spikes_ = false;
+    std::optional<size_t> min_synapse_delay_;
+    // Part sizes of populations and projections that differ from default part sizes.
+    PartSizeTuner part_size_tuner_;
     std::mutex ep_mutex_;
+    // Inputs of BLIFAT populations, to which projections with dense delivery add impacts instead of sending messages.
+    std::unordered_map<knp::core::UID, knp::core::DenseSynapticInput, knp::core::uid_hash> dense_inputs_;
 };
 
 }  // namespace knp::backends::multi_threaded_cpu
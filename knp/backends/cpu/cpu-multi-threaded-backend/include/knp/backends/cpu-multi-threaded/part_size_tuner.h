@@ -0,0 +1,168 @@
+/**
+ * @file part_size_tuner.h
+ * @brief Tuner of part sizes of populations and projections calculated by the multi-threaded CPU backend.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/uid.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+
+
+/**
+ * @brief Namespace for multi-threaded backend.
+ */
+namespace knp::backends::multi_threaded_cpu
+{
+
+/**
+ * @brief The PartSizeTuner class chooses part sizes of populations and projections from their measured calculation
+ * time.
+ * @details While tuning, the backend measures time of each part and the number of neurons or synapses in the part.
+ * After each step, the tuner estimates calculation time of a single neuron or synapse of each entity from all
+ * measured steps, and sets the part size so that a part takes about `target_part_time`. Part sizes are limited, so
+ * that each thread gets a part of a large entity, and so that parts of cheap entities aren't too small. Tuned part
+ * sizes can be saved to a profile and loaded before the next run.
+ */
+class PartSizeTuner
+{
+public:
+    /**
+     * @brief Calculation time of a part that makes task scheduling overhead negligible.
+     */
+    static constexpr std::chrono::microseconds target_part_time{100};
+
+    /**
+     * @brief Minimal tuned part size.
+     */
+    static constexpr size_t min_part_size = 64;
+
+    /**
+     * @brief Time and number of neurons or synapses of entity parts calculated on a step.
+     * @note Parts can be measured by several threads concurrently.
+     */
+    struct Measurement
+    {
+        /**
+         * @brief Add time of a part.
+         * @param time calculation time of the part.
+         * @param items_count number of neurons or synapses in the part.
+         */
+        void add(std::chrono::nanoseconds time, size_t items_count)
+        {
+            time_.fetch_add(time.count(), std::memory_order_relaxed);
+            items_count_.fetch_add(items_count, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Total time of parts in nanoseconds.
+         */
+        std::atomic<int64_t> time_ = 0;
+
+        /**
+         * @brief Total number of neurons or synapses in parts.
+         */
+        std::atomic<size_t> items_count_ = 0;
+    };
+
+public:
+    /**
+     * @brief Start tuning.
+     * @details Measurements of the first step are discarded, as lazily built data of entities are usually prepared
+     * on that step.
+     * @param tuning_steps number of measured steps.
+     */
+    void start(size_t tuning_steps);
+
+    /**
+     * @brief Check if part sizes are being tuned.
+     * @return `true` if the tuning is not finished.
+     */
+    [[nodiscard]] bool is_tuning() const { return tuning_steps_ > 0; }
+
+    /**
+     * @brief Get part size of an entity.
+     * @param uid entity UID.
+     * @param default_part_size part size used if the entity has no part size.
+     * @return part size.
+     */
+    [[nodiscard]] size_t get_part_size(const core::UID &uid, size_t default_part_size) const;
+
+    /**
+     * @brief Set part size of an entity.
+     * @param uid entity UID.
+     * @param part_size part size.
+     * @throw std::logic_error part size is `0`.
+     */
+    void set_part_size(const core::UID &uid, size_t part_size);
+
+    /**
+     * @brief Get measurement of an entity for the current step.
+     * @param uid entity UID.
+     * @param entity_size number of neurons or synapses of the entity.
+     * @return measurement to which parts of the entity add their time, or `nullptr` if part sizes are not tuned.
+     * @note The method must not be called while parts are measured.
+     */
+    Measurement *get_measurement(const core::UID &uid, size_t entity_size);
+
+    /**
+     * @brief Update part sizes of entities measured on the step.
+     * @param threads_count number of threads that calculate parts.
+     * @return `true` if the tuning is finished by the step.
+     */
+    bool finish_step(size_t threads_count);
+
+    /**
+     * @brief Save part sizes of all entities to a profile.
+     * @details Each line of the profile contains an entity UID and its part size.
+     * @param path profile path.
+     * @throw std::runtime_error profile can't be written.
+     */
+    void save_profile(const std::filesystem::path &path) const;
+
+    /**
+     * @brief Load part sizes of entities from a profile.
+     * @param path profile path.
+     * @throw std::runtime_error profile can't be read or is corrupted.
+     */
+    void load_profile(const std::filesystem::path &path);
+
+private:
+    struct Entry
+    {
+        size_t part_size_ = 0;
+        size_t entity_size_ = 0;
+        // Totals of all measured steps.
+        double time_ = 0;
+        double items_count_ = 0;
+        Measurement measurement_;
+    };
+
+    std::unordered_map<core::UID, Entry, core::uid_hash> entries_;
+    size_t tuning_steps_ = 0;
+    bool is_warming_up_ = false;
+};
+
+}  // namespace knp::backends::multi_threaded_cpu
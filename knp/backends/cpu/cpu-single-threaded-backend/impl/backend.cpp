@@ -20,6 +20,7 @@
  */
 
 
+#include <knp/backends/cpu-library/altai_lif_population.h>
 #include <knp/backends/cpu-library/blifat_population.h>
 #include <knp/backends/cpu-library/delta_synapse_projection.h>
 #include <knp/backends/cpu-library/init.h>
@@ -148,6 +149,7 @@ void SingleThreadedCPUBackend::load_populations(const std::vector<PopulationVari
     SPDLOG_DEBUG("Loading populations [{}]...", populations.size());
     populations_.clear();
     populations_.reserve(populations.size());
+    dense_inputs_.clear();
 
     for (const auto &population : populations)
     {
@@ -183,6 +185,7 @@ void SingleThreadedCPUBackend::load_all_projections(const std::vector<knp::core:
 void SingleThreadedCPUBackend::load_all_populations(const std::vector<knp::core::AllPopulationsVariant> &populations)
 {
     SPDLOG_DEBUG("Loading populations [{}]...", populations.size());
+    dense_inputs_.clear();
     knp::meta::load_from_container<SupportedPopulations>(populations, populations_);
     SPDLOG_DEBUG("All populations loaded.");
 }
@@ -220,7 +223,11 @@ std::optional<core::messaging::SpikeMessage> SingleThreadedCPUBackend::calculate
     core::Population<knp::neuron_traits::BLIFATNeuron> &population)
 {
     SPDLOG_TRACE("Calculate BLIFAT population {}.", std::string(population.get_uid()));
-    return knp::backends::cpu::calculate_blifat_population(population, get_message_endpoint(), get_step());
+    // Projections calculated later on this step can add impacts to dense inputs of the population.
+    auto &dense_input = dense_inputs_[population.get_uid()];
+    dense_input.resize(population.size());
+    return knp::backends::cpu::calculate_blifat_population(
+        population, get_message_endpoint(), get_step(), &dense_input);
 }
 
 
@@ -234,12 +241,21 @@ std::optional<core::messaging::SpikeMessage> SingleThreadedCPUBackend::calculate
 }
 
 
+std::optional<core::messaging::SpikeMessage> SingleThreadedCPUBackend::calculate_population(
+    knp::core::Population<knp::neuron_traits::AltAILIF> &population)
+{
+    SPDLOG_TRACE("Calculate AltAILIF population {}.", std::string(population.get_uid()));
+    return knp::backends::cpu::calculate_altai_lif_population(population, get_message_endpoint(), get_step());
+}
+
+
 void SingleThreadedCPUBackend::calculate_projection(
     knp::core::Projection<knp::synapse_traits::DeltaSynapse> &projection, SynapticMessageQueue &message_queue)
 {
     SPDLOG_TRACE("Calculate delta synapse projection {}.", std::string(projection.get_uid()));
     knp::backends::cpu::calculate_delta_synapse_projection(
-        projection, get_message_endpoint(), message_queue, get_step());
+        projection, get_message_endpoint(), message_queue, get_step(),
+        knp::backends::cpu::find_dense_input(projection, dense_inputs_, get_message_endpoint()));
 }
 
 
@@ -263,8 +279,15 @@ void SingleThreadedCPUBackend::calculate_projection(
 }
 
 
+void SingleThreadedCPUBackend::synchronize_populations()
+{
+    for (auto &population : populations_) std::visit([](auto &pop) { pop.synchronize_neurons(); }, population);
+}
+
+
 SingleThreadedCPUBackend::PopulationIterator SingleThreadedCPUBackend::begin_populations()
 {
+    synchronize_populations();
     return PopulationIterator{populations_.begin()};
 }
 
@@ -277,6 +300,7 @@ SingleThreadedCPUBackend::PopulationConstIterator SingleThreadedCPUBackend::begi
 
 SingleThreadedCPUBackend::PopulationIterator SingleThreadedCPUBackend::end_populations()
 {
+    synchronize_populations();
     return PopulationIterator{populations_.end()};
 }
 
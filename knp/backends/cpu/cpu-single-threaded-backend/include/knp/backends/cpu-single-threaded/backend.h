@@ -22,6 +22,7 @@
 #pragma once
 
 #include <knp/core/backend.h>
+#include <knp/core/dense_synaptic_input.h>
 #include <knp/core/impexp.h>
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
@@ -55,8 +56,9 @@ public:
     /**
      * @brief List of neuron types supported by the single-threaded CPU backend.
      */
-    using SupportedNeurons =
-        boost::mp11::mp_list<knp::neuron_traits::BLIFATNeuron, knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>;
+    using SupportedNeurons = boost::mp11::mp_list<
+        knp::neuron_traits::BLIFATNeuron, knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron,
+        knp::neuron_traits::AltAILIF>;
 
     /**
      * @brief List of synapse types supported by the single-threaded CPU backend.
@@ -208,6 +210,7 @@ public:
 public:
     /**
      * @brief Get an iterator pointing to the first element of the population loaded to backend.
+     * @details Neuron structures of populations are synchronized, so that constant per-neuron methods can be used.
      * @return population iterator.
      */
     PopulationIterator begin_populations();
@@ -219,6 +222,7 @@ public:
     PopulationConstIterator begin_populations() const;
     /**
      * @brief Get an iterator pointing to the last element of the population.
+     * @details Neuron structures of populations are synchronized, so that constant per-neuron methods can be used.
      * @return iterator.
      */
     PopulationIterator end_populations();
@@ -335,6 +339,15 @@ protected:
      */
     std::optional<core::messaging::SpikeMessage> calculate_population(
         knp::core::Population<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron> &population);
+
+    /**
+     * @brief Calculate population of AltAILIF neurons.
+     * @note Population will be changed during calculation.
+     * @param population population to calculate.
+     * @return copy of a spike message if population is emitting one.
+     */
+    std::optional<core::messaging::SpikeMessage> calculate_population(
+        knp::core::Population<knp::neuron_traits::AltAILIF> &population);
     /**
      * @brief Calculate projection of delta synapses.
      * @note Projection will be changed during calculation.
@@ -363,9 +376,14 @@ protected:
         SynapticMessageQueue &message_queue);
 
 private:
+    // Update neuron structures of populations after kernels.
+    void synchronize_populations();
+
     // cppcheck-suppress unusedStructMember
     PopulationContainer populations_;
     ProjectionContainer projections_;
+    // Inputs of BLIFAT populations, to which projections with dense delivery add impacts instead of sending messages.
+    std::unordered_map<knp::core::UID, knp::core::DenseSynapticInput, knp::core::uid_hash> dense_inputs_;
 };
 
 }  // namespace knp::backends::single_threaded_cpu
@@ -0,0 +1,150 @@
+/**
+ * @file numa_topology.cpp
+ * @brief NUMA topology discovery, thread pinning and memory placement implementation.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <knp/backends/thread_pool/numa_topology.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#    include <pthread.h>
+#    include <sched.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+std::vector<int> parse_cpu_list(const std::string &cpu_list)
+{
+    std::vector<int> cpus;
+    std::stringstream stream(cpu_list);
+    std::string range;
+    while (std::getline(stream, range, ','))
+    {
+        if (range.find_first_of("0123456789") == std::string::npos) continue;
+        const auto dash = range.find('-');
+        const int first = std::stoi(range.substr(0, dash));
+        const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+
+std::vector<NumaNode> get_numa_nodes()
+{
+    std::vector<NumaNode> nodes;
+#if defined(__linux__)
+    cpu_set_t allowed_cpus;
+    CPU_ZERO(&allowed_cpus);
+    const bool has_allowed_cpus = sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) == 0;
+    const std::filesystem::path nodes_path{"/sys/devices/system/node"};
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(nodes_path, error))
+    {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            continue;
+        }
+        std::ifstream cpu_list_file(entry.path() / "cpulist");
+        std::string cpu_list;
+        std::getline(cpu_list_file, cpu_list);
+        NumaNode node{std::stoi(name.substr(4)), parse_cpu_list(cpu_list)};
+        // CPUs that the process isn't allowed to run on, for example because of `taskset`, can't run workers.
+        if (has_allowed_cpus)
+        {
+            node.cpus_.erase(
+                std::remove_if(
+                    node.cpus_.begin(), node.cpus_.end(),
+                    [&allowed_cpus](int cpu) { return cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed_cpus); }),
+                node.cpus_.end());
+        }
+        // Nodes without CPUs, such as memory expanders, can't run workers.
+        if (!node.cpus_.empty()) nodes.push_back(std::move(node));
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode &a, const NumaNode &b) { return a.id_ < b.id_; });
+#endif
+    if (nodes.empty())
+    {
+        NumaNode node;
+        node.cpus_.resize(std::max(std::thread::hardware_concurrency(), 1U));
+        std::iota(node.cpus_.begin(), node.cpus_.end(), 0);
+        nodes.push_back(std::move(node));
+    }
+    return nodes;
+}
+
+
+bool pin_current_thread(int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0) return true;
+    SPDLOG_WARN("Failed to pin thread to CPU {}.", cpu);
+#else
+    (void)cpu;
+#endif
+    return false;
+}
+
+
+bool move_to_numa_node(const void *data, size_t size, int node_id)
+{
+#if defined(__linux__) && defined(SYS_move_pages)
+    if (!data || !size) return true;
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto first_page = reinterpret_cast<uintptr_t>(data) / page_size * page_size;
+    const auto end = reinterpret_cast<uintptr_t>(data) + size;
+    std::vector<void *> pages;
+    for (uintptr_t page = first_page; page < end; page += page_size) pages.push_back(reinterpret_cast<void *>(page));
+    const std::vector<int> nodes(pages.size(), node_id);
+    std::vector<int> status(pages.size());
+    // Flag `MPOL_MF_MOVE` moves pages that are used only by this process.
+    constexpr int move_flag = 1 << 1;
+    if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nodes.data(), status.data(), move_flag) == 0)
+    {
+        return true;
+    }
+    SPDLOG_DEBUG("Failed to move {} memory page(s) to NUMA node {}.", pages.size(), node_id);
+#else
+    (void)data;
+    (void)size;
+    (void)node_id;
+#endif
+    return false;
+}
+
+}  // namespace knp::backends::cpu_executors
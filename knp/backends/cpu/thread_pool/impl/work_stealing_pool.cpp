@@ -0,0 +1,488 @@
+/**
+ * @file work_stealing_pool.cpp
+ * @brief Work-stealing thread pool implementation.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <knp/backends/thread_pool/numa_topology.h>
+#include <knp/backends/thread_pool/work_stealing_pool.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_map>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+namespace
+{
+// Pool and queue of the current worker thread, so that tasks posted by workers are added to their own queues.
+thread_local const WorkStealingPool *current_pool = nullptr;
+thread_local size_t current_queue = 0;
+
+// Time during which an idle thread checks for new tasks before it sleeps. Phases of a step are separated by short
+// serial code, so workers don't sleep between phases, and the thread that runs phases isn't woken by a system call.
+constexpr std::chrono::microseconds idle_spin_time{100};
+
+
+// Spin until the condition is met or the spin time is over.
+template <class Condition>
+bool spin_until(Condition &&condition)
+{
+    const auto spin_end = std::chrono::steady_clock::now() + idle_spin_time;
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() >= spin_end) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// Initial number of tasks in a queue.
+constexpr size_t initial_queue_capacity = 16;
+
+
+// Number of workers of all pools pinned to each CPU. Workers are pinned to the least used CPUs, so that pools of
+// different backends don't share CPUs while there are free ones.
+class CpuUsage
+{
+public:
+    // Take the least used CPU, the first one of equally used CPUs.
+    int take(const std::vector<int> &cpus)
+    {
+        const std::lock_guard lock(mutex_);
+        const auto cpu = *std::min_element(
+            cpus.begin(), cpus.end(), [this](int first, int second) { return count(first) < count(second); });
+        ++workers_counts_[cpu];
+        return cpu;
+    }
+
+    void release(int cpu)
+    {
+        const std::lock_guard lock(mutex_);
+        auto iter = workers_counts_.find(cpu);
+        if (workers_counts_.end() == iter) return;
+        if (!--iter->second) workers_counts_.erase(iter);
+    }
+
+private:
+    size_t count(int cpu) const
+    {
+        const auto iter = workers_counts_.find(cpu);
+        return workers_counts_.end() == iter ? 0 : iter->second;
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<int, size_t> workers_counts_;
+};
+
+
+CpuUsage &get_cpu_usage()
+{
+    static CpuUsage cpu_usage;
+    return cpu_usage;
+}
+}  // namespace
+
+
+WorkStealingPool::WorkStealingPool(size_t num_threads, bool is_numa_aware)
+    : WorkStealingPool(num_threads, is_numa_aware, get_numa_nodes())
+{
+}
+
+
+WorkStealingPool::WorkStealingPool(size_t num_threads, bool is_numa_aware, std::vector<NumaNode> nodes)
+    : is_numa_aware_(is_numa_aware)
+{
+    nodes.erase(
+        std::remove_if(nodes.begin(), nodes.end(), [](const NumaNode &node) { return node.cpus_.empty(); }),
+        nodes.end());
+    if (nodes.empty()) throw std::logic_error("No CPUs for thread pool workers.");
+    num_threads = std::max<size_t>(num_threads, 1);
+    queues_.reserve(num_threads);
+    worker_loads_.reserve(num_threads);
+    for (size_t queue_index = 0; queue_index < num_threads; ++queue_index)
+    {
+        queues_.push_back(std::make_unique<TaskQueue>());
+        queues_.back()->tasks_.resize(initial_queue_capacity);
+        worker_loads_.push_back(std::make_unique<WorkerLoad>());
+    }
+
+    // Each worker is pinned to the least used CPU, so that the scheduler doesn't move it away from its cached data,
+    // and workers of other pools don't share its CPU.
+    worker_nodes_.resize(num_threads);
+    worker_cpus_.resize(num_threads, -1);
+    if (is_numa_aware_)
+    {
+        // Workers are divided among nodes evenly, and each worker is pinned to a CPU of its node.
+        nodes.resize(std::min(nodes.size(), num_threads));
+        for (size_t worker_index = 0; worker_index < num_threads; ++worker_index)
+        {
+            const size_t node = worker_index * nodes.size() / num_threads;
+            if (node_first_workers_.size() == node) node_first_workers_.push_back(worker_index);
+            worker_nodes_[worker_index] = node;
+            worker_cpus_[worker_index] = get_cpu_usage().take(nodes[node].cpus_);
+        }
+        for (const auto &node : nodes) node_ids_.push_back(node.id_);
+        SPDLOG_INFO("Thread pool workers are divided among {} NUMA node(s).", nodes.size());
+    }
+    else
+    {
+        std::vector<int> cpus;
+        for (const auto &node : nodes) cpus.insert(cpus.end(), node.cpus_.begin(), node.cpus_.end());
+        for (auto &cpu : worker_cpus_) cpu = get_cpu_usage().take(cpus);
+        node_ids_.push_back(0);
+        node_first_workers_.push_back(0);
+    }
+    node_first_workers_.push_back(num_threads);
+    next_node_queues_ = std::vector<size_t>(node_first_workers_.begin(), node_first_workers_.end() - 1);
+
+    try
+    {
+        workers_.reserve(num_threads);
+        for (size_t worker_index = 0; worker_index < num_threads; ++worker_index)
+        {
+            workers_.emplace_back([this, worker_index] { work(worker_index); });
+        }
+    }
+    catch (...)
+    {
+        is_stopping_ = true;
+        work_condition_.notify_all();
+        for (auto &worker : workers_) worker.join();
+        for (const int cpu : worker_cpus_) get_cpu_usage().release(cpu);
+        throw;
+    }
+}
+
+
+WorkStealingPool::~WorkStealingPool()
+{
+    try
+    {
+        join();
+    }
+    catch (...)
+    {
+        // Exceptions of tasks that were not joined are lost.
+    }
+    {
+        const std::lock_guard lock(sleep_mutex_);
+        is_stopping_ = true;
+    }
+    work_condition_.notify_all();
+    for (auto &worker : workers_) worker.join();
+    for (const int cpu : worker_cpus_) get_cpu_usage().release(cpu);
+}
+
+
+void WorkStealingPool::push(PoolTask &&task)
+{
+    const size_t queue_index =
+        current_pool == this ? current_queue : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    ++unfinished_tasks_;
+    // The counter is increased first, so that it is never less than the number of tasks in queues.
+    ++queued_tasks_;
+    {
+        auto &queue = *queues_[queue_index];
+        const std::lock_guard lock(queue.mutex_);
+        push_to_queue(queue, std::move(task));
+    }
+    if (sleeping_workers_ > 0)
+    {
+        const std::lock_guard lock(sleep_mutex_);
+        work_condition_.notify_one();
+    }
+}
+
+
+void WorkStealingPool::push_to_queue(TaskQueue &queue, PoolTask &&task)
+{
+    if (queue.size_ == queue.tasks_.size())
+    {
+        std::vector<PoolTask> tasks(queue.tasks_.size() * 2);
+        for (size_t index = 0; index < queue.size_; ++index)
+        {
+            tasks[index] = std::move(queue.tasks_[(queue.first_ + index) % queue.tasks_.size()]);
+        }
+        queue.tasks_ = std::move(tasks);
+        queue.first_ = 0;
+    }
+    queue.tasks_[(queue.first_ + queue.size_) % queue.tasks_.size()] = std::move(task);
+    ++queue.size_;
+}
+
+
+void WorkStealingPool::run_phase()
+{
+    start_phase();
+    join();
+}
+
+
+void WorkStealingPool::start_phase()
+{
+    if (!phase_tasks_.empty())
+    {
+        unfinished_tasks_ += phase_tasks_.size();
+        queued_tasks_ += phase_tasks_.size();
+        if (nodes_count() == 1)
+        {
+            // Each queue gets a contiguous range of tasks, and its lock is taken once.
+            for (size_t queue_index = 0; queue_index < queues_.size(); ++queue_index)
+            {
+                const size_t first_task = phase_tasks_.size() * queue_index / queues_.size();
+                const size_t last_task = phase_tasks_.size() * (queue_index + 1) / queues_.size();
+                if (first_task == last_task) continue;
+                auto &queue = *queues_[queue_index];
+                const std::lock_guard lock(queue.mutex_);
+                for (size_t task_index = first_task; task_index < last_task; ++task_index)
+                {
+                    push_to_queue(queue, std::move(phase_tasks_[task_index]));
+                }
+            }
+        }
+        else
+        {
+            push_node_phase();
+        }
+        // Moved-from tasks are empty, and the buffers keep their capacity for the next phase.
+        phase_tasks_.clear();
+        phase_task_nodes_.clear();
+        if (sleeping_workers_ > 0)
+        {
+            const std::lock_guard lock(sleep_mutex_);
+            work_condition_.notify_all();
+        }
+    }
+}
+
+
+void WorkStealingPool::push_node_phase()
+{
+    // Tasks bound to a node go to queues of its workers in turn, other tasks go to all queues in turn.
+    phase_task_queues_.resize(phase_tasks_.size());
+    for (size_t task_index = 0; task_index < phase_tasks_.size(); ++task_index)
+    {
+        const size_t node = phase_task_nodes_[task_index];
+        if (any_node == node)
+        {
+            phase_task_queues_[task_index] = task_index % queues_.size();
+            continue;
+        }
+        size_t &next_queue = next_node_queues_[node];
+        phase_task_queues_[task_index] = next_queue;
+        if (++next_queue == node_first_workers_[node + 1]) next_queue = node_first_workers_[node];
+    }
+
+    // Tasks are grouped by queues with counting sort, so that the lock of each queue is taken once.
+    phase_queue_offsets_.assign(queues_.size() + 1, 0);
+    for (const size_t queue_index : phase_task_queues_) ++phase_queue_offsets_[queue_index + 1];
+    for (size_t queue_index = 0; queue_index < queues_.size(); ++queue_index)
+    {
+        phase_queue_offsets_[queue_index + 1] += phase_queue_offsets_[queue_index];
+    }
+    phase_task_order_.resize(phase_tasks_.size());
+    for (size_t task_index = 0; task_index < phase_tasks_.size(); ++task_index)
+    {
+        phase_task_order_[phase_queue_offsets_[phase_task_queues_[task_index]]++] = task_index;
+    }
+
+    size_t first_task = 0;
+    for (size_t queue_index = 0; queue_index < queues_.size(); ++queue_index)
+    {
+        const size_t last_task = phase_queue_offsets_[queue_index];
+        if (first_task == last_task) continue;
+        auto &queue = *queues_[queue_index];
+        const std::lock_guard lock(queue.mutex_);
+        for (; first_task < last_task; ++first_task)
+        {
+            push_to_queue(queue, std::move(phase_tasks_[phase_task_order_[first_task]]));
+        }
+    }
+}
+
+
+bool WorkStealingPool::try_pop(size_t queue_index, PoolTask &task)
+{
+    auto &queue = *queues_[queue_index];
+    const std::lock_guard lock(queue.mutex_);
+    if (!queue.size_) return false;
+    --queue.size_;
+    task = std::move(queue.tasks_[(queue.first_ + queue.size_) % queue.tasks_.size()]);
+    --queued_tasks_;
+    return true;
+}
+
+
+bool WorkStealingPool::try_steal_from(size_t queue_index, PoolTask &task)
+{
+    auto &queue = *queues_[queue_index];
+    const std::lock_guard lock(queue.mutex_);
+    if (!queue.size_) return false;
+    task = std::move(queue.tasks_[queue.first_]);
+    queue.first_ = (queue.first_ + 1) % queue.tasks_.size();
+    --queue.size_;
+    --queued_tasks_;
+    return true;
+}
+
+
+bool WorkStealingPool::try_steal(size_t worker_index, PoolTask &task)
+{
+    // Queues of the worker node are checked first, so that data of other nodes are accessed only if the node is idle.
+    const size_t node = worker_nodes_[worker_index];
+    const size_t first_worker = node_first_workers_[node];
+    const size_t node_workers_count = node_first_workers_[node + 1] - first_worker;
+    for (size_t offset = 1; offset < node_workers_count; ++offset)
+    {
+        if (try_steal_from(first_worker + (worker_index - first_worker + offset) % node_workers_count, task))
+        {
+            return true;
+        }
+    }
+    for (size_t offset = node_workers_count; offset < queues_.size(); ++offset)
+    {
+        if (try_steal_from((first_worker + offset) % queues_.size(), task)) return true;
+    }
+    return false;
+}
+
+
+bool WorkStealingPool::try_take(size_t worker_index, PoolTask &task)
+{
+    if (!queued_tasks_) return false;
+    // The worker takes its latest task, which data are likely in its cache, and steals the oldest tasks of others.
+    return try_pop(worker_index, task) || try_steal(worker_index, task);
+}
+
+
+void WorkStealingPool::execute(PoolTask &task, WorkerLoad *load)
+{
+    const auto start_time = load ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    try
+    {
+        task();
+    }
+    catch (...)
+    {
+        const std::lock_guard lock(sleep_mutex_);
+        if (!exception_) exception_ = std::current_exception();
+    }
+    // Resources captured by the task are released before the task is counted as finished.
+    task = PoolTask{};
+    if (load)
+    {
+        const auto busy_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_time);
+        load->tasks_count_.fetch_add(1, std::memory_order_relaxed);
+        load->busy_time_.fetch_add(busy_time.count(), std::memory_order_relaxed);
+    }
+    if (--unfinished_tasks_ == 0)
+    {
+        const std::lock_guard lock(sleep_mutex_);
+        join_condition_.notify_all();
+    }
+}
+
+
+void WorkStealingPool::work(size_t worker_index)
+{
+    current_pool = this;
+    current_queue = worker_index;
+    if (worker_cpus_[worker_index] >= 0) pin_current_thread(worker_cpus_[worker_index]);
+    // Only the NUMA-aware mode measures task time, so that other pools don't query the clock for each task.
+    WorkerLoad *load = is_numa_aware_ ? worker_loads_[worker_index].get() : nullptr;
+    PoolTask task;
+    while (true)
+    {
+        if (try_take(worker_index, task))
+        {
+            execute(task, load);
+            continue;
+        }
+        if (spin_until([this] { return queued_tasks_ > 0 || is_stopping_; }) && !is_stopping_) continue;
+
+        std::unique_lock lock(sleep_mutex_);
+        ++sleeping_workers_;
+        work_condition_.wait(lock, [this] { return queued_tasks_ > 0 || is_stopping_; });
+        --sleeping_workers_;
+        if (is_stopping_ && !queued_tasks_) return;
+    }
+}
+
+
+void WorkStealingPool::join()
+{
+    PoolTask task;
+    while (unfinished_tasks_ > 0)
+    {
+        if (queued_tasks_ && try_steal_any(task))
+        {
+            execute(task);
+            continue;
+        }
+        // Tasks taken by workers are usually short, so the thread waits for them without sleeping first.
+        if (spin_until([this] { return unfinished_tasks_ == 0 || queued_tasks_ > 0; })) continue;
+        std::unique_lock lock(sleep_mutex_);
+        join_condition_.wait(lock, [this] { return unfinished_tasks_ == 0 || queued_tasks_ > 0; });
+    }
+
+    std::exception_ptr exception;
+    {
+        const std::lock_guard lock(sleep_mutex_);
+        std::swap(exception, exception_);
+    }
+    if (exception) std::rethrow_exception(exception);
+}
+
+
+bool WorkStealingPool::try_steal_any(PoolTask &task)
+{
+    for (size_t queue_index = 0; queue_index < queues_.size(); ++queue_index)
+    {
+        if (try_steal_from(queue_index, task)) return true;
+    }
+    return false;
+}
+
+
+std::vector<WorkStealingPool::NodeLoad> WorkStealingPool::get_node_loads() const
+{
+    std::vector<NodeLoad> loads(nodes_count());
+    for (size_t node = 0; node < loads.size(); ++node)
+    {
+        loads[node].node_id_ = node_ids_[node];
+        loads[node].workers_count_ = node_first_workers_[node + 1] - node_first_workers_[node];
+    }
+    for (size_t worker_index = 0; worker_index < worker_loads_.size(); ++worker_index)
+    {
+        auto &load = loads[worker_nodes_[worker_index]];
+        load.tasks_count_ += worker_loads_[worker_index]->tasks_count_.load(std::memory_order_relaxed);
+        load.busy_time_ +=
+            std::chrono::nanoseconds(worker_loads_[worker_index]->busy_time_.load(std::memory_order_relaxed));
+    }
+    return loads;
+}
+
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,86 @@
+/**
+ * @file numa_topology.h
+ * @brief NUMA topology discovery, thread pinning and memory placement.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+/**
+ * @brief NUMA node with its logical CPUs.
+ */
+struct NumaNode
+{
+    /**
+     * @brief Node number used by the operating system.
+     */
+    int id_ = 0;
+
+    /**
+     * @brief Numbers of logical CPUs of the node.
+     */
+    std::vector<int> cpus_;
+};
+
+
+/**
+ * @brief Parse a list of CPU numbers in the format of Linux `cpulist` files, such as `0-3,8,10-11`.
+ * @param cpu_list list of CPU numbers and ranges.
+ * @return CPU numbers.
+ */
+std::vector<int> parse_cpu_list(const std::string &cpu_list);
+
+
+/**
+ * @brief Discover NUMA nodes that have CPUs.
+ * @details On Linux, nodes are read from `/sys/devices/system/node`, and only CPUs that the process is allowed to
+ * run on are returned. If the topology is unknown, a single node with all CPUs is returned.
+ * @return NUMA nodes sorted by their numbers.
+ */
+std::vector<NumaNode> get_numa_nodes();
+
+
+/**
+ * @brief Pin the calling thread to a logical CPU.
+ * @param cpu CPU number.
+ * @return `true` if the thread is pinned, `false` if pinning is not supported.
+ */
+bool pin_current_thread(int cpu);
+
+
+/**
+ * @brief Move memory pages of a buffer to a NUMA node.
+ * @details Pages that contain any byte of the buffer are moved, so pages shared by buffers of different nodes are
+ * placed on one of them. Memory placement is a hint, and failures don't affect the buffer contents.
+ * @param data buffer start.
+ * @param size buffer size in bytes.
+ * @param node_id node number used by the operating system.
+ * @return `true` if pages are moved, `false` if moving pages is not supported or failed.
+ */
+bool move_to_numa_node(const void *data, size_t size, int node_id);
+
+}  // namespace knp::backends::cpu_executors
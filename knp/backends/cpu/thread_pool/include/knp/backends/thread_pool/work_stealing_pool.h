@@ -0,0 +1,444 @@
+/**
+ * @file work_stealing_pool.h
+ * @brief Thread pool with per-worker task queues and work stealing.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <knp/backends/thread_pool/numa_topology.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+/**
+ * @brief The PoolTask class is a type-erased task that stores small callables without memory allocation.
+ * @details A callable that fits into the internal buffer, such as a lambda with a few captures or a bound function
+ * with a few arguments, is stored in place. Larger callables are allocated on the heap.
+ */
+class PoolTask
+{
+public:
+    /**
+     * @brief Size in bytes of callables that are stored without memory allocation.
+     */
+    static constexpr size_t inline_size = 12 * sizeof(void *);
+
+    /**
+     * @brief Construct an empty task.
+     */
+    PoolTask() = default;
+
+    /**
+     * @brief Construct a task from a callable.
+     * @tparam Func callable type.
+     * @param function callable without arguments.
+     */
+    template <class Func, class = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, PoolTask>>>
+    explicit PoolTask(Func &&function)
+    {
+        using Callable = std::decay_t<Func>;
+        if constexpr (is_inline<Callable>())
+        {
+            new (storage_) Callable(std::forward<Func>(function));
+            operations_ = &inline_operations<Callable>;
+        }
+        else
+        {
+            new (storage_) Callable *(new Callable(std::forward<Func>(function)));
+            operations_ = &heap_operations<Callable>;
+        }
+    }
+
+    /**
+     * @brief Move constructor.
+     * @param other task to move.
+     */
+    PoolTask(PoolTask &&other) noexcept : operations_(other.operations_)
+    {
+        if (operations_) operations_->move_(other.storage_, storage_);
+        other.operations_ = nullptr;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * @param other task to move.
+     * @return reference to this task.
+     */
+    PoolTask &operator=(PoolTask &&other) noexcept
+    {
+        if (this == &other) return *this;
+        reset();
+        operations_ = other.operations_;
+        if (operations_) operations_->move_(other.storage_, storage_);
+        other.operations_ = nullptr;
+        return *this;
+    }
+
+    PoolTask(const PoolTask &) = delete;
+    PoolTask &operator=(const PoolTask &) = delete;
+
+    /**
+     * @brief Destructor.
+     */
+    ~PoolTask() { reset(); }
+
+    /**
+     * @brief Check if the task stores a callable.
+     * @return `true` if the task is not empty.
+     */
+    explicit operator bool() const { return operations_ != nullptr; }
+
+    /**
+     * @brief Call the stored callable.
+     */
+    void operator()() { operations_->invoke_(storage_); }
+
+private:
+    struct Operations
+    {
+        void (*invoke_)(void *storage);
+        // Move-construct the callable at the destination and destroy the source.
+        void (*move_)(void *source, void *destination);
+        void (*destroy_)(void *storage);
+    };
+
+    template <class Callable>
+    static constexpr bool is_inline()
+    {
+        return sizeof(Callable) <= inline_size && alignof(Callable) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Callable>;
+    }
+
+    template <class Callable>
+    static constexpr Operations inline_operations{
+        [](void *storage) { (*static_cast<Callable *>(storage))(); },
+        [](void *source, void *destination)
+        {
+            new (destination) Callable(std::move(*static_cast<Callable *>(source)));
+            static_cast<Callable *>(source)->~Callable();
+        },
+        [](void *storage) { static_cast<Callable *>(storage)->~Callable(); }};
+
+    template <class Callable>
+    static constexpr Operations heap_operations{
+        [](void *storage) { (**static_cast<Callable **>(storage))(); },
+        [](void *source, void *destination) { new (destination) Callable *(*static_cast<Callable **>(source)); },
+        [](void *storage) { delete *static_cast<Callable **>(storage); }};
+
+    void reset()
+    {
+        if (operations_) operations_->destroy_(storage_);
+        operations_ = nullptr;
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[inline_size];
+    const Operations *operations_ = nullptr;
+};
+
+
+/**
+ * @brief The WorkStealingPool class is a thread pool where each worker has its own task queue.
+ * @details Tasks posted by a thread that is not a worker are distributed among worker queues in turn, and tasks posted
+ * by a worker are added to its own queue. A worker takes the last task of its queue, and if the queue is empty, steals
+ * the first task of another queue. Each queue has its own lock, so workers don't contend for a single queue. Idle
+ * workers spin for a while, then sleep until tasks are posted. Besides the `ThreadPool` interface, the pool runs
+ * phases of tasks that are queued together and followed by a barrier.
+ *
+ * Each worker is pinned to the CPU that has the fewest workers of all pools of the process, so that pools created
+ * one after another use different CPUs while there are free ones.
+ *
+ * In the NUMA-aware mode, workers are divided among NUMA nodes and pinned to CPUs of their nodes. Phase tasks can be
+ * bound to a node, so that they are executed by workers of the node that owns their data. Idle workers steal tasks
+ * of their own node first.
+ * @note Move and assignment are disabled.
+ */
+class WorkStealingPool
+{
+public:
+    /**
+     * @brief Load of a NUMA node.
+     */
+    struct NodeLoad
+    {
+        /**
+         * @brief Node number used by the operating system.
+         */
+        int node_id_ = 0;
+
+        /**
+         * @brief Number of workers of the node.
+         */
+        size_t workers_count_ = 0;
+
+        /**
+         * @brief Number of tasks executed by workers of the node.
+         */
+        size_t tasks_count_ = 0;
+
+        /**
+         * @brief Total time that workers of the node spent on tasks.
+         */
+        std::chrono::nanoseconds busy_time_{0};
+    };
+
+public:
+    /**
+     * @brief Create thread pool.
+     * @param num_threads number of worker threads in the pool.
+     * @param is_numa_aware if `true`, workers are divided among NUMA nodes and pinned to CPUs of their nodes,
+     * otherwise workers are pinned to the least used of all CPUs.
+     */
+    explicit WorkStealingPool(size_t num_threads = std::thread::hardware_concurrency(), bool is_numa_aware = false);
+
+    /**
+     * @brief Create thread pool that runs workers on given CPUs.
+     * @details Pools that run on disjoint sets of CPUs don't compete for CPUs.
+     * @param num_threads number of worker threads in the pool.
+     * @param is_numa_aware if `true`, workers are divided among the nodes and pinned to CPUs of their nodes,
+     * otherwise workers are pinned to the least used CPUs of the nodes.
+     * @param nodes NUMA nodes with CPUs on which workers run.
+     * @throw std::logic_error if the nodes have no CPUs.
+     */
+    WorkStealingPool(size_t num_threads, bool is_numa_aware, std::vector<NumaNode> nodes);
+
+    /**
+     * @brief Blocking destructor.
+     * @note The destructor waits for all tasks to finish, then joins all worker threads.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+     * @brief Add task to pool.
+     * @details The function and its arguments are stored in the task without memory allocation, unless they don't
+     * fit into `PoolTask::inline_size` bytes.
+     * @tparam Func function type.
+     * @tparam Args function arguments.
+     * @param func task to run in the pool.
+     * @param args function arguments (if required, use `std::ref`).
+     * @note Non-blocking method.
+     */
+    template <class Func, typename... Args>
+    void post(Func func, Args... args)
+    {
+        push(make_task(std::move(func), std::move(args)...));
+    }
+
+    /**
+     * @brief Add task to the next phase.
+     * @details Tasks of a phase are queued together by `run_phase`, so that workers are woken once per phase instead
+     * of once per task.
+     * @tparam Func function type.
+     * @tparam Args function arguments.
+     * @param func task to run in the pool.
+     * @param args function arguments (if required, use `std::ref`).
+     * @note The method must be called by the thread that runs phases.
+     */
+    template <class Func, typename... Args>
+    void post_to_phase(Func func, Args... args)
+    {
+        phase_tasks_.push_back(make_task(std::move(func), std::move(args)...));
+        phase_task_nodes_.push_back(any_node);
+    }
+
+    /**
+     * @brief Add task to the next phase and bind it to a NUMA node.
+     * @details Tasks bound to a node are divided among queues of the node workers. They can still be stolen by
+     * workers of other nodes that are idle. If the pool is not NUMA-aware, the node is ignored.
+     * @tparam Func function type.
+     * @tparam Args function arguments.
+     * @param node index of the node in the pool, less than `nodes_count()`.
+     * @param func task to run in the pool.
+     * @param args function arguments (if required, use `std::ref`).
+     * @note The method must be called by the thread that runs phases.
+     */
+    template <class Func, typename... Args>
+    void post_to_node_phase(size_t node, Func func, Args... args)
+    {
+        phase_tasks_.push_back(make_task(std::move(func), std::move(args)...));
+        phase_task_nodes_.push_back(node % nodes_count());
+    }
+
+    /**
+     * @brief Execute tasks added to the phase and wait until they are finished.
+     * @details Tasks are divided among worker queues at once, and sleeping workers are woken by a single notification.
+     * Workers that become idle spin for a while before they sleep, so they don't sleep between phases of a step. The
+     * calling thread executes tasks while it waits.
+     * @throw exception thrown by the first failed task, if any.
+     */
+    void run_phase();
+
+    /**
+     * @brief Execute tasks added to the phase without waiting for them.
+     * @details Tasks are queued in the same way as by `run_phase`, and the calling thread can do other work before it
+     * calls `join`.
+     * @note Non-blocking method. Tasks must not use data that the calling thread changes before `join`.
+     */
+    void start_phase();
+
+    /**
+     * @brief Wait until all posted tasks are finished.
+     * @details The calling thread executes queued tasks while it waits.
+     * @throw exception thrown by the first failed task, if any.
+     * @note Blocking method that waits indefinitely if at least one task never stops.
+     */
+    void join();
+
+    /**
+     * @brief Get number of worker threads.
+     * @return number of worker threads.
+     */
+    [[nodiscard]] size_t size() const { return workers_.size(); }
+
+    /**
+     * @brief Check if the pool is NUMA-aware.
+     * @return `true` if workers are bound to NUMA nodes.
+     */
+    [[nodiscard]] bool is_numa_aware() const { return is_numa_aware_; }
+
+    /**
+     * @brief Get number of NUMA nodes used by the pool.
+     * @return number of nodes that have workers, `1` if the pool is not NUMA-aware.
+     */
+    [[nodiscard]] size_t nodes_count() const { return node_ids_.size(); }
+
+    /**
+     * @brief Get operating system number of a NUMA node used by the pool.
+     * @param node index of the node in the pool.
+     * @return node number used by the operating system.
+     */
+    [[nodiscard]] int get_node_id(size_t node) const { return node_ids_.at(node); }
+
+    /**
+     * @brief Get CPU to which a worker is pinned.
+     * @param worker_index index of the worker.
+     * @return number of logical CPU used by the operating system.
+     */
+    [[nodiscard]] int get_worker_cpu(size_t worker_index) const { return worker_cpus_.at(worker_index); }
+
+    /**
+     * @brief Get load of NUMA nodes used by the pool.
+     * @details Tasks and busy time are counted only in the NUMA-aware mode. Tasks executed by threads that wait in
+     * `join` or `run_phase` are not counted.
+     * @return loads of nodes in the order of their indexes.
+     */
+    [[nodiscard]] std::vector<NodeLoad> get_node_loads() const;
+
+private:
+    // Ring buffer of tasks, which doesn't allocate memory once it has grown to the largest batch.
+    struct TaskQueue
+    {
+        std::mutex mutex_;
+        std::vector<PoolTask> tasks_;
+        size_t first_ = 0;
+        size_t size_ = 0;
+    };
+
+    // Counters are written only by their worker.
+    struct WorkerLoad
+    {
+        std::atomic<size_t> tasks_count_ = 0;
+        std::atomic<int64_t> busy_time_ = 0;
+    };
+
+    static constexpr size_t any_node = static_cast<size_t>(-1);
+
+    template <class Func, typename... Args>
+    static PoolTask make_task(Func func, Args... args)
+    {
+        if constexpr (sizeof...(Args) == 0)
+        {
+            return PoolTask(std::move(func));
+        }
+        else
+        {
+            return PoolTask(std::bind(func, args...));
+        }
+    }
+
+    static void push_to_queue(TaskQueue &queue, PoolTask &&task);
+
+    void push(PoolTask &&task);
+
+    void push_node_phase();
+
+    bool try_pop(size_t queue_index, PoolTask &task);
+
+    bool try_steal_from(size_t queue_index, PoolTask &task);
+
+    bool try_steal(size_t worker_index, PoolTask &task);
+
+    bool try_steal_any(PoolTask &task);
+
+    bool try_take(size_t worker_index, PoolTask &task);
+
+    void execute(PoolTask &task, WorkerLoad *load = nullptr);
+
+    void work(size_t worker_index);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+    std::vector<std::thread> workers_;
+    const bool is_numa_aware_;
+    // Operating system numbers of nodes, and workers of each node, which are numbered contiguously.
+    std::vector<int> node_ids_;
+    std::vector<size_t> node_first_workers_;
+    std::vector<size_t> worker_nodes_;
+    // CPU of each worker, or -1 if the worker is not pinned.
+    std::vector<int> worker_cpus_;
+    std::vector<std::unique_ptr<WorkerLoad>> worker_loads_;
+    // Number of tasks in all queues.
+    std::atomic<size_t> queued_tasks_ = 0;
+    // Number of tasks that are posted but not finished.
+    std::atomic<size_t> unfinished_tasks_ = 0;
+    std::atomic<size_t> sleeping_workers_ = 0;
+    std::atomic<size_t> next_queue_ = 0;
+    std::atomic<bool> is_stopping_ = false;
+    std::mutex sleep_mutex_;
+    std::condition_variable work_condition_;
+    std::condition_variable join_condition_;
+    std::exception_ptr exception_;
+    std::vector<PoolTask> phase_tasks_;
+    std::vector<size_t> phase_task_nodes_;
+    // Buffers used to group phase tasks by queues, and the next queue of each node.
+    std::vector<size_t> phase_task_queues_;
+    std::vector<size_t> phase_queue_offsets_;
+    std::vector<size_t> phase_task_order_;
+    std::vector<size_t> next_node_queues_;
+};
+
+}  // namespace knp::backends::cpu_executors
@@ -203,7 +203,7 @@ void Network::add_projection(core::AllProjectionsVariant &&projection)
     SPDLOG_DEBUG("Adding projection variant...");
 
     // check_projection_constraints(std::visit([](const auto &var_val) { return var_val; }, projection));
-    projections_.emplace_back(projection);
+    projections_.emplace_back(std::move(projection));
 }
 
 
@@ -25,6 +25,9 @@
 #include <spdlog/spdlog.h>
 
 #include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid.hpp>
@@ -46,6 +49,20 @@ std::string get_synapse_type_name<synapse_traits::DeltaSynapse>()
 }
 
 
+using DeltaConvolution = core::Projection<synapse_traits::DeltaSynapse>::Convolution;
+
+
+// Convolution geometry is stored in attributes, kernel parameters are stored as edges.
+const std::vector<std::pair<std::string, size_t DeltaConvolution::*>> convolution_attributes{
+    {"input_width", &DeltaConvolution::input_width_},
+    {"input_height", &DeltaConvolution::input_height_},
+    {"input_channels", &DeltaConvolution::input_channels_},
+    {"kernel_width", &DeltaConvolution::kernel_width_},
+    {"kernel_height", &DeltaConvolution::kernel_height_},
+    {"output_channels", &DeltaConvolution::output_channels_},
+    {"stride", &DeltaConvolution::stride_}};
+
+
 template <>
 core::Projection<knp::synapse_traits::DeltaSynapse> load_projection(
     const HighFive::Group &edges_group, const std::string &projection_name)
@@ -75,21 +92,71 @@ core::Projection<knp::synapse_traits::DeltaSynapse> load_projection(
     const core::UID uid_own{boost::lexical_cast<boost::uuids::uuid>(projection_name)};
 
 
-    std::vector<Synapse> synapses;
-    synapses.reserve(group_size);
-    for (size_t i = 0; i < weights.size(); ++i)
+    auto make_parameters = [&weights, &delays, &out_types](size_t i)
     {
         synapse_traits::synapse_parameters<synapse_traits::DeltaSynapse> syn;
         syn.weight_ = weights[i];
         syn.delay_ = delays[i];
         syn.output_type_ = static_cast<synapse_traits::OutputType>(out_types[i]);
-        const size_t id_from = source_ids[i];
-        const size_t id_to = target_ids[i];
-        synapses.emplace_back(syn, id_from, id_to);
-    }
+        return syn;
+    };
+
+    auto make_projection = [&]()
+    {
+        if (group.exist("syn_weight_quantized"))
+        {
+            // Quantized weights are loaded as is, without conversion to 32-bit floats.
+            const auto weights_dataset = group.getDataSet("syn_weight_quantized");
+            const auto quantization = weights_dataset.getAttribute("quantization").read<std::string>();
+            core::QuantizedSynapses synapses;
+            if ("int8" == quantization)
+            {
+                synapses.quantization_ = core::WeightQuantization::int8;
+                synapses.scale_ = weights_dataset.getAttribute("scale").read<float>();
+                weights_dataset.read(synapses.int8_weights_);
+            }
+            else if ("float16" == quantization)
+            {
+                synapses.quantization_ = core::WeightQuantization::float16;
+                weights_dataset.read(synapses.float16_weights_);
+            }
+            else
+            {
+                throw std::runtime_error("Unknown weight quantization \"" + quantization + "\".");
+            }
+            synapses.delays_.assign(delays.begin(), delays.end());
+            synapses.output_types_.reserve(group_size);
+            for (const auto out_type : out_types) synapses.output_types_.push_back(static_cast<uint8_t>(out_type));
+            synapses.source_neurons_.assign(source_ids.begin(), source_ids.end());
+            synapses.target_neurons_.assign(target_ids.begin(), target_ids.end());
+            return core::Projection<synapse_traits::DeltaSynapse>(uid_own, uid_from, uid_to, std::move(synapses));
+        }
+
+        if (projection_group.exist("convolution"))
+        {
+            // Edges of a convolutional projection are kernel elements.
+            const auto convolution_group = projection_group.getGroup("convolution");
+            DeltaConvolution convolution;
+            for (const auto &[name, member] : convolution_attributes)
+                convolution.*member = convolution_group.getAttribute(name).read<uint64_t>();
+            convolution.kernel_.reserve(group_size);
+            for (size_t i = 0; i < weights.size(); ++i) convolution.kernel_.push_back(make_parameters(i));
+            return core::Projection<synapse_traits::DeltaSynapse>(uid_own, uid_from, uid_to, std::move(convolution));
+        }
+
+        std::vector<Synapse> synapses;
+        synapses.reserve(group_size);
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            const size_t id_from = source_ids[i];
+            const size_t id_to = target_ids[i];
+            synapses.emplace_back(make_parameters(i), id_from, id_to);
+        }
+        return core::Projection<synapse_traits::DeltaSynapse>(
+            uid_own, uid_from, uid_to, [&synapses](size_t syn_num) { return synapses[syn_num]; }, synapses.size());
+    };
 
-    core::Projection<synapse_traits::DeltaSynapse> proj(
-        uid_own, uid_from, uid_to, [&synapses](size_t syn_num) { return synapses[syn_num]; }, synapses.size());
+    auto proj = make_projection();
 
     if (projection_group.hasAttribute("is_locked"))
     {
@@ -120,19 +187,73 @@ void add_projection_to_h5<core::Projection<synapse_traits::DeltaSynapse>>(
     std::vector<decltype(SynapseParams::weight_)> weights;
     std::vector<int> out_types;
 
-    source_ids.reserve(projection.size());
-    target_ids.reserve(projection.size());
-    delays.reserve(projection.size());
-    weights.reserve(projection.size());
-    out_types.reserve(projection.size());
+    // A convolutional projection is saved as its kernel, and neuron indexes are not saved.
+    const auto *convolution = projection.get_convolution();
+    const size_t edges_count = convolution ? convolution->kernel_.size() : projection.size();
+    source_ids.reserve(edges_count);
+    target_ids.reserve(edges_count);
+    delays.reserve(edges_count);
+    weights.reserve(edges_count);
+    out_types.reserve(edges_count);
 
-    for (const auto &v : projection)
+    auto add_parameters = [&delays, &weights, &out_types](const SynapseParams &params)
     {
-        source_ids.push_back(std::get<knp::core::source_neuron_id>(v));
-        target_ids.push_back(std::get<knp::core::target_neuron_id>(v));
-        delays.push_back(std::get<knp::core::synapse_data>(v).delay_);
-        weights.push_back(std::get<knp::core::synapse_data>(v).weight_);
-        out_types.push_back(static_cast<int>(std::get<knp::core::synapse_data>(v).output_type_));
+        delays.push_back(params.delay_);
+        weights.push_back(params.weight_);
+        out_types.push_back(static_cast<int>(params.output_type_));
+    };
+
+    // Quantized weights are saved as is, so the projection is not materialized.
+    const auto *quantized = projection.get_quantized_synapses();
+
+    if (convolution)
+    {
+        for (const auto &params : convolution->kernel_) add_parameters(params);
+    }
+    else if (quantized)
+    {
+        for (size_t i = 0; i < quantized->size(); ++i)
+        {
+            source_ids.push_back(quantized->source_neurons_[i]);
+            target_ids.push_back(quantized->target_neurons_[i]);
+            delays.push_back(quantized->delays_[i]);
+            out_types.push_back(quantized->output_types_[i]);
+        }
+    }
+    else if (projection.is_procedural())
+    {
+        // Synapses of a procedural projection are generated row by row, so the projection is not materialized.
+        std::vector<core::Projection<synapse_traits::DeltaSynapse>::Synapse> synapses;
+        for (size_t neuron_index = 0; neuron_index < projection.get_procedural_presynaptic_size(); ++neuron_index)
+        {
+            projection.generate_presynaptic_synapses(neuron_index, synapses);
+            for (const auto &synapse : synapses)
+            {
+                source_ids.push_back(std::get<knp::core::source_neuron_id>(synapse));
+                target_ids.push_back(std::get<knp::core::target_neuron_id>(synapse));
+                add_parameters(std::get<knp::core::synapse_data>(synapse));
+            }
+        }
+    }
+    else if (const auto *mapped_file = projection.get_mapped_file())
+    {
+        // Synapses of a mapped projection are read from the file, so the projection is not materialized.
+        const auto *parameters = mapped_file->get_parameters<SynapseParams>();
+        for (size_t i = 0; i < mapped_file->size(); ++i)
+        {
+            source_ids.push_back(mapped_file->get_source_neurons()[i]);
+            target_ids.push_back(mapped_file->get_target_neurons()[i]);
+            add_parameters(parameters[i]);
+        }
+    }
+    else
+    {
+        for (const auto &v : projection)
+        {
+            source_ids.push_back(std::get<knp::core::source_neuron_id>(v));
+            target_ids.push_back(std::get<knp::core::target_neuron_id>(v));
+            add_parameters(std::get<knp::core::synapse_data>(v));
+        }
     }
 
     HighFive::Group proj_group = file_h5.createGroup("edges/" + std::string(projection.get_uid()));
@@ -143,21 +264,42 @@ void add_projection_to_h5<core::Projection<synapse_traits::DeltaSynapse>>(
     target_node_dataset.createAttribute("node_population", std::string(projection.get_postsynaptic()));
 
     // At the moment we support only one synapse group.
-    proj_group.createDataSet("edge_group_id", std::vector(projection.size(), 0));
+    proj_group.createDataSet("edge_group_id", std::vector(edges_count, 0));
     proj_group.createDataSet(
-        "edge_type_id", std::vector(projection.size(), get_synapse_type_id<synapse_traits::DeltaSynapse>()));
+        "edge_type_id", std::vector(edges_count, get_synapse_type_id<synapse_traits::DeltaSynapse>()));
 
     std::vector<uint64_t> group_index;
-    group_index.reserve(projection.size());
-    for (size_t i = 0; i < projection.size(); ++i) group_index.push_back(i);
+    group_index.reserve(edges_count);
+    for (size_t i = 0; i < edges_count; ++i) group_index.push_back(i);
 
     proj_group.createDataSet("edge_group_index", group_index);
 
     HighFive::Group syn_group = proj_group.createGroup("0");
-    syn_group.createDataSet("syn_weight", weights);
+    if (!quantized)
+    {
+        syn_group.createDataSet("syn_weight", weights);
+    }
+    else if (core::WeightQuantization::int8 == quantized->quantization_)
+    {
+        auto weights_dataset = syn_group.createDataSet("syn_weight_quantized", quantized->int8_weights_);
+        weights_dataset.createAttribute("quantization", std::string("int8"));
+        weights_dataset.createAttribute("scale", quantized->scale_);
+    }
+    else
+    {
+        auto weights_dataset = syn_group.createDataSet("syn_weight_quantized", quantized->float16_weights_);
+        weights_dataset.createAttribute("quantization", std::string("float16"));
+    }
     syn_group.createDataSet("delay", delays);
     syn_group.createDataSet("output_type_", out_types);
     proj_group.createAttribute("is_locked", projection.is_locked());
+
+    if (convolution)
+    {
+        HighFive::Group convolution_group = proj_group.createGroup("convolution");
+        for (const auto &[name, member] : convolution_attributes)
+            convolution_group.createAttribute(name, static_cast<uint64_t>(convolution->*member));
+    }
 }
 
 }  // namespace knp::framework::sonata
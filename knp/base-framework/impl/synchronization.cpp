@@ -30,6 +30,8 @@ KNP_DECLSPEC Network get_network_copy(const knp::core::Backend &backend)
     for (auto &iter = *data_ranges.population_range.first; iter != *data_ranges.population_range.second; ++iter)
     {
         auto population = *iter;
+        // Copied neurons are updated, as backend populations cannot be changed through constant ranges.
+        std::visit([](auto &pop) { pop.synchronize_neurons(); }, population);
         res_network.add_population(std::move(population));
     }
     for (auto &iter = *data_ranges.projection_range.first; iter != *data_ranges.projection_range.second; ++iter)
@@ -22,6 +22,7 @@
 
 #include <knp/core/projection.h>
 
+#include <cstdint>
 #include <exception>
 #include <functional>
 #include <optional>
@@ -171,6 +172,40 @@ template <typename SynapseType>
 }
 
 
+/**
+ * @brief Make a procedural projection with connections between each presynaptic population (source) neuron
+ * to each postsynaptic population (destination) neuron with some probability.
+ * @details The projection stores only the connection probability, the seed and the generator of synapse parameters.
+ * Synapses are regenerated when presynaptic neurons send spikes, and only connected neurons are visited. Synapses have
+ * the same distribution as synapses of a projection created by `fixed_probability()`, but not the same neurons.
+ * @warning It doesn't get "real" populations and can't be used with populations that contain non-contiguous indexes.
+ * @param presynaptic_uid presynaptic population UID.
+ * @param postsynaptic_uid postsynaptic population UID.
+ * @param presynaptic_pop_size presynaptic population neuron count.
+ * @param postsynaptic_pop_size postsynaptic population neuron count.
+ * @param connection_probability connection probability.
+ * @param syn_gen thread-safe generator of synapse parameters.
+ * @param seed random generator seed.
+ * @tparam SynapseType projection synapse type.
+ * @return procedural projection.
+ */
+template <typename SynapseType>
+[[nodiscard]] knp::core::Projection<SynapseType> procedural_fixed_probability(
+    const knp::core::UID &presynaptic_uid, const knp::core::UID &postsynaptic_uid, size_t presynaptic_pop_size,
+    size_t postsynaptic_pop_size, double connection_probability,
+    parameters_generators::SynGen2ParamsType<SynapseType> syn_gen =
+        parameters_generators::default_synapse_gen<SynapseType>,
+    uint64_t seed = std::random_device()())
+{
+    const synapse_generators::FixedProbability<SynapseType> fp{
+        presynaptic_pop_size, postsynaptic_pop_size, connection_probability, syn_gen, seed};
+
+    return knp::core::Projection<SynapseType>(
+        presynaptic_uid, postsynaptic_uid,
+        synapse_generators::procedural<SynapseType>(fp, presynaptic_pop_size, postsynaptic_pop_size));
+}
+
+
 /**
  * @brief Make connections between neurons of presynaptic and postsynaptic populations
  * based on the synapse generation function result.
@@ -197,7 +232,7 @@ template <typename SynapseType>
 
 /**
  * @brief Make connections between each presynaptic neuron and a fixed number of random postsynaptic neurons.
- * @details This connector uses MT19937 generator with uniform integer distribution.
+ * @details This connector uses IndexRandomEngine generator with uniform integer distribution.
  * @warning It doesn't get "real" populations and can't be used with populations that contain non-contiguous indexes.
  * @param presynaptic_uid presynaptic population UID.
  * @param postsynaptic_uid postsynaptic population UID.
@@ -226,7 +261,7 @@ template <typename SynapseType>
 
 /**
  * @brief Make connections between each postsynaptic neuron and a fixed number of random presynaptic neurons.
- * @details This connector uses MT19937 generator with uniform integer distribution.
+ * @details This connector uses IndexRandomEngine generator with uniform integer distribution.
  * @warning It doesn't get "real" populations and can't be used with populations that contain non-contiguous indexes.
  * @param presynaptic_uid presynaptic population UID.
  * @param postsynaptic_uid postsynaptic population UID.
@@ -23,11 +23,16 @@
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <exception>
 #include <functional>
+#include <limits>
 #include <optional>
 #include <random>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "synapse_parameters_generators.h"
 
@@ -152,6 +157,59 @@ private:
 };
 
 
+/**
+ * @brief The IndexRandomEngine class is a definition of a random number engine which sequence is defined by a seed and
+ * an iteration index.
+ * @details The engine uses SplitMix64 algorithm. Generators create a new engine for each iteration, so their results
+ * don't depend on the order of calls and are the same if generators are run in several threads.
+ */
+class IndexRandomEngine
+{
+public:
+    /**
+     * @brief Type of generated values.
+     */
+    using result_type = uint64_t;
+
+    /**
+     * @brief Constructor.
+     * @param seed generator seed.
+     * @param index iteration index.
+     */
+    IndexRandomEngine(uint64_t seed, uint64_t index) : state_(mix(seed ^ mix(index + gamma))) {}
+
+    /**
+     * @brief Get minimum generated value.
+     * @return minimum value.
+     */
+    static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+
+    /**
+     * @brief Get maximum generated value.
+     * @return maximum value.
+     */
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief Generate next value.
+     * @return random value.
+     */
+    result_type operator()() { return mix(state_ += gamma); }
+
+private:
+    static constexpr uint64_t gamma = 0x9e3779b97f4a7c15ULL;
+
+    static constexpr uint64_t mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    uint64_t state_;
+};
+
+
 /**
  * @brief The FixedProbability class is a definition of a generator that makes connections with some probability 
  * between each presynaptic population (source) neuron to each postsynaptic population (destination) neuron.
@@ -168,17 +226,18 @@ public:
      * @param postsynaptic_pop_size postsynaptic population neuron count.
      * @param connection_probability connection probability.
      * @param syn_gen generator of synapse parameters.
+     * @param seed random generator seed.
      */
     FixedProbability(
         size_t presynaptic_pop_size, size_t postsynaptic_pop_size, double connection_probability,
         parameters_generators::SynGen2ParamsType<SynapseType> syn_gen =
-            parameters_generators::default_synapse_gen<SynapseType>)
+            parameters_generators::default_synapse_gen<SynapseType>,
+        uint64_t seed = std::random_device()())
         : presynaptic_pop_size_(presynaptic_pop_size),
           postsynaptic_pop_size_(postsynaptic_pop_size),
           connection_probability_(connection_probability),
           syn_gen_(syn_gen),
-          mt_(std::random_device()()),
-          dist_(0, 1)
+          seed_(seed)
     {
         if (connection_probability > 1 || connection_probability < 0)
             throw std::logic_error("Incorrect probability, set probability between 0 and 1.");
@@ -186,25 +245,55 @@ public:
 
     /**
      * @brief Call operator.
+     * @details The method is thread-safe if the generator of synapse parameters is thread-safe.
      * @param index synapse index.
      * @return optional synapse parameters.
      */
-    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(size_t index)
+    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(
+        size_t index) const
     {
         const size_t index0 = index % presynaptic_pop_size_;
         const size_t index1 = index / presynaptic_pop_size_;
 
-        if (dist_(mt_) < connection_probability_) return std::make_tuple(syn_gen_(index0, index1), index0, index1);
+        IndexRandomEngine engine(seed_, index);
+        std::uniform_real_distribution<double> dist(0, 1);
+        if (dist(engine) < connection_probability_) return std::make_tuple(syn_gen_(index0, index1), index0, index1);
         return std::nullopt;
     }
 
+    /**
+     * @brief Generate synapses of a presynaptic neuron.
+     * @details Gaps between connected postsynaptic neurons are drawn from the geometric distribution, so the
+     * complexity is proportional to the number of generated synapses instead of the postsynaptic population size.
+     * Synapses have the same distribution as synapses made by the call operator, but not the same neurons. Synapses
+     * are appended in ascending order of postsynaptic neuron indexes, and the same synapses are appended each time the
+     * method is called with the same neuron index. The method is thread-safe if the generator of synapse parameters
+     * is thread-safe.
+     * @param presynaptic_index presynaptic neuron index.
+     * @param synapses vector to which synapses are appended.
+     */
+    void generate_presynaptic_synapses(
+        size_t presynaptic_index, std::vector<typename knp::core::Projection<SynapseType>::Synapse> &synapses) const
+    {
+        if (connection_probability_ <= 0) return;
+        IndexRandomEngine engine(seed_, presynaptic_index);
+        // Number of skipped neurons before the next connected one.
+        std::geometric_distribution<size_t> gap_dist(std::min(connection_probability_, 1.));
+        for (size_t index1 = 0;; ++index1)
+        {
+            const size_t gap = gap_dist(engine);
+            if (gap >= postsynaptic_pop_size_ - index1) break;
+            index1 += gap;
+            synapses.emplace_back(syn_gen_(presynaptic_index, index1), presynaptic_index, index1);
+        }
+    }
+
 private:
     size_t presynaptic_pop_size_;
     size_t postsynaptic_pop_size_;
     double connection_probability_;
     parameters_generators::SynGen2ParamsType<SynapseType> syn_gen_;
-    std::mt19937 mt_;
-    std::uniform_real_distribution<double> dist_;
+    uint64_t seed_;
 };
 
 
@@ -238,7 +327,7 @@ template <typename SynapseType>
 /**
  * @brief The FixedNumberPost class is a definition of a generator that makes connections between each presynaptic neuron 
  * and a fixed number of random postsynaptic neurons.
- * @details This connector uses MT19937 generator with uniform integer distribution.
+ * @details This connector uses IndexRandomEngine generator with uniform integer distribution.
  * @warning It doesn't get "real" populations and can't be used with populations that contain non-contiguous indexes.
  * @tparam SynapseType projection synapse type.
  */
@@ -251,28 +340,33 @@ public:
      * @param presynaptic_pop_size presynaptic population neuron count.
      * @param postsynaptic_pop_size postsynaptic population neuron count.
      * @param syn_gen generator of synapse parameters.
+     * @param seed random generator seed.
      */
     FixedNumberPost(
         size_t presynaptic_pop_size, size_t postsynaptic_pop_size,
         std::function<typename knp::core::Projection<SynapseType>::SynapseParameters(size_t index0, size_t index1)>
-            syn_gen = parameters_generators::default_synapse_gen<SynapseType>)
+            syn_gen = parameters_generators::default_synapse_gen<SynapseType>,
+        uint64_t seed = std::random_device()())
         : presynaptic_pop_size_(presynaptic_pop_size),
           postsynaptic_pop_size_(postsynaptic_pop_size),
           syn_gen_(syn_gen),
-          mt_(std::random_device()()),
-          dist_(0, postsynaptic_pop_size - 1)
+          seed_(seed)
     {
     }
 
     /**
      * @brief Call operator.
+     * @details The method is thread-safe if the generator of synapse parameters is thread-safe.
      * @param index synapse index.
      * @return optional synapse parameters.
      */
-    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(size_t index)
+    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(
+        size_t index) const
     {
+        IndexRandomEngine engine(seed_, index);
+        std::uniform_int_distribution<size_t> dist(0, postsynaptic_pop_size_ - 1);
         const size_t index0 = index % presynaptic_pop_size_;
-        const size_t index1 = dist_(mt_);
+        const size_t index1 = dist(engine);
 
         return std::make_tuple(syn_gen_(index0, index1), index0, index1);
     }
@@ -281,15 +375,14 @@ private:
     size_t presynaptic_pop_size_;
     size_t postsynaptic_pop_size_;
     parameters_generators::SynGen2ParamsType<SynapseType> syn_gen_;
-    std::mt19937 mt_;
-    std::uniform_int_distribution<size_t> dist_;
+    uint64_t seed_;
 };
 
 
 /**
  * @brief The FixedNumberPre class is a definition of a generator that makes connections between each postsynaptic neuron 
  * and a fixed number of random presynaptic neurons.
- * @details This uses MT19937 generator with uniform integer distribution.
+ * @details This uses IndexRandomEngine generator with uniform integer distribution.
  * @warning It doesn't get "real" populations and can't be used with populations that contain non-contiguous indexes.
  * @tparam SynapseType projection synapse type.
  */
@@ -302,27 +395,32 @@ public:
      * @param presynaptic_pop_size presynaptic population neuron count.
      * @param postsynaptic_pop_size postsynaptic population neuron count.
      * @param syn_gen generator of synapse parameters.
+     * @param seed random generator seed.
      */
     FixedNumberPre(
         size_t presynaptic_pop_size, size_t postsynaptic_pop_size,
         std::function<typename knp::core::Projection<SynapseType>::SynapseParameters(size_t index0, size_t index1)>
-            syn_gen = parameters_generators::default_synapse_gen<SynapseType>)
+            syn_gen = parameters_generators::default_synapse_gen<SynapseType>,
+        uint64_t seed = std::random_device()())
         : presynaptic_pop_size_(presynaptic_pop_size),
           postsynaptic_pop_size_(postsynaptic_pop_size),
           syn_gen_(syn_gen),
-          mt_(std::random_device()()),
-          dist_(0, presynaptic_pop_size - 1)
+          seed_(seed)
     {
     }
 
     /**
      * @brief Call operator.
+     * @details The method is thread-safe if the generator of synapse parameters is thread-safe.
      * @param index synapse index.
      * @return optional synapse parameters.
      */
-    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(size_t index)
+    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(
+        size_t index) const
     {
-        const size_t index0 = dist_(mt_);
+        IndexRandomEngine engine(seed_, index);
+        std::uniform_int_distribution<size_t> dist(0, presynaptic_pop_size_ - 1);
+        const size_t index0 = dist(engine);
         const size_t index1 = index % postsynaptic_pop_size_;
 
         return std::make_tuple(syn_gen_(index0, index1), index0, index1);
@@ -332,8 +430,7 @@ private:
     size_t presynaptic_pop_size_;
     size_t postsynaptic_pop_size_;
     parameters_generators::SynGen2ParamsType<SynapseType> syn_gen_;
-    std::mt19937 mt_;
-    std::uniform_int_distribution<size_t> dist_;
+    uint64_t seed_;
 };
 
 
@@ -364,6 +461,64 @@ template <typename DestinationSynapseType, typename SourceSynapseType>
     };
 }
 
+
+/**
+ * @brief Make procedural connectivity from a synapse generator.
+ * @details The synapse generator must map an iteration index to neurons as `all_to_all` does: presynaptic neuron index
+ * is `index % presynaptic_pop_size` and postsynaptic neuron index is `index / presynaptic_pop_size`. The generator
+ * must also return the same result each time it is called with the same index, as `all_to_all`, `index_based` and
+ * `FixedProbability` generators do. Synapses of a presynaptic neuron are generated in ascending order of postsynaptic
+ * neuron indexes.
+ * @note The generator is called for every pair of neurons. Use the `FixedProbability` overload for sparse
+ * connectivity.
+ * @param generator thread-safe synapse generator.
+ * @param presynaptic_pop_size presynaptic population neuron count.
+ * @param postsynaptic_pop_size postsynaptic population neuron count.
+ * @tparam SynapseType projection synapse type.
+ * @tparam Generator synapse generator type.
+ * @return procedural connectivity description.
+ */
+template <typename SynapseType, typename Generator>
+[[nodiscard]] typename knp::core::Projection<SynapseType>::ProceduralConnectivity procedural(
+    Generator generator, size_t presynaptic_pop_size, size_t postsynaptic_pop_size)
+{
+    return {
+        [generator = std::move(generator), presynaptic_pop_size, postsynaptic_pop_size](
+            size_t presynaptic_index, std::vector<typename knp::core::Projection<SynapseType>::Synapse> &synapses)
+        {
+            for (size_t postsynaptic_index = 0; postsynaptic_index < postsynaptic_pop_size; ++postsynaptic_index)
+            {
+                if (auto synapse = generator(presynaptic_index + postsynaptic_index * presynaptic_pop_size))
+                    synapses.emplace_back(std::move(synapse.value()));
+            }
+        },
+        presynaptic_pop_size};
+}
+
+
+/**
+ * @brief Make procedural connectivity from a generator of connections with some probability.
+ * @details Synapses of a presynaptic neuron are generated by `FixedProbability::generate_presynaptic_synapses()`, so
+ * only connected neurons are visited. Synapses have the same distribution as synapses made by the call operator of
+ * the generator, but not the same neurons.
+ * @param generator generator with a thread-safe generator of synapse parameters.
+ * @param presynaptic_pop_size presynaptic population neuron count.
+ * @param postsynaptic_pop_size postsynaptic population neuron count, which is defined by the generator.
+ * @tparam SynapseType projection synapse type.
+ * @return procedural connectivity description.
+ */
+template <typename SynapseType>
+[[nodiscard]] typename knp::core::Projection<SynapseType>::ProceduralConnectivity procedural(
+    FixedProbability<SynapseType> generator, size_t presynaptic_pop_size,
+    [[maybe_unused]] size_t postsynaptic_pop_size)
+{
+    return {
+        [generator = std::move(generator)](
+            size_t presynaptic_index, std::vector<typename knp::core::Projection<SynapseType>::Synapse> &synapses)
+        { generator.generate_presynaptic_synapses(presynaptic_index, synapses); },
+        presynaptic_pop_size};
+}
+
 }  // namespace synapse_generators
 
 }  // namespace knp::framework::projection
@@ -0,0 +1,221 @@
+/**
+ * @file mapped_synapse_file.cpp
+ * @brief Memory-mapped synapse file implementation.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knp/core/mapped_synapse_file.h>
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+
+namespace knp::core
+{
+
+namespace
+{
+constexpr std::array<char, 8> file_magic{'K', 'N', 'P', 'S', 'Y', 'N', '0', '1'};
+
+// Sections are aligned to a cache line.
+constexpr uint64_t section_alignment = 64;
+
+
+struct FileHeader
+{
+    std::array<char, 8> magic_;
+    uint64_t parameters_size_;
+    uint64_t index_size_;
+    uint64_t synapses_count_;
+    uint64_t rows_count_;
+    uint64_t parameters_offset_;
+    uint64_t source_neurons_offset_;
+    uint64_t target_neurons_offset_;
+    uint64_t row_offsets_offset_;
+    uint64_t synapse_indexes_offset_;
+    uint64_t file_size_;
+};
+
+
+uint64_t align_offset(uint64_t offset)
+{
+    return (offset + section_alignment - 1) / section_alignment * section_alignment;
+}
+
+
+// Header of a file with the given sizes, or no header if the file size doesn't fit into 64 bits.
+std::optional<FileHeader> make_header(uint64_t parameters_size, uint64_t synapses_count, uint64_t rows_count)
+{
+    // Sizes are checked before offsets are computed, so that corrupted counts can't wrap offsets around.
+    constexpr uint64_t max_size = std::numeric_limits<uint64_t>::max();
+    // Header and alignment padding of all sections.
+    constexpr uint64_t fixed_size = sizeof(FileHeader) + 5 * section_alignment;
+    if (parameters_size > max_size / 2 || rows_count > (max_size - fixed_size) / sizeof(uint64_t) - 1) return {};
+    const uint64_t rows_size = sizeof(uint64_t) * (rows_count + 1);
+    const uint64_t record_size = parameters_size + 2 * sizeof(uint32_t) + sizeof(size_t);
+    if (synapses_count > (max_size - fixed_size - rows_size) / record_size) return {};
+
+    FileHeader header{};
+    header.magic_ = file_magic;
+    header.parameters_size_ = parameters_size;
+    header.index_size_ = sizeof(size_t);
+    header.synapses_count_ = synapses_count;
+    header.rows_count_ = rows_count;
+    header.parameters_offset_ = align_offset(sizeof(FileHeader));
+    header.source_neurons_offset_ = align_offset(header.parameters_offset_ + parameters_size * synapses_count);
+    header.target_neurons_offset_ = align_offset(header.source_neurons_offset_ + sizeof(uint32_t) * synapses_count);
+    header.row_offsets_offset_ = align_offset(header.target_neurons_offset_ + sizeof(uint32_t) * synapses_count);
+    header.synapse_indexes_offset_ = align_offset(header.row_offsets_offset_ + rows_size);
+    header.file_size_ = header.synapse_indexes_offset_ + sizeof(size_t) * synapses_count;
+    return header;
+}
+
+
+void write_section(std::ofstream &stream, uint64_t offset, const void *data, size_t size)
+{
+    const auto position = static_cast<uint64_t>(stream.tellp());
+    const std::vector<char> padding(offset - position, 0);
+    stream.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    stream.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+}
+}  // namespace
+
+
+struct MappedSynapseFile::Mapping
+{
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+};
+
+
+MappedSynapseFile::MappedSynapseFile(const std::filesystem::path &path, size_t parameters_size) : path_(path)
+{
+    SPDLOG_DEBUG("Mapping synapse file \"{}\"...", path.string());
+    try
+    {
+        boost::interprocess::file_mapping file(path.string().c_str(), boost::interprocess::read_only);
+        boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+        mapping_ = std::make_unique<Mapping>(Mapping{std::move(file), std::move(region)});
+    }
+    catch (const boost::interprocess::interprocess_exception &exc)
+    {
+        throw std::runtime_error("Cannot map synapse file \"" + path.string() + "\": " + exc.what());
+    }
+
+    const auto *data = static_cast<const char *>(mapping_->region_.get_address());
+    const size_t file_size = mapping_->region_.get_size();
+    FileHeader header{};
+    if (file_size < sizeof(header)) throw std::runtime_error("Synapse file \"" + path.string() + "\" is too short.");
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic_ != file_magic || header.parameters_size_ != parameters_size ||
+        header.index_size_ != sizeof(size_t))
+    {
+        throw std::runtime_error("Synapse file \"" + path.string() + "\" has incompatible format.");
+    }
+    const auto expected_header = make_header(parameters_size, header.synapses_count_, header.rows_count_);
+    if (!expected_header || 0 != std::memcmp(&*expected_header, &header, sizeof(header)) ||
+        header.file_size_ > file_size)
+    {
+        throw std::runtime_error("Synapse file \"" + path.string() + "\" is corrupted.");
+    }
+
+    size_ = header.synapses_count_;
+    rows_count_ = header.rows_count_;
+    parameters_ = data + header.parameters_offset_;
+    source_neurons_ = reinterpret_cast<const uint32_t *>(data + header.source_neurons_offset_);
+    target_neurons_ = reinterpret_cast<const uint32_t *>(data + header.target_neurons_offset_);
+    row_offsets_ = reinterpret_cast<const uint64_t *>(data + header.row_offsets_offset_);
+    synapse_indexes_ = reinterpret_cast<const size_t *>(data + header.synapse_indexes_offset_);
+    if (!is_index_valid())
+    {
+        throw std::runtime_error("Synapse file \"" + path.string() + "\" is corrupted.");
+    }
+}
+
+
+bool MappedSynapseFile::is_index_valid() const
+{
+    // Index entries are used without bounds checks, so they are validated once, when the file is mapped.
+    if (0 != row_offsets_[0] || row_offsets_[rows_count_] != size_) return false;
+    for (size_t row = 0; row < rows_count_; ++row)
+    {
+        if (row_offsets_[row] > row_offsets_[row + 1]) return false;
+    }
+    for (size_t index = 0; index < size_; ++index)
+    {
+        if (synapse_indexes_[index] >= size_) return false;
+    }
+    return true;
+}
+
+
+MappedSynapseFile::~MappedSynapseFile() = default;
+
+
+void MappedSynapseFile::write(
+    const std::filesystem::path &path, size_t parameters_size, const void *parameters,
+    const std::vector<uint32_t> &source_neurons, const std::vector<uint32_t> &target_neurons,
+    const SynapseIndex &presynaptic_index)
+{
+    SPDLOG_DEBUG("Writing {} synapses to \"{}\"...", source_neurons.size(), path.string());
+    const size_t synapses_count = source_neurons.size();
+    const size_t rows_count = presynaptic_index.rows_count();
+
+    // Index rows can have free slots, so they are written one by one.
+    std::vector<uint64_t> row_offsets;
+    std::vector<size_t> synapse_indexes;
+    row_offsets.reserve(rows_count + 1);
+    synapse_indexes.reserve(synapses_count);
+    for (size_t row = 0; row < rows_count; ++row)
+    {
+        row_offsets.push_back(synapse_indexes.size());
+        const auto row_synapses = presynaptic_index.find(row);
+        synapse_indexes.insert(synapse_indexes.end(), row_synapses.begin(), row_synapses.end());
+    }
+    row_offsets.push_back(synapse_indexes.size());
+    if (synapse_indexes.size() != synapses_count || target_neurons.size() != synapses_count)
+    {
+        throw std::logic_error("Synapse index doesn't match synapses.");
+    }
+
+    const auto header = make_header(parameters_size, synapses_count, rows_count);
+    if (!header) throw std::runtime_error("Synapse file \"" + path.string() + "\" is too large.");
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) throw std::runtime_error("Cannot open synapse file \"" + path.string() + "\".");
+
+    write_section(stream, 0, &*header, sizeof(*header));
+    write_section(stream, header->parameters_offset_, parameters, parameters_size * synapses_count);
+    write_section(stream, header->source_neurons_offset_, source_neurons.data(), sizeof(uint32_t) * synapses_count);
+    write_section(stream, header->target_neurons_offset_, target_neurons.data(), sizeof(uint32_t) * synapses_count);
+    write_section(stream, header->row_offsets_offset_, row_offsets.data(), sizeof(uint64_t) * row_offsets.size());
+    write_section(stream, header->synapse_indexes_offset_, synapse_indexes.data(), sizeof(size_t) * synapses_count);
+    if (!stream) throw std::runtime_error("Cannot write synapse file \"" + path.string() + "\".");
+}
+
+}  // namespace knp::core
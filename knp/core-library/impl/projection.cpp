@@ -23,86 +23,101 @@
 
 #include <spdlog/spdlog.h>
 
-
-// Index functions.
-template <class Index, class Connection>
-void insert_to_index(Index &val, const Connection &connection)
-{
-    val.insert(connection);
-}
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 
-template <class Index, class Type>
-auto find_by_type(const Index &val, size_t neuron_index)
+/**
+ * @brief Remove marked elements in a single pass.
+ * @tparam T value type.
+ * @param data vector that will be modified by deletion.
+ * @param is_removed flags of the elements to remove.
+ */
+template <class T>
+void remove_marked(std::vector<T> &data, const std::vector<bool> &is_removed)
 {
-    return val.template get<Type>().equal_range(neuron_index);
+    size_t new_size = 0;
+    for (size_t index = 0; index < data.size(); ++index)
+    {
+        if (is_removed[index]) continue;
+        if (new_size != index) data[new_size] = std::move(data[index]);
+        ++new_size;
+    }
+    data.erase(data.begin() + static_cast<std::ptrdiff_t>(new_size), data.end());
 }
 
 
-template <class Index, class Type>
-std::vector<size_t> find_indexes_by_type(const Index &val, size_t neuron_index)
+namespace
 {
-    auto range = find_by_type<Index, Type>(val, neuron_index);
-    std::vector<size_t> res;
-    std::transform(range.first, range.second, std::back_inserter(res), [](const auto &val) { return val.index_; });
-    return res;
-}
-
-
-/**
- * @brief Remove a synapse with a given index.
- * @param index index of a synapse.
- * @return true if an element was found and erased.
- */
-template <class Index, class Projection>
-bool erase_synapse(Index &val, size_t index)
+// Synapse columns store neuron indexes in 32 bits.
+uint32_t to_column_index(size_t neuron_index)
 {
-    auto num_erased = val.template get<typename Projection::mi_synapse_index>().erase(index);
-    return num_erased > 0;
+    if (neuron_index > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::out_of_range(
+            "Neuron index " + std::to_string(neuron_index) + " doesn't fit into a 32-bit synapse column.");
+    }
+    return static_cast<uint32_t>(neuron_index);
 }
+}  // namespace
 
 
 /**
- * @brief Remove elements by their indexes in a single pass.
- * @tparam T value type.
- * @param data vector that will be modified by deletion.
- * @param to_remove indexes of the elements to remove
- * @warning Indexes must be sorted.
+ * @brief Run a synapse generator in several threads.
+ * @tparam Synapse synapse type.
+ * @tparam Generator synapse generator type.
+ * @param generator thread-safe synapse generator.
+ * @param num_iterations number of iterations to run the synapse generator.
+ * @param thread_count number of threads.
+ * @return generated synapses of each thread range in the iteration order.
  */
-template <class T, class IndexContainer>
-void remove_by_index(std::vector<T> &data, const IndexContainer &to_remove)
+template <class Synapse, class Generator>
+std::vector<std::vector<Synapse>> generate_in_parallel(
+    const Generator &generator, size_t num_iterations, size_t thread_count)
 {
-    if (to_remove.empty()) return;
+    std::vector<std::vector<Synapse>> chunks(thread_count);
+    std::vector<std::exception_ptr> errors(thread_count);
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
 
-    size_t cor_counter = 0;
-    for (const auto rem_index : to_remove)
+    for (size_t thread_index = 0; thread_index < thread_count; ++thread_index)
     {
-        data.erase(std::next(data.begin(), rem_index - cor_counter++));
+        threads.emplace_back(
+            [&generator, &chunks, &errors, thread_index, num_iterations, thread_count]()
+            {
+                try
+                {
+                    const size_t range_end = num_iterations * (thread_index + 1) / thread_count;
+                    for (size_t i = num_iterations * thread_index / thread_count; i < range_end; ++i)
+                    {
+                        if (auto synapse = generator(i)) chunks[thread_index].emplace_back(std::move(synapse.value()));
+                    }
+                }
+                catch (...)
+                {
+                    errors[thread_index] = std::current_exception();
+                }
+            });
     }
+    for (auto &thread : threads) thread.join();
 
-    // Cool but incorrect (MSVC\14.40.33807\include\vector(56) : Assertion failed: can't dereference out of range vector
-    // iterator):
-    // size_t removed = 0;
-    // auto next_to_remove = to_remove.begin();
-    // size_t index = *next_to_remove;
-    // while (index + removed < data.size())
-    //{
-    //    while (index + removed == *next_to_remove)
-    //    {
-    //        ++next_to_remove;
-    //        ++removed;
-    //    }
-    //    data[index] = std::move(data[index + removed]);
-    //    ++index;
-    //}
-    // data.resize(data.size() - removed);
+    for (const auto &error : errors)
+    {
+        if (error) std::rethrow_exception(error);
+    }
+    return chunks;
 }
 
 
 namespace knp::core
 {
-using Connection = typename std::tuple<size_t, size_t, size_t>;
-
 
 template <typename SynapseType>
 Projection<SynapseType>::Projection(UID presynaptic_uid, UID postsynaptic_uid)  //!OCLINT(Parameters used)
@@ -165,26 +180,390 @@ Projection<SynapseType>::Projection(
 }
 
 
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID presynaptic_uid, UID postsynaptic_uid, SynapseGenerator generator,  //!OCLINT(Parameters used)
+    size_t num_iterations, ParallelGeneration parallel_generation)          //!OCLINT(Parameters used)
+    : Projection(UID{}, presynaptic_uid, postsynaptic_uid, std::move(generator), num_iterations, parallel_generation)
+{
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID uid, UID presynaptic_uid, UID postsynaptic_uid, SynapseGenerator generator,  //!OCLINT(Parameters used)
+    size_t num_iterations, ParallelGeneration parallel_generation)                   //!OCLINT(Parameters used)
+    : base_{uid}, presynaptic_uid_(presynaptic_uid), postsynaptic_uid_(postsynaptic_uid)
+{
+    SPDLOG_DEBUG(
+        "Creating projection with UID = {}, presynaptic UID = {}, postsynaptic UID = {}, i = {}...",
+        std::string(get_uid()), std::string(presynaptic_uid_), std::string(postsynaptic_uid_), num_iterations);
+    add_synapses(std::move(generator), num_iterations, parallel_generation);
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID presynaptic_uid, UID postsynaptic_uid, ProceduralConnectivity connectivity)  //!OCLINT(Parameters used)
+    : Projection(UID{}, presynaptic_uid, postsynaptic_uid, std::move(connectivity))
+{
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID uid, UID presynaptic_uid, UID postsynaptic_uid,  //!OCLINT(Parameters used)
+    ProceduralConnectivity connectivity)                 //!OCLINT(Parameters used)
+    : base_{uid}, presynaptic_uid_(presynaptic_uid), postsynaptic_uid_(postsynaptic_uid)
+{
+    SPDLOG_DEBUG(
+        "Creating procedural projection with UID = {}, presynaptic UID = {}, postsynaptic UID = {}, n = {}...",
+        std::string(get_uid()), std::string(presynaptic_uid_), std::string(postsynaptic_uid_),
+        connectivity.presynaptic_size_);
+    set_procedural(std::move(connectivity));
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID presynaptic_uid, UID postsynaptic_uid, Convolution convolution)  //!OCLINT(Parameters used)
+    : Projection(UID{}, presynaptic_uid, postsynaptic_uid, std::move(convolution))
+{
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID uid, UID presynaptic_uid, UID postsynaptic_uid, Convolution convolution)  //!OCLINT(Parameters used)
+    : base_{uid}, presynaptic_uid_(presynaptic_uid), postsynaptic_uid_(postsynaptic_uid)
+{
+    SPDLOG_DEBUG(
+        "Creating convolutional projection with UID = {}, presynaptic UID = {}, postsynaptic UID = {}...",
+        std::string(get_uid()), std::string(presynaptic_uid_), std::string(postsynaptic_uid_));
+    if (!convolution.stride_ || !convolution.kernel_width_ || !convolution.kernel_height_ ||
+        convolution.kernel_width_ > convolution.input_width_ || convolution.kernel_height_ > convolution.input_height_)
+    {
+        throw std::logic_error("Incorrect convolution geometry.");
+    }
+    if (convolution.kernel_.size() != convolution.output_channels_ * convolution.input_channels_ *
+                                          convolution.kernel_height_ * convolution.kernel_width_)
+    {
+        throw std::logic_error("Convolution kernel size doesn't match its geometry.");
+    }
+
+    auto shared_convolution = std::make_shared<const Convolution>(std::move(convolution));
+    const size_t presynaptic_size =
+        shared_convolution->input_width_ * shared_convolution->input_height_ * shared_convolution->input_channels_;
+    set_procedural(
+        {[shared_convolution](size_t neuron_index, std::vector<Synapse> &synapses)
+         {
+             shared_convolution->for_each_synapse(
+                 neuron_index, [neuron_index, &synapses](const SynapseParameters &parameters, size_t target_index)
+                 { synapses.emplace_back(parameters, neuron_index, target_index); });
+         },
+         presynaptic_size});
+    convolution_ = std::move(shared_convolution);
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID presynaptic_uid, UID postsynaptic_uid, const MappedSynapses &mapped_synapses)  //!OCLINT(Parameters used)
+    : Projection(UID{}, presynaptic_uid, postsynaptic_uid, mapped_synapses)
+{
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID uid, UID presynaptic_uid, UID postsynaptic_uid,  //!OCLINT(Parameters used)
+    const MappedSynapses &mapped_synapses)               //!OCLINT(Parameters used)
+    : base_{uid},
+      presynaptic_uid_(presynaptic_uid),
+      postsynaptic_uid_(postsynaptic_uid),
+      mapped_(std::make_shared<const MappedSynapseFile>(mapped_synapses.path_, sizeof(SynapseParameters)))
+{
+    SPDLOG_DEBUG(
+        "Creating mapped projection with UID = {}, presynaptic UID = {}, postsynaptic UID = {}, file = {}...",
+        std::string(get_uid()), std::string(presynaptic_uid_), std::string(postsynaptic_uid_),
+        mapped_synapses.path_.string());
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID presynaptic_uid, UID postsynaptic_uid, QuantizedSynapses synapses)  //!OCLINT(Parameters used)
+    : Projection(UID{}, presynaptic_uid, postsynaptic_uid, std::move(synapses))
+{
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType>::Projection(
+    UID uid, UID presynaptic_uid, UID postsynaptic_uid, QuantizedSynapses synapses)  //!OCLINT(Parameters used)
+    : base_{uid}, presynaptic_uid_(presynaptic_uid), postsynaptic_uid_(postsynaptic_uid)
+{
+    SPDLOG_DEBUG(
+        "Creating quantized projection with UID = {}, presynaptic UID = {}, postsynaptic UID = {}, n = {}...",
+        std::string(get_uid()), std::string(presynaptic_uid_), std::string(postsynaptic_uid_), synapses.size());
+    if constexpr (!std::is_same_v<SynapseType, synapse_traits::DeltaSynapse>)
+    {
+        throw std::logic_error("Weight quantization is supported only for delta synapses.");
+    }
+    else
+    {
+        const size_t weights_count = WeightQuantization::int8 == synapses.quantization_
+                                         ? synapses.int8_weights_.size()
+                                         : synapses.float16_weights_.size();
+        if (WeightQuantization::none == synapses.quantization_ || weights_count != synapses.size() ||
+            synapses.delays_.size() != synapses.size() || synapses.output_types_.size() != synapses.size() ||
+            synapses.target_neurons_.size() != synapses.size())
+        {
+            throw std::logic_error("Quantized synapse arrays don't match.");
+        }
+        quantized_ = std::make_shared<const QuantizedSynapses>(std::move(synapses));
+        is_synapses_updated_ = false;
+    }
+}
+
+
+template <typename SynapseType>
+void Projection<SynapseType>::quantize_weights(WeightQuantization quantization)
+{
+    if (WeightQuantization::none == quantization)
+    {
+        materialize();
+        return;
+    }
+
+    if constexpr (!std::is_same_v<SynapseType, synapse_traits::DeltaSynapse>)
+    {
+        throw std::logic_error("Weight quantization is supported only for delta synapses.");
+    }
+    else
+    {
+        if (!is_locked_)
+        {
+            throw std::logic_error("Weights of an unlocked projection can't be quantized.");
+        }
+
+        SPDLOG_TRACE("Quantizing weights of projection {}...", std::string(get_uid()));
+        if (mapped_) materialize();
+        const auto &columns = get_synapse_columns();
+        QuantizedSynapses synapses;
+        synapses.quantization_ = quantization;
+        synapses.source_neurons_ = columns.source_neurons_;
+        synapses.target_neurons_ = columns.target_neurons_;
+        synapses.delays_.reserve(columns.size());
+        synapses.output_types_.reserve(columns.size());
+        for (const auto &parameters : columns.parameters_)
+        {
+            synapses.delays_.push_back(parameters.delay_);
+            synapses.output_types_.push_back(static_cast<uint8_t>(parameters.output_type_));
+        }
+
+        if (WeightQuantization::int8 == quantization)
+        {
+            float max_weight = 0;
+            for (const auto &parameters : columns.parameters_)
+            {
+                max_weight = std::max(max_weight, std::abs(parameters.weight_));
+            }
+            synapses.scale_ = max_weight > 0 ? max_weight / 127 : 1;
+            synapses.int8_weights_.reserve(columns.size());
+            for (const auto &parameters : columns.parameters_)
+            {
+                synapses.int8_weights_.push_back(
+                    static_cast<int8_t>(std::clamp(std::lround(parameters.weight_ / synapses.scale_), -127L, 127L)));
+            }
+        }
+        else
+        {
+            synapses.float16_weights_.reserve(columns.size());
+            for (const auto &parameters : columns.parameters_)
+            {
+                synapses.float16_weights_.push_back(float_to_float16(parameters.weight_));
+            }
+        }
+
+        quantized_ = std::make_shared<const QuantizedSynapses>(std::move(synapses));
+        parameters_ = std::vector<Synapse>{};
+        columns_ = SynapseColumns{};
+        is_synapses_updated_ = false;
+        is_columns_updated_ = false;
+    }
+}
+
+
+template <typename SynapseType>
+void Projection<SynapseType>::save_mapped(const std::filesystem::path &path) const
+{
+    if constexpr (!std::is_trivially_copyable_v<SynapseParameters>)
+    {
+        throw std::logic_error("Synapse parameters can't be saved to a mapped file.");
+    }
+    else
+    {
+        if (mapped_)
+        {
+            // Synapses of a mapped projection are already in the file format.
+            std::error_code error;
+            if (std::filesystem::equivalent(mapped_->get_path(), path, error)) return;
+            if (!std::filesystem::copy_file(
+                    mapped_->get_path(), path, std::filesystem::copy_options::overwrite_existing, error))
+            {
+                throw std::runtime_error("Cannot write synapse file \"" + path.string() + "\".");
+            }
+            return;
+        }
+        const auto &columns = get_synapse_columns();
+        reindex();
+        MappedSynapseFile::write(
+            path, sizeof(SynapseParameters), columns.parameters_.data(), columns.source_neurons_,
+            columns.target_neurons_, presynaptic_index_);
+    }
+}
+
+
+template <typename SynapseType>
+size_t Projection<SynapseType>::get_procedural_synapse_index(size_t neuron_index) const
+{
+    if (!procedural_)
+    {
+        throw std::logic_error("Projection is not procedural.");
+    }
+    return procedural_offsets_[std::min(neuron_index, procedural_->presynaptic_size_)];
+}
+
+
+template <typename SynapseType>
+size_t Projection<SynapseType>::generate_presynaptic_synapses(
+    size_t neuron_index, std::vector<Synapse> &synapses) const  //!OCLINT(Parameters used)
+{
+    const size_t synapse_index = get_procedural_synapse_index(neuron_index);
+    synapses.clear();
+    if (neuron_index < procedural_->presynaptic_size_)
+    {
+        procedural_->generator_(neuron_index, synapses);
+    }
+    return synapse_index;
+}
+
+
+template <typename SynapseType>
+void Projection<SynapseType>::set_procedural(ProceduralConnectivity connectivity)
+{
+    procedural_ = std::move(connectivity);
+    // Offsets define synapse indexes, so that impacts of a procedural projection have the same synapse indexes as
+    // impacts of the materialized one.
+    procedural_offsets_.reserve(procedural_->presynaptic_size_ + 1);
+    procedural_offsets_.push_back(0);
+    std::vector<Synapse> synapses;
+    for (size_t neuron_index = 0; neuron_index < procedural_->presynaptic_size_; ++neuron_index)
+    {
+        synapses.clear();
+        procedural_->generator_(neuron_index, synapses);
+        procedural_offsets_.push_back(procedural_offsets_.back() + synapses.size());
+    }
+}
+
+
+template <typename SynapseType>
+void Projection<SynapseType>::materialize()
+{
+    if (procedural_)
+    {
+        // Synapses are generated in the order of their indexes, so the index remains valid.
+        parameters_.clear();
+        parameters_.reserve(procedural_offsets_.back());
+        std::vector<Synapse> synapses;
+        for (size_t neuron_index = 0; neuron_index < procedural_->presynaptic_size_; ++neuron_index)
+        {
+            generate_presynaptic_synapses(neuron_index, synapses);
+            parameters_.insert(
+                parameters_.end(), std::make_move_iterator(synapses.begin()), std::make_move_iterator(synapses.end()));
+        }
+        procedural_.reset();
+        procedural_offsets_ = std::vector<size_t>{};
+        convolution_.reset();
+        is_synapses_updated_ = true;
+        is_columns_updated_ = false;
+        // Procedural projection has no presynaptic index, so the index is rebuilt.
+        is_index_updated_ = false;
+    }
+    else if (mapped_)
+    {
+        const auto *mapped_parameters = mapped_->get_parameters<SynapseParameters>();
+        const auto *source_neurons = mapped_->get_source_neurons();
+        const auto *target_neurons = mapped_->get_target_neurons();
+        parameters_.clear();
+        parameters_.reserve(mapped_->size());
+        for (size_t i = 0; i < mapped_->size(); ++i)
+        {
+            parameters_.emplace_back(mapped_parameters[i], source_neurons[i], target_neurons[i]);
+        }
+        mapped_.reset();
+        is_synapses_updated_ = true;
+        is_columns_updated_ = false;
+        // Presynaptic index of a mapped projection is kept in the file, so the index is rebuilt.
+        is_index_updated_ = false;
+    }
+    else if (quantized_)
+    {
+        get_synapses();
+    }
+    else
+    {
+        return;
+    }
+    update_storage();
+}
+
+
 template <typename SynapseType>
 std::vector<size_t> knp::core::Projection<SynapseType>::find_synapses(
     size_t neuron_id, Search search_criterion) const  //!OCLINT(Parameters used)
 {
-    reindex();
-    std::vector<size_t> res;
+    SynapseIndex::Range range;
     switch (search_criterion)
     {
         case Search::by_postsynaptic:
-            res = find_indexes_by_type<decltype(index_), core::Projection<SynapseType>::ByPostsynaptic>(
-                index_, neuron_id);
+            range = get_postsynaptic_synapses(neuron_id);
             break;
         case Search::by_presynaptic:
-            res =
-                find_indexes_by_type<decltype(index_), core::Projection<SynapseType>::ByPresynaptic>(index_, neuron_id);
+            range = get_presynaptic_synapses(neuron_id);
             break;
         default:
             return {};
     }
-    return res;
+    return std::vector<size_t>(range.begin(), range.end());
+}
+
+
+template <typename SynapseType>
+SynapseIndex::Range knp::core::Projection<SynapseType>::get_presynaptic_synapses(size_t neuron_index) const
+{
+    if (procedural_)
+    {
+        // Synapses of a presynaptic neuron of a procedural projection are numbered consecutively.
+        if (neuron_index >= procedural_->presynaptic_size_) return {};
+        return SynapseIndex::Range::make_sequence(
+            procedural_offsets_[neuron_index], procedural_offsets_[neuron_index + 1]);
+    }
+    if (mapped_)
+    {
+        return mapped_->find_presynaptic(neuron_index);
+    }
+    reindex();
+    return presynaptic_index_.find(neuron_index);
+}
+
+
+template <typename SynapseType>
+SynapseIndex::Range knp::core::Projection<SynapseType>::get_postsynaptic_synapses(size_t neuron_index) const
+{
+    reindex();
+    return postsynaptic_index_.find(neuron_index);
 }
 
 
@@ -192,88 +571,383 @@ template <typename SynapseType>
 size_t knp::core::Projection<SynapseType>::add_synapses(
     SynapseGenerator generator, size_t num_iterations)  //!OCLINT(Parameters used)
 {
-    const size_t starting_size = parameters_.size();
-    is_index_updated_ = false;
+    materialize();
+    // Index is updated in place instead of being rebuilt.
+    auto append_to_index = [this](size_t synapse_index, size_t source_neuron, size_t target_neuron)
+    {
+        if (!is_index_updated_) return;
+        presynaptic_index_.append(synapse_index, source_neuron);
+        postsynaptic_index_.append(synapse_index, target_neuron);
+    };
+
+    if (SynapseStorage::structure_of_arrays == storage_ && !procedural_ && !mapped_ && !quantized_ &&
+        !is_synapses_updated_ && is_columns_updated_)
+    {
+        // Synapses are appended to the columns, so that the array of synapses isn't rebuilt.
+        const size_t starting_size = columns_.size();
+        for (size_t i = 0; i < num_iterations; ++i)
+        {
+            if (auto data = generator(i))
+            {
+                const auto source_neuron = to_column_index(std::get<knp::core::source_neuron_id>(*data));
+                const auto target_neuron = to_column_index(std::get<knp::core::target_neuron_id>(*data));
+                columns_.parameters_.push_back(std::move(std::get<knp::core::synapse_data>(*data)));
+                columns_.source_neurons_.push_back(source_neuron);
+                columns_.target_neurons_.push_back(target_neuron);
+                append_to_index(columns_.size() - 1, source_neuron, target_neuron);
+            }
+        }
+        return columns_.size() - starting_size;
+    }
+
+    auto &synapses = get_synapses();
+    const size_t starting_size = synapses.size();
     for (size_t i = 0; i < num_iterations; ++i)
     {
         if (auto data = generator(i))
         {
-            parameters_.emplace_back(std::move(data.value()));
+            synapses.emplace_back(std::move(data.value()));
+            const auto &synapse = synapses.back();
+            append_to_index(
+                synapses.size() - 1, std::get<knp::core::source_neuron_id>(synapse),
+                std::get<knp::core::target_neuron_id>(synapse));
         }
     }
-    return parameters_.size() - starting_size;
+    const size_t added_count = synapses.size() - starting_size;
+    update_storage();
+    return added_count;
+}
+
+
+template <typename SynapseType>
+size_t knp::core::Projection<SynapseType>::add_synapses(
+    SynapseGenerator generator, size_t num_iterations,  //!OCLINT(Parameters used)
+    ParallelGeneration parallel_generation)             //!OCLINT(Parameters used)
+{
+    const size_t thread_count = std::max<size_t>(
+        1, std::min<size_t>(
+               parallel_generation.thread_count_ ? parallel_generation.thread_count_
+                                                 : std::thread::hardware_concurrency(),
+               num_iterations));
+    SPDLOG_TRACE("Generating {} synapses in {} threads...", num_iterations, thread_count);
+
+    auto chunks = generate_in_parallel<Synapse>(generator, num_iterations, thread_count);
+    materialize();
+    auto &synapses = get_synapses();
+    const size_t starting_size = synapses.size();
+    size_t added_count = 0;
+    for (const auto &chunk : chunks) added_count += chunk.size();
+
+    synapses.reserve(starting_size + added_count);
+    for (auto &chunk : chunks)
+    {
+        synapses.insert(synapses.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+        chunk = std::vector<Synapse>{};
+    }
+
+    // The whole index is rebuilt in parallel, which is faster than appending synapses one by one.
+    is_index_updated_ = false;
+    reindex(thread_count);
+    update_storage();
+    return added_count;
 }
 
 
 template <typename SynapseType>
 void Projection<SynapseType>::clear()
 {
+    procedural_.reset();
+    procedural_offsets_.clear();
+    convolution_.reset();
+    mapped_.reset();
+    quantized_.reset();
     parameters_.clear();
-    index_.clear();
+    columns_ = SynapseColumns{};
+    is_synapses_updated_ = true;
+    is_columns_updated_ = false;
+    presynaptic_index_.clear();
+    postsynaptic_index_.clear();
+    is_index_updated_ = true;
+    update_storage();
+}
+
+
+template <typename SynapseType>
+void Projection<SynapseType>::set_storage(SynapseStorage storage)
+{
+    storage_ = storage;
+    if (procedural_ || mapped_ || quantized_)
+    {
+        // Storage type is applied when synapses are materialized.
+        return;
+    }
+    if (SynapseStorage::array_of_structures == storage_)
+    {
+        get_synapses();
+        columns_ = SynapseColumns{};
+        is_columns_updated_ = false;
+        return;
+    }
+    update_storage();
+}
+
+
+template <typename SynapseType>
+const typename Projection<SynapseType>::SynapseColumns &Projection<SynapseType>::get_synapse_columns() const
+{
+    if (is_columns_updated_)
+    {
+        return columns_;
+    }
+
+    const auto &synapses = get_synapses();
+    columns_.parameters_.clear();
+    columns_.source_neurons_.clear();
+    columns_.target_neurons_.clear();
+    columns_.parameters_.reserve(synapses.size());
+    columns_.source_neurons_.reserve(synapses.size());
+    columns_.target_neurons_.reserve(synapses.size());
+    for (const auto &synapse : synapses)
+    {
+        columns_.parameters_.push_back(std::get<core::synapse_data>(synapse));
+        columns_.source_neurons_.push_back(to_column_index(std::get<core::source_neuron_id>(synapse)));
+        columns_.target_neurons_.push_back(to_column_index(std::get<core::target_neuron_id>(synapse)));
+    }
+    is_columns_updated_ = true;
+    return columns_;
+}
+
+
+template <typename SynapseType>
+const std::vector<typename Projection<SynapseType>::Synapse> &Projection<SynapseType>::get_synapses() const
+{
+    if (procedural_)
+    {
+        throw std::logic_error("Synapses of a procedural projection are not stored, call materialize() to store them.");
+    }
+
+    if (mapped_)
+    {
+        throw std::logic_error("Synapses of a mapped projection are not stored, call materialize() to store them.");
+    }
+
+    if (quantized_)
+    {
+        // Dequantized synapses are cached, while quantized synapses are kept until synapses are modified.
+        if (is_synapses_updated_)
+        {
+            return parameters_;
+        }
+        if constexpr (std::is_same_v<SynapseType, synapse_traits::DeltaSynapse>)
+        {
+            parameters_.clear();
+            parameters_.reserve(quantized_->size());
+            for (size_t i = 0; i < quantized_->size(); ++i)
+            {
+                parameters_.emplace_back(
+                    quantized_->get_parameters(i), quantized_->source_neurons_[i], quantized_->target_neurons_[i]);
+            }
+        }
+        is_synapses_updated_ = true;
+        return parameters_;
+    }
+
+    if (is_synapses_updated_)
+    {
+        return parameters_;
+    }
+
+    parameters_.clear();
+    parameters_.reserve(columns_.size());
+    for (size_t i = 0; i < columns_.size(); ++i)
+    {
+        parameters_.emplace_back(columns_.parameters_[i], columns_.source_neurons_[i], columns_.target_neurons_[i]);
+    }
+    is_synapses_updated_ = true;
+    return parameters_;
+}
+
+
+template <typename SynapseType>
+std::vector<typename Projection<SynapseType>::Synapse> &Projection<SynapseType>::get_synapses()
+{
+    std::as_const(*this).get_synapses();
+    // Synapses can be modified through the returned reference. Synapse order is kept, so the index remains valid.
+    quantized_.reset();
+    is_columns_updated_ = false;
+    return parameters_;
+}
+
+
+template <typename SynapseType>
+void Projection<SynapseType>::update_storage()
+{
+    if (SynapseStorage::structure_of_arrays != storage_ || procedural_ || mapped_ || quantized_)
+    {
+        return;
+    }
+
+    (void)get_synapse_columns();
+    parameters_ = std::vector<Synapse>{};
+    is_synapses_updated_ = false;
 }
 
 
 template <typename SynapseType>
 void knp::core::Projection<SynapseType>::remove_synapse(size_t index)  //!OCLINT
 {
-    is_index_updated_ = false;
-    parameters_.erase(parameters_.begin() + index);
+    std::vector<bool> is_removed(size(), false);
+    is_removed[index] = true;
+    remove_marked_synapses(is_removed);
+}
+
+
+template <typename SynapseType>
+size_t knp::core::Projection<SynapseType>::remove_synapses(const std::vector<size_t> &synapse_indexes)  //!OCLINT
+{
+    std::vector<bool> is_removed(size(), false);
+    for (const auto synapse_index : synapse_indexes) is_removed[synapse_index] = true;
+    return remove_marked_synapses(is_removed);
 }
 
 
 template <typename SynapseType>
 size_t knp::core::Projection<SynapseType>::remove_synapse_if(std::function<bool(const Synapse &)> predicate)  //!OCLINT
 {
-    const size_t starting_size = parameters_.size();
-    is_index_updated_ = false;
-    parameters_.resize(std::remove_if(parameters_.begin(), parameters_.end(), predicate) - parameters_.begin());
-    return starting_size - parameters_.size();
+    materialize();
+    const auto &synapses = std::as_const(*this).get_synapses();
+    std::vector<bool> is_removed(synapses.size(), false);
+    for (size_t synapse_index = 0; synapse_index < synapses.size(); ++synapse_index)
+    {
+        is_removed[synapse_index] = predicate(synapses[synapse_index]);
+    }
+    return remove_marked_synapses(is_removed);
 }
 
 
 template <typename SynapseType>
 size_t knp::core::Projection<SynapseType>::remove_postsynaptic_neuron_synapses(size_t neuron_index)  //!OCLINT
 {
-    const size_t starting_size = parameters_.size();
-    bool was_index_updated = is_index_updated_;
-    // Basic exception safety.
-    is_index_updated_ = false;
-    auto synapses_to_remove = find_synapses(neuron_index, Search::by_postsynaptic);
-    std::sort(synapses_to_remove.begin(), synapses_to_remove.end());
-    remove_by_index(parameters_, synapses_to_remove);
-    if (was_index_updated)
-        for (auto &synapse : synapses_to_remove) index_.erase(synapse);
-
-    is_index_updated_ = was_index_updated;
-    return starting_size - parameters_.size();
+    std::vector<bool> is_removed(size(), false);
+    for (const auto synapse_index : get_postsynaptic_synapses(neuron_index)) is_removed[synapse_index] = true;
+    return remove_marked_synapses(is_removed);
 }
 
 
 template <typename SynapseType>
 size_t knp::core::Projection<SynapseType>::remove_presynaptic_neuron_synapses(size_t neuron_index)  //!OCLINT
 {
-    // TODO: We now have a way to find them quickly, make use of it instead of disconnect_if.
-    return remove_synapse_if([neuron_index](const Synapse &synapse)
-                             { return std::get<knp::core::source_neuron_id>(synapse) == neuron_index; });
+    std::vector<bool> is_removed(size(), false);
+    for (const auto synapse_index : get_presynaptic_synapses(neuron_index)) is_removed[synapse_index] = true;
+    return remove_marked_synapses(is_removed);
 }
 
 
 template <typename SynapseType>
-void knp::core::Projection<SynapseType>::reindex() const
+size_t knp::core::Projection<SynapseType>::remove_marked_synapses(const std::vector<bool> &is_removed)
+{
+    materialize();
+
+    // New synapse indexes are used to update the index without rebuilding it.
+    std::vector<size_t> new_indexes(is_removed.size());
+    size_t new_size = 0;
+    for (size_t synapse_index = 0; synapse_index < is_removed.size(); ++synapse_index)
+    {
+        new_indexes[synapse_index] = is_removed[synapse_index] ? SynapseIndex::removed_synapse : new_size++;
+    }
+
+    const size_t removed_count = is_removed.size() - new_size;
+    if (0 == removed_count)
+    {
+        return 0;
+    }
+
+    if (is_synapses_updated_)
+    {
+        remove_marked(parameters_, is_removed);
+    }
+    if (is_columns_updated_)
+    {
+        remove_marked(columns_.parameters_, is_removed);
+        remove_marked(columns_.source_neurons_, is_removed);
+        remove_marked(columns_.target_neurons_, is_removed);
+    }
+    if (is_index_updated_)
+    {
+        presynaptic_index_.remap(new_indexes);
+        postsynaptic_index_.remap(new_indexes);
+    }
+    update_storage();
+    return removed_count;
+}
+
+
+template <typename SynapseType>
+void knp::core::Projection<SynapseType>::reindex(size_t thread_count) const
 {
     if (is_index_updated_)
     {
         return;
     }
 
-    index_.clear();
-    for (size_t i = 0; i < parameters_.size(); ++i)
+    if (procedural_)
+    {
+        // Presynaptic lookups of a procedural projection use synapse offsets, so only the postsynaptic index is
+        // built. It is built only when postsynaptic synapses are requested, by regenerating synapses.
+        std::vector<size_t> target_neurons;
+        target_neurons.reserve(size());
+        std::vector<Synapse> synapses;
+        for (size_t neuron_index = 0; neuron_index < procedural_->presynaptic_size_; ++neuron_index)
+        {
+            generate_presynaptic_synapses(neuron_index, synapses);
+            for (const auto &synapse : synapses)
+            {
+                target_neurons.push_back(std::get<knp::core::target_neuron_id>(synapse));
+            }
+        }
+        presynaptic_index_.clear();
+        postsynaptic_index_.build(
+            target_neurons.size(), [&target_neurons](size_t synapse_index) { return target_neurons[synapse_index]; },
+            thread_count);
+    }
+    else if (mapped_)
+    {
+        // Presynaptic index of a mapped projection is stored in the file.
+        presynaptic_index_.clear();
+        postsynaptic_index_.build(
+            mapped_->size(), [this](size_t synapse_index) { return mapped_->get_target_neurons()[synapse_index]; },
+            thread_count);
+    }
+    else if (quantized_)
+    {
+        presynaptic_index_.build(
+            quantized_->size(), [this](size_t synapse_index) { return quantized_->source_neurons_[synapse_index]; },
+            thread_count);
+        postsynaptic_index_.build(
+            quantized_->size(), [this](size_t synapse_index) { return quantized_->target_neurons_[synapse_index]; },
+            thread_count);
+    }
+    else if (is_synapses_updated_)
+    {
+        presynaptic_index_.build(
+            parameters_.size(),
+            [this](size_t synapse_index)
+            { return std::get<knp::core::source_neuron_id>(parameters_[synapse_index]); },
+            thread_count);
+        postsynaptic_index_.build(
+            parameters_.size(),
+            [this](size_t synapse_index)
+            { return std::get<knp::core::target_neuron_id>(parameters_[synapse_index]); },
+            thread_count);
+    }
+    else
     {
-        auto &synapse = parameters_[i];
-        insert_to_index(
-            index_,
-            Connection{
-                std::get<knp::core::source_neuron_id>(synapse), std::get<knp::core::target_neuron_id>(synapse), i});
+        presynaptic_index_.build(
+            columns_.size(), [this](size_t synapse_index) { return columns_.source_neurons_[synapse_index]; },
+            thread_count);
+        postsynaptic_index_.build(
+            columns_.size(), [this](size_t synapse_index) { return columns_.target_neurons_[synapse_index]; },
+            thread_count);
     }
     is_index_updated_ = true;
 }
@@ -0,0 +1,276 @@
+/**
+ * @file blifat_active_set.h
+ * @brief Set of BLIFAT neurons that are updated on each step.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief Set of BLIFAT neurons that are updated on each step.
+ * @details A neuron that cannot spike without synaptic inputs is put to sleep and is not updated by kernels. Decay of
+ * a sleeping neuron is applied in closed form when it receives a synaptic input or when neurons of the population are
+ * synchronized. Closed-form decay can differ from step-by-step decay in the last bits.
+ */
+class BLIFATActiveSet
+{
+public:
+    /**
+     * @brief Make all neurons active.
+     * @param neurons_count number of population neurons.
+     */
+    void reset(size_t neurons_count)
+    {
+        active_neurons_.resize(neurons_count);
+        std::iota(active_neurons_.begin(), active_neurons_.end(), size_t{0});
+        is_active_.assign(neurons_count, 1);
+        sleep_steps_.assign(neurons_count, 0);
+        woken_neurons_.clear();
+        is_synchronized_ = true;
+    }
+
+    /**
+     * @brief Count number of neurons in the set, including sleeping ones.
+     * @return number of neurons.
+     */
+    [[nodiscard]] size_t size() const { return is_active_.size(); }
+
+    /**
+     * @brief Count number of active neurons.
+     * @return number of active neurons.
+     */
+    [[nodiscard]] size_t active_count() const
+    {
+        return static_cast<size_t>(std::count(is_active_.begin(), is_active_.end(), uint8_t{1}));
+    }
+
+    /**
+     * @brief Check if decay is applied to all sleeping neurons.
+     * @return `true` if sleeping neurons have states they would have after the last step.
+     */
+    [[nodiscard]] bool is_synchronized() const { return is_synchronized_; }
+
+    /**
+     * @brief Call a function for each active neuron in the index range.
+     * @details Active neurons are processed in the increasing order of their indexes.
+     * @tparam Function type of function that accepts a neuron index.
+     * @param range_start index of the first neuron in the range.
+     * @param range_end index of the neuron after the last neuron in the range.
+     * @param function function to call.
+     */
+    template <class Function>
+    void for_each_active_neuron(size_t range_start, size_t range_end, Function &&function) const
+    {
+        auto iter = std::lower_bound(active_neurons_.begin(), active_neurons_.end(), range_start);
+        for (; iter != active_neurons_.end() && *iter < range_end; ++iter)
+        {
+            if (is_active_[*iter]) function(*iter);
+        }
+    }
+
+    /**
+     * @brief Start a new step.
+     * @details The method is called once per step before synaptic inputs are processed. It removes neurons that fell
+     * asleep on the previous step from the active neuron list.
+     */
+    void start_step()
+    {
+        ++step_;
+        active_neurons_.erase(
+            std::remove_if(
+                active_neurons_.begin(), active_neurons_.end(), [this](size_t index) { return !is_active_[index]; }),
+            active_neurons_.end());
+        is_synchronized_ = false;
+    }
+
+    /**
+     * @brief Wake a neuron that receives a synaptic input.
+     * @details A sleeping neuron gets the state it would have before impacts on the current step.
+     * @tparam NeuronParameters type of BLIFAT neuron parameters.
+     * @param index neuron index.
+     * @param neuron neuron parameters.
+     */
+    template <class NeuronParameters>
+    void wake(size_t index, NeuronParameters &neuron)
+    {
+        wake(index, neuron, woken_neurons_);
+    }
+
+    /**
+     * @brief Wake a neuron that receives a synaptic input, and add its index to the given list.
+     * @details Different neurons can be woken in parallel if each thread uses its own list. Lists must be added by
+     * `add_woken_neurons` before `finish_inputs` is called.
+     * @tparam NeuronParameters type of BLIFAT neuron parameters.
+     * @param index neuron index.
+     * @param neuron neuron parameters.
+     * @param woken_neurons output parameter, indexes of woken neurons.
+     */
+    template <class NeuronParameters>
+    void wake(size_t index, NeuronParameters &neuron, std::vector<size_t> &woken_neurons)
+    {
+        if (is_active_[index]) return;
+        const uint64_t steps = step_ - sleep_steps_[index];
+        // Post-input calculation on the current step is done for the active neuron.
+        advance(neuron, steps, steps - 1);
+        is_active_[index] = 1;
+        woken_neurons.push_back(index);
+    }
+
+    /**
+     * @brief Make a neuron active before it is changed between steps.
+     * @details Decay of the neuron must be applied by `synchronize`. The neuron is added to the active neuron list when
+     * inputs of the next step are finished, and it is put to sleep again after the step if it cannot spike.
+     * @param index neuron index.
+     */
+    void activate(size_t index)
+    {
+        if (is_active_[index]) return;
+        is_active_[index] = 1;
+        // A neuron that fell asleep on the last step is still in the active neuron list.
+        if (std::binary_search(active_neurons_.begin(), active_neurons_.end(), index) ||
+            std::find(woken_neurons_.begin(), woken_neurons_.end(), index) != woken_neurons_.end())
+        {
+            return;
+        }
+        woken_neurons_.push_back(index);
+    }
+
+    /**
+     * @brief Add neurons woken in parallel on the current step.
+     * @param woken_neurons indexes of woken neurons.
+     */
+    void add_woken_neurons(const std::vector<size_t> &woken_neurons)
+    {
+        woken_neurons_.insert(woken_neurons_.end(), woken_neurons.begin(), woken_neurons.end());
+    }
+
+    /**
+     * @brief Add neurons woken on the current step to the active neuron list.
+     */
+    void finish_inputs()
+    {
+        if (woken_neurons_.empty()) return;
+        std::sort(woken_neurons_.begin(), woken_neurons_.end());
+        const auto middle = active_neurons_.insert(active_neurons_.end(), woken_neurons_.begin(), woken_neurons_.end());
+        std::inplace_merge(active_neurons_.begin(), middle, active_neurons_.end());
+        woken_neurons_.clear();
+    }
+
+    /**
+     * @brief Put a neuron to sleep if it cannot spike without synaptic inputs.
+     * @details The method is called after the neuron state is calculated on the current step. Different neurons can
+     * be processed in parallel.
+     * @tparam NeuronParameters type of BLIFAT neuron parameters.
+     * @param index neuron index.
+     * @param neuron neuron parameters.
+     */
+    template <class NeuronParameters>
+    void try_sleep(size_t index, const NeuronParameters &neuron)
+    {
+        if (!can_sleep(neuron)) return;
+        is_active_[index] = 0;
+        sleep_steps_[index] = step_;
+    }
+
+    /**
+     * @brief Apply decay to all sleeping neurons.
+     * @details Sleeping neurons get states they would have after the last step, and stay asleep.
+     * @tparam NeuronParameters type of BLIFAT neuron parameters.
+     * @param neurons population neurons.
+     */
+    template <class NeuronParameters>
+    void synchronize(std::vector<NeuronParameters> &neurons)
+    {
+        if (is_synchronized_) return;
+        for (size_t index = 0; index < is_active_.size(); ++index)
+        {
+            if (is_active_[index]) continue;
+            const uint64_t steps = step_ - sleep_steps_[index];
+            advance(neurons[index], steps, steps);
+            sleep_steps_[index] = step_;
+        }
+        is_synchronized_ = true;
+    }
+
+    /**
+     * @brief Apply decay to a neuron if it is sleeping.
+     * @details The neuron gets the state it would have after the last step.
+     * @tparam NeuronParameters type of BLIFAT neuron parameters.
+     * @param index neuron index.
+     * @param neuron neuron parameters.
+     */
+    template <class NeuronParameters>
+    void synchronize(size_t index, NeuronParameters &neuron)
+    {
+        if (is_active_[index]) return;
+        const uint64_t steps = step_ - sleep_steps_[index];
+        advance(neuron, steps, steps);
+        sleep_steps_[index] = step_;
+    }
+
+private:
+    // A neuron cannot spike without inputs if its potential decays to zero, staying below the threshold and above
+    // the minimum.
+    template <class NeuronParameters>
+    static bool can_sleep(const NeuronParameters &neuron)
+    {
+        return 0 == neuron.bursting_phase_ && 0 == neuron.inhibitory_conductance_ &&
+               neuron.total_blocking_period_ > std::numeric_limits<int64_t>::max() / 2 &&
+               neuron.potential_decay_ >= 0 && neuron.potential_decay_ <= 1 && neuron.threshold_decay_ >= 0 &&
+               neuron.dynamic_threshold_ >= 0 && std::max(neuron.potential_, 0.0) < neuron.activation_threshold_ &&
+               neuron.min_potential_ <= std::min(neuron.potential_, 0.0);
+    }
+
+    // Apply decay of the given number of steps before and after impacts.
+    template <class NeuronParameters>
+    static void advance(NeuronParameters &neuron, uint64_t pre_impact_steps, uint64_t post_impact_steps)
+    {
+        if (!pre_impact_steps) return;
+        const auto steps = static_cast<double>(pre_impact_steps);
+        neuron.n_time_steps_since_last_firing_ += pre_impact_steps;
+        neuron.dynamic_threshold_ *= std::pow(neuron.threshold_decay_, steps);
+        neuron.postsynaptic_trace_ *= std::pow(neuron.postsynaptic_trace_decay_, steps);
+        neuron.potential_ *= std::pow(neuron.potential_decay_, steps);
+        neuron.pre_impact_potential_ = neuron.potential_;
+        neuron.total_blocking_period_ -= static_cast<int64_t>(post_impact_steps);
+    }
+
+    std::vector<size_t> active_neurons_;
+    std::vector<uint8_t> is_active_;
+    std::vector<uint64_t> sleep_steps_;
+    std::vector<size_t> woken_neurons_;
+    uint64_t step_ = 0;
+    bool is_synchronized_ = true;
+};
+
+}  // namespace knp::core
@@ -0,0 +1,82 @@
+/**
+ * @file blifat_features.h
+ * @brief Optional parts of the BLIFAT neuron model.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief Optional parts of the BLIFAT neuron model.
+ * @details Features are combined into a bit mask. Population kernels skip calculations of features that are not
+ * used by any population neuron. A feature that is not used doesn't change neuron states.
+ */
+struct BLIFATFeatures
+{
+    /**
+     * @brief Bursting after spikes.
+     */
+    static constexpr unsigned bursting = 1U << 0;
+    /**
+     * @brief Blocking of neurons by `BLOCKING` synaptic inputs.
+     */
+    static constexpr unsigned blocking = 1U << 1;
+    /**
+     * @brief Inhibitory conductance changed by `INHIBITORY_CONDUCTANCE` synaptic inputs.
+     */
+    static constexpr unsigned inhibitory_conductance = 1U << 2;
+    /**
+     * @brief Dynamic threshold increased by spikes.
+     */
+    static constexpr unsigned dynamic_threshold = 1U << 3;
+    /**
+     * @brief All features.
+     */
+    static constexpr unsigned all = bursting | blocking | inhibitory_conductance | dynamic_threshold;
+
+    /**
+     * @brief Detect features used by a neuron.
+     * @details A neuron doesn't use blocking if it is not going to be unblocked in any realistic number of steps.
+     * Features changed by synaptic inputs are enabled by population kernels when the inputs are received.
+     * @tparam NeuronParameters type of BLIFAT-like neuron parameters.
+     * @param neuron neuron parameters.
+     * @return bit mask of used features.
+     */
+    template <class NeuronParameters>
+    [[nodiscard]] static unsigned detect(const NeuronParameters &neuron)
+    {
+        unsigned features = 0;
+        if (neuron.bursting_period_ || neuron.bursting_phase_) features |= bursting;
+        if (neuron.total_blocking_period_ <= std::numeric_limits<int64_t>::max() / 2) features |= blocking;
+        if (0 != neuron.inhibitory_conductance_) features |= inhibitory_conductance;
+        if (0 != neuron.dynamic_threshold_ || 0 != neuron.threshold_increment_) features |= dynamic_threshold;
+        return features;
+    }
+};
+
+}  // namespace knp::core
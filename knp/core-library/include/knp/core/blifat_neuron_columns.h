@@ -0,0 +1,314 @@
+/**
+ * @file blifat_neuron_columns.h
+ * @brief Structure-of-arrays storage of BLIFAT-like neurons.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/neuron-traits/blifat.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief Check if neurons of the given type have BLIFAT parameters.
+ * @tparam NeuronType neuron type.
+ */
+template <class NeuronType>
+constexpr bool is_blifat_like_v = std::is_base_of_v<
+    neuron_traits::neuron_parameters<neuron_traits::BLIFATNeuron>, neuron_traits::neuron_parameters<NeuronType>>;
+
+
+/**
+ * @brief Parameters of BLIFAT-like neurons stored as a structure of arrays.
+ * @details Each array contains a single parameter of all population neurons, so kernels read only parameters they
+ * use, and loops over arrays can be vectorized. Parameters that are not defined by `BLIFATNeuron` are not stored,
+ * except for the forcing flag of neurons with dopamine plasticity. \n
+ * Constant parameters, which are not changed by kernels, can be shared by all neurons. In this case, each of their
+ * arrays contains a single value, and only neuron states are stored per neuron.
+ * @tparam Scalar type of floating-point parameters. Single precision doubles the number of neurons processed by a
+ * single SIMD instruction.
+ */
+template <class Scalar>
+struct BasicBLIFATNeuronColumns
+{
+    /**
+     * @brief Number of steps since the last spike of each neuron.
+     */
+    std::vector<std::size_t> n_time_steps_since_last_firing_;
+    /**
+     * @brief Activation thresholds.
+     */
+    std::vector<Scalar> activation_threshold_;
+    /**
+     * @brief Dynamic thresholds.
+     */
+    std::vector<Scalar> dynamic_threshold_;
+    /**
+     * @brief Dynamic threshold decays.
+     */
+    std::vector<Scalar> threshold_decay_;
+    /**
+     * @brief Dynamic threshold increments.
+     */
+    std::vector<Scalar> threshold_increment_;
+    /**
+     * @brief Postsynaptic traces.
+     */
+    std::vector<Scalar> postsynaptic_trace_;
+    /**
+     * @brief Postsynaptic trace decays.
+     */
+    std::vector<Scalar> postsynaptic_trace_decay_;
+    /**
+     * @brief Postsynaptic trace increments.
+     */
+    std::vector<Scalar> postsynaptic_trace_increment_;
+    /**
+     * @brief Inhibitory conductances.
+     */
+    std::vector<Scalar> inhibitory_conductance_;
+    /**
+     * @brief Inhibitory conductance decays.
+     */
+    std::vector<Scalar> inhibitory_conductance_decay_;
+    /**
+     * @brief Membrane potentials.
+     */
+    std::vector<Scalar> potential_;
+    /**
+     * @brief Membrane potentials before impacts.
+     */
+    std::vector<Scalar> pre_impact_potential_;
+    /**
+     * @brief Membrane potential decays.
+     */
+    std::vector<Scalar> potential_decay_;
+    /**
+     * @brief Bursting phases.
+     */
+    std::vector<unsigned> bursting_phase_;
+    /**
+     * @brief Bursting periods.
+     */
+    std::vector<unsigned> bursting_period_;
+    /**
+     * @brief Reflexive weights.
+     */
+    std::vector<Scalar> reflexive_weight_;
+    /**
+     * @brief Reversal inhibitory potentials.
+     */
+    std::vector<Scalar> reversal_inhibitory_potential_;
+    /**
+     * @brief Absolute refractory periods.
+     */
+    std::vector<unsigned> absolute_refractory_period_;
+    /**
+     * @brief Potential reset values.
+     */
+    std::vector<Scalar> potential_reset_value_;
+    /**
+     * @brief Minimum potentials.
+     */
+    std::vector<Scalar> min_potential_;
+    /**
+     * @brief Total blocking periods.
+     */
+    std::vector<int64_t> total_blocking_period_;
+    /**
+     * @brief Dopamine values.
+     */
+    std::vector<Scalar> dopamine_value_;
+    /**
+     * @brief Forcing flags. The array is empty for neurons without dopamine plasticity.
+     */
+    std::vector<uint8_t> is_being_forced_;
+    /**
+     * @brief `true` if arrays of constant parameters contain a single value shared by all neurons.
+     */
+    bool has_shared_parameters_ = false;
+
+    /**
+     * @brief Count number of neurons.
+     * @return number of neurons.
+     */
+    [[nodiscard]] std::size_t size() const { return potential_.size(); }
+
+    /**
+     * @brief Remove all neurons.
+     */
+    void clear() { *this = BasicBLIFATNeuronColumns{}; }
+
+    /**
+     * @brief Add a neuron.
+     * @pre Parameters are not shared.
+     * @tparam NeuronParameters type of BLIFAT-like neuron parameters.
+     * @param neuron neuron parameters.
+     */
+    template <class NeuronParameters>
+    void push_back(const NeuronParameters &neuron)
+    {
+        auto push_value = [](auto &column, const auto &value)
+        { column.push_back(static_cast<typename std::decay_t<decltype(column)>::value_type>(value)); };
+        for_each_state_column(*this, neuron, push_value);
+        for_each_parameter_column(*this, neuron, push_value);
+    }
+
+    /**
+     * @brief Replace arrays of constant parameters with single values shared by all neurons.
+     * @details Parameters are shared only if they are the same for all neurons.
+     * @return `true` if parameters are shared.
+     */
+    bool share_parameters()
+    {
+        if (has_shared_parameters_ || 0 == size()) return has_shared_parameters_;
+        // Neuron parameters are only used to select arrays.
+        const neuron_traits::neuron_parameters<neuron_traits::BLIFATNeuron> neuron;
+        bool is_uniform = true;
+        for_each_parameter_column(
+            *this, neuron,
+            [&is_uniform](const auto &column, const auto &)
+            {
+                const auto first = column.front();
+                is_uniform = is_uniform &&
+                             std::all_of(column.begin(), column.end(), [first](auto value) { return value == first; });
+            });
+        if (!is_uniform) return false;
+        for_each_parameter_column(
+            *this, neuron, [](auto &column, const auto &)
+            {
+                column.resize(1);
+                column.shrink_to_fit();
+            });
+        has_shared_parameters_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Copy stored parameters to a neuron.
+     * @details Neuron parameters that are not stored are not changed.
+     * @tparam NeuronParameters type of BLIFAT-like neuron parameters.
+     * @param index neuron index.
+     * @param neuron neuron parameters to update.
+     */
+    template <class NeuronParameters>
+    void load(std::size_t index, NeuronParameters &neuron) const
+    {
+        for_each_state_column(
+            *this, neuron, [index](const auto &column, auto &value)
+            { value = static_cast<std::decay_t<decltype(value)>>(column[index]); });
+        const std::size_t parameter_index = has_shared_parameters_ ? 0 : index;
+        for_each_parameter_column(
+            *this, neuron, [parameter_index](const auto &column, auto &value)
+            { value = static_cast<std::decay_t<decltype(value)>>(column[parameter_index]); });
+    }
+
+private:
+    template <class NeuronParameters, class = void>
+    struct has_forcing : std::false_type
+    {
+    };
+
+    template <class NeuronParameters>
+    struct has_forcing<NeuronParameters, std::void_t<decltype(std::declval<NeuronParameters &>().is_being_forced_)>>
+        : std::true_type
+    {
+    };
+
+    // Neuron states are changed by kernels.
+    template <class Columns, class NeuronParameters, class Function>
+    static void for_each_state_column(Columns &columns, NeuronParameters &neuron, Function &&function)
+    {
+        function(columns.n_time_steps_since_last_firing_, neuron.n_time_steps_since_last_firing_);
+        function(columns.dynamic_threshold_, neuron.dynamic_threshold_);
+        function(columns.postsynaptic_trace_, neuron.postsynaptic_trace_);
+        function(columns.inhibitory_conductance_, neuron.inhibitory_conductance_);
+        function(columns.potential_, neuron.potential_);
+        function(columns.pre_impact_potential_, neuron.pre_impact_potential_);
+        function(columns.bursting_phase_, neuron.bursting_phase_);
+        function(columns.total_blocking_period_, neuron.total_blocking_period_);
+        function(columns.dopamine_value_, neuron.dopamine_value_);
+        if constexpr (has_forcing<std::decay_t<NeuronParameters>>::value)
+        {
+            function(columns.is_being_forced_, neuron.is_being_forced_);
+        }
+    }
+
+    // Constant parameters are only read by kernels.
+    template <class Columns, class NeuronParameters, class Function>
+    static void for_each_parameter_column(Columns &columns, NeuronParameters &neuron, Function &&function)
+    {
+        function(columns.activation_threshold_, neuron.activation_threshold_);
+        function(columns.threshold_decay_, neuron.threshold_decay_);
+        function(columns.threshold_increment_, neuron.threshold_increment_);
+        function(columns.postsynaptic_trace_decay_, neuron.postsynaptic_trace_decay_);
+        function(columns.postsynaptic_trace_increment_, neuron.postsynaptic_trace_increment_);
+        function(columns.inhibitory_conductance_decay_, neuron.inhibitory_conductance_decay_);
+        function(columns.potential_decay_, neuron.potential_decay_);
+        function(columns.bursting_period_, neuron.bursting_period_);
+        function(columns.reflexive_weight_, neuron.reflexive_weight_);
+        function(columns.reversal_inhibitory_potential_, neuron.reversal_inhibitory_potential_);
+        function(columns.absolute_refractory_period_, neuron.absolute_refractory_period_);
+        function(columns.potential_reset_value_, neuron.potential_reset_value_);
+        function(columns.min_potential_, neuron.min_potential_);
+    }
+};
+
+
+/**
+ * @brief BLIFAT-like neuron parameters stored in double precision.
+ */
+using BLIFATNeuronColumns = BasicBLIFATNeuronColumns<double>;
+
+
+/**
+ * @brief BLIFAT-like neuron parameters stored in single precision.
+ */
+using BLIFATFloatNeuronColumns = BasicBLIFATNeuronColumns<float>;
+
+
+/**
+ * @brief Divergence of single-precision spikes from double-precision spikes.
+ * @details Statistics are accumulated by population kernels in the precision validation mode.
+ */
+struct PrecisionDivergence
+{
+    /**
+     * @brief Number of double-precision spikes.
+     */
+    uint64_t reference_spikes_ = 0;
+    /**
+     * @brief Number of spikes that are emitted in one precision only.
+     */
+    uint64_t divergent_spikes_ = 0;
+};
+
+}  // namespace knp::core
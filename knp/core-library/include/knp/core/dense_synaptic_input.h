@@ -0,0 +1,170 @@
+/**
+ * @file dense_synaptic_input.h
+ * @brief Dense synaptic inputs of a population.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/synapse-traits/output_types.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief Synaptic inputs of a population that projections accumulate without synaptic impact messages.
+ * @details Inputs are stored as one value per neuron for each output type and each step on which the population
+ * processes them. Buffers of processed steps are reused for later steps, so that accumulating inputs doesn't allocate
+ * memory once buffers for the longest synapse delay are allocated. Impacts are summed, so their order differs from the
+ * order of messages, and results can differ in the last bits.
+ */
+class DenseSynapticInput
+{
+public:
+    /**
+     * @brief Number of output types that are accumulated.
+     */
+    static constexpr size_t accumulated_types_count = static_cast<size_t>(synapse_traits::OutputType::DOPAMINE) + 1;
+
+    /**
+     * @brief Check if impacts of an output type are accumulated.
+     * @details Blocking impacts set a neuron blocking period instead of being summed.
+     * @param synapse_type output type of impacts.
+     * @return `true` if impacts can be summed.
+     */
+    static constexpr bool is_accumulated(synapse_traits::OutputType synapse_type)
+    {
+        return static_cast<size_t>(synapse_type) < accumulated_types_count;
+    }
+
+    /**
+     * @brief Count number of neurons that receive inputs.
+     * @return number of neurons.
+     */
+    [[nodiscard]] size_t size() const { return neurons_count_; }
+
+    /**
+     * @brief Change number of neurons that receive inputs.
+     * @details Inputs of remaining neurons are kept.
+     * @param neurons_count number of population neurons.
+     */
+    void resize(size_t neurons_count)
+    {
+        if (neurons_count == neurons_count_) return;
+        for (auto &slot : slots_)
+        {
+            for (auto &values : slot.values_)
+            {
+                if (!values.empty()) values.resize(neurons_count);
+            }
+        }
+        neurons_count_ = neurons_count;
+    }
+
+    /**
+     * @brief Add an impact to the input of a neuron.
+     * @details Impacts for steps that were already processed are ignored, as messages sent for such steps are never
+     * received.
+     * @param step step on which the population processes the impact.
+     * @param synapse_type output type of an accumulated impact.
+     * @param neuron_index index of the postsynaptic neuron.
+     * @param impact_value value of the impact.
+     */
+    void add_impact(uint64_t step, synapse_traits::OutputType synapse_type, size_t neuron_index, float impact_value)
+    {
+        if (step < first_step_) return;
+        const auto offset = static_cast<size_t>(step - first_step_);
+        if (offset >= slots_.size()) slots_.resize(offset + 1);
+        auto &slot = slots_[offset];
+        const auto type_index = static_cast<size_t>(synapse_type);
+        auto &values = slot.values_[type_index];
+        if (values.empty()) values.resize(neurons_count_);
+        values[neuron_index] += impact_value;
+        slot.is_used_[type_index] = true;
+    }
+
+    /**
+     * @brief Call a function for each output type of impacts that the population processes on a step.
+     * @tparam Function type of function that accepts an output type and a vector of values of all neurons.
+     * @param step step on which the population processes impacts.
+     * @param function function to call.
+     */
+    template <class Function>
+    void for_each_input(uint64_t step, Function &&function) const
+    {
+        if (step < first_step_ || step - first_step_ >= slots_.size()) return;
+        const auto &slot = slots_[static_cast<size_t>(step - first_step_)];
+        for (size_t type_index = 0; type_index < accumulated_types_count; ++type_index)
+        {
+            if (slot.is_used_[type_index])
+            {
+                function(static_cast<synapse_traits::OutputType>(type_index), slot.values_[type_index]);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove inputs of a processed step and all previous steps.
+     * @param step step on which the population processed impacts.
+     */
+    void finish_step(uint64_t step)
+    {
+        if (step < first_step_) return;
+        const uint64_t steps_count = std::min<uint64_t>(step - first_step_ + 1, slots_.size());
+        for (uint64_t i = 0; i < steps_count; ++i)
+        {
+            auto &slot = slots_.front();
+            for (size_t type_index = 0; type_index < accumulated_types_count; ++type_index)
+            {
+                if (!slot.is_used_[type_index]) continue;
+                std::fill(slot.values_[type_index].begin(), slot.values_[type_index].end(), 0.0F);
+                slot.is_used_[type_index] = false;
+            }
+            // Cleared buffers are moved to the end, as the queue grows to the longest delay.
+            slots_.push_back(std::move(slot));
+            slots_.pop_front();
+        }
+        first_step_ = step + 1;
+    }
+
+private:
+    struct Slot
+    {
+        std::array<std::vector<float>, accumulated_types_count> values_;
+        std::array<bool, accumulated_types_count> is_used_{};
+    };
+
+    // Slots of consecutive steps, starting from the first step that wasn't processed.
+    std::deque<Slot> slots_;
+    uint64_t first_step_ = 0;
+    size_t neurons_count_ = 0;
+};
+
+}  // namespace knp::core
@@ -0,0 +1,155 @@
+/**
+ * @file mapped_synapse_file.h
+ * @brief Memory-mapped file with projection synapses.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/synapse_index.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief The MappedSynapseFile class is a read-only view of synapses stored in a memory-mapped file.
+ * @details The file has a fixed binary layout: a header, an array of synapse parameters, arrays of 32-bit presynaptic
+ * and postsynaptic neuron indexes and a prebuilt presynaptic CSR index. The file is mapped as a whole, and the
+ * operating system loads only the pages that are accessed. Files are not portable between platforms with different
+ * byte order or `size_t` size.
+ */
+class MappedSynapseFile
+{
+public:
+    /**
+     * @brief Map a synapse file into memory.
+     * @details The synapse index is validated in a single pass over the file.
+     * @param path path to the file.
+     * @param parameters_size size of synapse parameters in bytes.
+     * @throw std::runtime_error if the file cannot be mapped or has an incorrect format.
+     */
+    MappedSynapseFile(const std::filesystem::path &path, size_t parameters_size);
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~MappedSynapseFile();
+
+    /**
+     * @brief Deleted copy constructor.
+     */
+    MappedSynapseFile(const MappedSynapseFile &) = delete;
+
+    /**
+     * @brief Deleted copy operator.
+     * @return reference to the object.
+     */
+    MappedSynapseFile &operator=(const MappedSynapseFile &) = delete;
+
+public:
+    /**
+     * @brief Write synapses to a file that can be mapped.
+     * @param path path to the file. The file is overwritten if it exists.
+     * @param parameters_size size of synapse parameters in bytes.
+     * @param parameters pointer to a contiguous array of synapse parameters.
+     * @param source_neurons presynaptic neuron indexes.
+     * @param target_neurons postsynaptic neuron indexes.
+     * @param presynaptic_index presynaptic index of the synapses.
+     * @throw std::runtime_error if the file cannot be written.
+     */
+    static void write(
+        const std::filesystem::path &path, size_t parameters_size, const void *parameters,
+        const std::vector<uint32_t> &source_neurons, const std::vector<uint32_t> &target_neurons,
+        const SynapseIndex &presynaptic_index);
+
+public:
+    /**
+     * @brief Get number of synapses in the file.
+     * @return number of synapses.
+     */
+    [[nodiscard]] size_t size() const { return size_; }
+
+    /**
+     * @brief Get path to the mapped file.
+     * @return file path.
+     */
+    [[nodiscard]] const std::filesystem::path &get_path() const { return path_; }
+
+    /**
+     * @brief Get synapse parameters.
+     * @tparam SynapseParameters type of synapse parameters.
+     * @return pointer to the first element of the parameter array.
+     */
+    template <class SynapseParameters>
+    [[nodiscard]] const SynapseParameters *get_parameters() const
+    {
+        return static_cast<const SynapseParameters *>(parameters_);
+    }
+
+    /**
+     * @brief Get presynaptic neuron indexes.
+     * @return pointer to the first element of the index array.
+     */
+    [[nodiscard]] const uint32_t *get_source_neurons() const { return source_neurons_; }
+
+    /**
+     * @brief Get postsynaptic neuron indexes.
+     * @return pointer to the first element of the index array.
+     */
+    [[nodiscard]] const uint32_t *get_target_neurons() const { return target_neurons_; }
+
+    /**
+     * @brief Find indexes of synapses that originate from a neuron.
+     * @details The method doesn't allocate memory.
+     * @param neuron_index presynaptic neuron index.
+     * @return range of synapse indexes in ascending order.
+     */
+    [[nodiscard]] SynapseIndex::Range find_presynaptic(size_t neuron_index) const
+    {
+        if (neuron_index >= rows_count_) return {};
+        return {synapse_indexes_ + row_offsets_[neuron_index], synapse_indexes_ + row_offsets_[neuron_index + 1]};
+    }
+
+private:
+    // Check that index rows are ordered and refer to existing synapses.
+    [[nodiscard]] bool is_index_valid() const;
+
+    struct Mapping;
+    std::unique_ptr<Mapping> mapping_;
+    std::filesystem::path path_;
+
+    size_t size_ = 0;
+    size_t rows_count_ = 0;
+    const void *parameters_ = nullptr;
+    const uint32_t *source_neurons_ = nullptr;
+    const uint32_t *target_neurons_ = nullptr;
+    const uint64_t *row_offsets_ = nullptr;
+    const size_t *synapse_indexes_ = nullptr;
+};
+
+}  // namespace knp::core
@@ -21,12 +21,18 @@
 
 #pragma once
 
+#include <knp/core/blifat_active_set.h>
+#include <knp/core/blifat_features.h>
+#include <knp/core/blifat_neuron_columns.h>
 #include <knp/core/core.h>
 #include <knp/core/messaging/synaptic_impact_message.h>
 #include <knp/core/uid.h>
 #include <knp/neuron-traits/all_traits.h>
 
+#include <cstddef>
 #include <functional>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -36,6 +42,44 @@
 namespace knp::core
 {
 
+/**
+ * @brief Layout of neurons in population memory.
+ */
+enum class NeuronStorage
+{
+    /**
+     * @brief Neurons are stored as a single array of `NeuronParameters` structures.
+     */
+    array_of_structures,
+    /**
+     * @brief Each neuron parameter is stored in a separate contiguous array.
+     * @details Only populations of BLIFAT-like neurons support this layout. Neuron structures are rebuilt on demand if
+     * the population is accessed through non-constant `begin()`, `end()`, `operator[]` or other per-neuron methods,
+     * or if `Population::synchronize_neurons()` is called.
+     */
+    structure_of_arrays,
+    /**
+     * @brief Same as `structure_of_arrays`, but floating-point parameters are stored in single precision.
+     * @details Neuron structures keep double-precision parameters, which are rounded when columns are built.
+     */
+    single_precision_structure_of_arrays,
+    /**
+     * @brief Neurons are simulated in double and single precision side by side.
+     * @details Double-precision columns define the population state and spikes. Single-precision columns are updated
+     * independently, and their spikes are compared with double-precision spikes. The divergence is accumulated in the
+     * population. The mode is intended for checking if a model can be simulated in single precision.
+     */
+    precision_validation,
+    /**
+     * @brief Same as `structure_of_arrays`, but constant parameters are stored once and shared by all neurons.
+     * @details Only neuron states are stored per neuron. Populations of `BLIFATNeuron` also release neuron structures
+     * while the columns are used, so the population takes less than half of its usual memory. The constant
+     * parameters must be the same for all neurons.
+     */
+    shared_parameters
+};
+
+
 /**
  * @brief The Population class is a container of neurons of the same model.
  * @tparam NeuronType type of the population neurons.
@@ -105,15 +149,35 @@ public:  // NOLINT
     /**
      * @brief Get parameters of all neurons in the population.
      * @return vector of neuron parameters.
+     * @throw std::logic_error if neuron structures are not synchronized with population kernels.
+     * @see synchronize_neurons().
      */
-    [[nodiscard]] const std::vector<NeuronParameters> &get_neurons_parameters() const { return neurons_; }
+    [[nodiscard]] const std::vector<NeuronParameters> &get_neurons_parameters() const
+    {
+        check_neurons();
+        return neurons_;
+    }
 
     /**
      * @brief Get parameters of the specific neuron in the population.
      * @param index index of the population neuron.
      * @return specific neuron parameters.
+     * @throw std::logic_error if neuron structures are not synchronized with population kernels.
+     * @see synchronize_neurons().
      */
-    [[nodiscard]] const NeuronParameters &get_neuron_parameters(size_t index) const { return neurons_[index]; }
+    [[nodiscard]] const NeuronParameters &get_neuron_parameters(size_t index) const
+    {
+        check_neurons();
+        return neurons_[index];
+    }
+
+    /**
+     * @brief Update neuron structures after population kernels.
+     * @details Neuron states are copied from columns, and decay is applied to sleeping neurons of an event-driven
+     * population. Constant per-neuron methods don't update neuron structures, so the method must be called before
+     * them once the population is simulated.
+     */
+    void synchronize_neurons() { update_neurons(); }
 
     /**
      * @brief Set parameters for the specific neuron in the population.
@@ -121,7 +185,11 @@ public:  // NOLINT
      * @param parameters vector of neuron parameters defined in NeuronParameters for the population.
      * @note Move method.
      */
-    void set_neuron_parameters(size_t index, NeuronParameters &&parameters) { neurons_[index] = std::move(parameters); }
+    void set_neuron_parameters(size_t index, NeuronParameters &&parameters)
+    {
+        invalidate_neuron(index);
+        neurons_[index] = std::move(parameters);
+    }
 
     /**
      * @brief Set parameters for the specific neuron in the population.
@@ -129,7 +197,11 @@ public:  // NOLINT
      * @param parameters vector of neuron parameters defined in NeuronParameters for the population.
      * @note Copy method.
      */
-    void set_neurons_parameters(size_t index, const NeuronParameters &parameters) { neurons_[index] = parameters; }
+    void set_neurons_parameters(size_t index, const NeuronParameters &parameters)
+    {
+        invalidate_neuron(index);
+        neurons_[index] = parameters;
+    }
 
 public:  // NOLINT
     /**
@@ -150,6 +222,7 @@ public:  // NOLINT
      */
     void add_neurons(NeuronGenerator generator, size_t count)
     {
+        invalidate_columns();
         neurons_.reserve(count);
         for (size_t i = 0; i < count; ++i)
         {
@@ -167,15 +240,23 @@ public:  // NOLINT
 
     /**
      * @brief Remove neurons with given indexes from the population.
-     * @param neuron_indexes indexes of neurons to remove.
+     * @details Neurons are removed in a single pass.
+     * @param neuron_indexes indexes of neurons to remove. Indexes can be unsorted.
      */
     void remove_neurons(const std::vector<size_t> &neuron_indexes)
     {
-        size_t index_shift = 0;
-        for (const auto &index : neuron_indexes)
+        invalidate_columns();
+        std::vector<bool> is_removed(neurons_.size(), false);
+        for (const auto &index : neuron_indexes) is_removed[index] = true;
+
+        size_t new_size = 0;
+        for (size_t index = 0; index < neurons_.size(); ++index)
         {
-            remove_neuron(index - index_shift++);
+            if (is_removed[index]) continue;
+            if (new_size != index) neurons_[new_size] = std::move(neurons_[index]);
+            ++new_size;
         }
+        neurons_.erase(neurons_.begin() + static_cast<std::ptrdiff_t>(new_size), neurons_.end());
     }
 
     /**
@@ -184,6 +265,7 @@ public:  // NOLINT
      */
     void remove_neuron(const size_t &neuron_index)
     {
+        invalidate_columns();
         auto iter = neurons_.begin();
         std::advance(iter, neuron_index);
         neurons_.erase(iter);
@@ -195,6 +277,7 @@ public:  // NOLINT
      * @note Constant method.
      * @param index neuron index.
      * @return neuron parameters.
+     * @throw std::logic_error if neuron structures are not synchronized with population kernels.
      */
     const auto &operator[](size_t index) const { return get_neuron_parameters(index); }
     /**
@@ -202,39 +285,409 @@ public:  // NOLINT
      * @param index neuron index.
      * @return neuron parameters.
      */
-    auto &operator[](size_t index) { return neurons_[index]; }
+    auto &operator[](size_t index)
+    {
+        invalidate_neuron(index);
+        return neurons_[index];
+    }
 
     /**
      * @brief Get an iterator pointing to the first element of the population.
      * @return constant population iterator.
+     * @throw std::logic_error if neuron structures are not synchronized with population kernels.
      */
-    auto begin() const { return neurons_.cbegin(); }
+    auto begin() const
+    {
+        check_neurons();
+        return neurons_.cbegin();
+    }
     /**
      * @brief Get an iterator pointing to the first element of the population.
      * @return population iterator.
      */
-    auto begin() { return neurons_.begin(); }
+    auto begin()
+    {
+        invalidate_columns();
+        return neurons_.begin();
+    }
     /**
      * @brief Get an iterator pointing to the last element of the population.
      * @return constant iterator.
+     * @throw std::logic_error if neuron structures are not synchronized with population kernels.
      */
-    auto end() const { return neurons_.cend(); }
+    auto end() const
+    {
+        check_neurons();
+        return neurons_.cend();
+    }
     /**
      * @brief Get an iterator pointing to the last element of the population.
      * @return iterator.
      */
-    auto end() { return neurons_.end(); }
+    auto end()
+    {
+        invalidate_columns();
+        return neurons_.end();
+    }
 
 public:  // NOLINT
     /**
      * @brief Count number of neurons in the population.
      * @return number of neurons.
      */
-    [[nodiscard]] size_t size() const { return neurons_.size(); }
+    [[nodiscard]] size_t size() const
+    {
+        if (is_neurons_updated_) return neurons_.size();
+        return uses_double_columns() ? columns_.size() : float_columns_.size();
+    }
+
+public:  // NOLINT
+    /**
+     * @brief Get layout of neurons in population memory.
+     * @return neuron storage type.
+     */
+    [[nodiscard]] NeuronStorage get_storage() const { return storage_; }
+
+    /**
+     * @brief Set layout of neurons in population memory.
+     * @details Neuron columns are built lazily on the first call of `get_neuron_columns()`.
+     * @param storage neuron storage type.
+     * @throw std::logic_error if the population neurons are not BLIFAT-like and `storage` is not
+     * `array_of_structures`, if `storage` is `shared_parameters` and constant neuron parameters differ, or if the
+     * population is event-driven and `storage` is not `array_of_structures`.
+     */
+    void set_storage(NeuronStorage storage)
+    {
+        if constexpr (!is_blifat_like_v<NeuronType>)
+        {
+            if (NeuronStorage::array_of_structures != storage)
+            {
+                throw std::logic_error("Only populations of BLIFAT-like neurons support structure-of-arrays storage.");
+            }
+        }
+        if (is_event_driven_ && NeuronStorage::array_of_structures != storage)
+        {
+            throw std::logic_error("Event-driven populations support only array-of-structures storage.");
+        }
+        if (storage == storage_) return;
+        update_neurons();
+        columns_.clear();
+        float_columns_.clear();
+        is_columns_updated_ = false;
+        const NeuronStorage previous_storage = storage_;
+        storage_ = storage;
+        if (NeuronStorage::shared_parameters != storage) return;
+
+        // Parameters are checked when columns are built.
+        try
+        {
+            update_columns();
+        }
+        catch (const std::logic_error &)
+        {
+            storage_ = previous_storage;
+            throw;
+        }
+    }
+
+    /**
+     * @brief Get neuron parameters stored as a structure of arrays.
+     * @details The method is used by population kernels, which change neuron columns directly. Neuron structures are
+     * updated from the columns on the next non-constant per-neuron access or by `synchronize_neurons()`. If parts of
+     * the population are processed in parallel, the method must be called once before the processing.
+     * @pre Population storage uses columns of the requested precision: `double` columns are used by
+     * `structure_of_arrays` and `precision_validation`, `float` columns are used by
+     * `single_precision_structure_of_arrays` and `precision_validation`, `shared_parameters` uses `double` columns.
+     * @tparam Scalar type of floating-point parameters.
+     * @return neuron columns.
+     * @throw std::logic_error if storage is `shared_parameters` and constant neuron parameters were changed to differ.
+     */
+    template <class Scalar = double>
+    [[nodiscard]] BasicBLIFATNeuronColumns<Scalar> &get_neuron_columns()
+    {
+        update_columns();
+        // The flag is only written once, so parts of the population can be processed in parallel.
+        if (is_neurons_updated_)
+        {
+            // Features are detected from neuron structures, which can be released.
+            update_features();
+            is_neurons_updated_ = false;
+            release_neurons();
+        }
+        if constexpr (std::is_same_v<Scalar, float>)
+        {
+            return float_columns_;
+        }
+        else
+        {
+            return columns_;
+        }
+    }
+
+    /**
+     * @brief Get divergence of single-precision spikes in the precision validation mode.
+     * @return spike divergence statistics.
+     */
+    [[nodiscard]] const PrecisionDivergence &get_precision_divergence() const { return precision_divergence_; }
+
+    /**
+     * @brief Get divergence of single-precision spikes in the precision validation mode.
+     * @details Population kernels update the statistics, users can reset them.
+     * @return spike divergence statistics.
+     */
+    [[nodiscard]] PrecisionDivergence &get_precision_divergence() { return precision_divergence_; }
+
+    /**
+     * @brief Get optional parts of the neuron model used by population neurons.
+     * @details If the population was changed through per-neuron methods, features are detected from neuron
+     * parameters on each call. Populations of neurons that are not BLIFAT-like use all features.
+     * @return bit mask of `BLIFATFeatures` values.
+     */
+    [[nodiscard]] unsigned get_features() const { return is_features_updated_ ? features_ : detect_features(); }
+
+    /**
+     * @brief Get optional parts of the neuron model used by population neurons.
+     * @details Features are detected from neuron parameters on the first call after the population is changed
+     * through per-neuron methods. Populations of neurons that are not BLIFAT-like use all features.
+     * @return bit mask of `BLIFATFeatures` values.
+     */
+    [[nodiscard]] unsigned get_features()
+    {
+        update_features();
+        return features_;
+    }
+
+    /**
+     * @brief Mark features as used by population neurons.
+     * @details The method is used by population kernels that receive synaptic inputs which enable features.
+     * @param features bit mask of `BLIFATFeatures` values.
+     */
+    void enable_features(unsigned features)
+    {
+        update_features();
+        features_ |= features;
+    }
+
+    /**
+     * @brief Get neuron structures to update their states.
+     * @details The method is used by population kernels that process neurons stored as an array of structures. Unlike
+     * per-neuron methods, it doesn't reset detected features, as kernels don't change constant neuron parameters.
+     * @return neuron structures.
+     */
+    [[nodiscard]] std::vector<NeuronParameters> &get_neuron_states()
+    {
+        load_neurons();
+        // The flag is only written once, so parts of the population can be processed in parallel.
+        if (is_columns_updated_) is_columns_updated_ = false;
+        return neurons_;
+    }
+
+    /**
+     * @brief Check if only neurons that can spike are updated on each step.
+     * @return `true` if the population is event-driven.
+     */
+    [[nodiscard]] bool is_event_driven() const { return is_event_driven_; }
+
+    /**
+     * @brief Update on each step only neurons that can spike.
+     * @details Neurons that cannot spike without synaptic inputs are put to sleep, and their decay is applied when
+     * they receive inputs, when the population is accessed through non-constant per-neuron methods, or when
+     * `synchronize_neurons()` is called. The mode is intended for
+     * sparse populations where few neurons get inputs on each step.
+     * @param is_event_driven `true` to make the population event-driven.
+     * @throw std::logic_error if the population neurons are not `BLIFATNeuron`, or if the population is not stored
+     * as an array of structures.
+     * @see BLIFATActiveSet.
+     */
+    void set_event_driven(bool is_event_driven)
+    {
+        if (is_event_driven == is_event_driven_) return;
+        if (is_event_driven)
+        {
+            if (!std::is_same_v<NeuronParameters, neuron_traits::neuron_parameters<neuron_traits::BLIFATNeuron>> ||
+                NeuronStorage::array_of_structures != storage_)
+            {
+                throw std::logic_error("Only BLIFAT populations stored as arrays of structures can be event-driven.");
+            }
+            active_set_.reset(neurons_.size());
+        }
+        else
+        {
+            update_neurons();
+            active_set_ = BLIFATActiveSet{};
+        }
+        is_event_driven_ = is_event_driven;
+    }
+
+    /**
+     * @brief Get neurons that are updated on each step of an event-driven population.
+     * @details The method is used by population kernels. If the number of population neurons has changed, all
+     * neurons are made active. If parts of the population are processed in parallel, the method must be called once
+     * before the processing.
+     * @return active neuron set.
+     */
+    [[nodiscard]] BLIFATActiveSet &get_active_set()
+    {
+        if (active_set_.size() != neurons_.size()) active_set_.reset(neurons_.size());
+        return active_set_;
+    }
+
+private:
+    [[nodiscard]] bool uses_double_columns() const
+    {
+        return NeuronStorage::structure_of_arrays == storage_ || NeuronStorage::precision_validation == storage_ ||
+               NeuronStorage::shared_parameters == storage_;
+    }
+
+    [[nodiscard]] bool uses_float_columns() const
+    {
+        return NeuronStorage::single_precision_structure_of_arrays == storage_ ||
+               NeuronStorage::precision_validation == storage_;
+    }
+
+    // Build columns from neuron structures.
+    void update_columns()
+    {
+        if (is_columns_updated_) return;
+        if constexpr (is_blifat_like_v<NeuronType>)
+        {
+            columns_.clear();
+            float_columns_.clear();
+            for (const auto &neuron : neurons_)
+            {
+                if (uses_double_columns()) columns_.push_back(neuron);
+                if (uses_float_columns()) float_columns_.push_back(neuron);
+            }
+            if (NeuronStorage::shared_parameters == storage_ && !columns_.share_parameters())
+            {
+                columns_.clear();
+                throw std::logic_error("Constant parameters of population neurons differ and cannot be shared.");
+            }
+        }
+        is_columns_updated_ = true;
+    }
+
+    // Neuron structures of populations which parameters are stored in columns completely are rebuilt on access.
+    void release_neurons()
+    {
+        if constexpr (std::is_same_v<NeuronParameters, neuron_traits::neuron_parameters<neuron_traits::BLIFATNeuron>>)
+        {
+            if (NeuronStorage::shared_parameters != storage_) return;
+            neurons_.clear();
+            neurons_.shrink_to_fit();
+        }
+    }
+
+    // Update neuron structures before they are accessed through per-neuron methods.
+    void update_neurons()
+    {
+        if constexpr (std::is_same_v<NeuronParameters, neuron_traits::neuron_parameters<neuron_traits::BLIFATNeuron>>)
+        {
+            if (is_event_driven_) active_set_.synchronize(neurons_);
+        }
+        load_neurons();
+    }
+
+    // Copy neuron states from columns to neuron structures.
+    void load_neurons()
+    {
+        if (is_neurons_updated_) return;
+        if constexpr (is_blifat_like_v<NeuronType>)
+        {
+            // Released neuron structures are default-constructed, as all their parameters are loaded from columns.
+            neurons_.resize(uses_double_columns() ? columns_.size() : float_columns_.size());
+            // In the validation mode, the population state is defined by double-precision columns.
+            for (size_t index = 0; index < neurons_.size(); ++index)
+            {
+                if (uses_double_columns())
+                {
+                    columns_.load(index, neurons_[index]);
+                }
+                else
+                {
+                    float_columns_.load(index, neurons_[index]);
+                }
+            }
+        }
+        is_neurons_updated_ = true;
+    }
+
+    // Constant per-neuron methods don't change the population, so they cannot update neuron structures.
+    void check_neurons() const
+    {
+        if (!is_neurons_updated_ || (is_event_driven_ && !active_set_.is_synchronized()))
+        {
+            throw std::logic_error(
+                "Population neurons are changed by kernels, call synchronize_neurons() to update neuron structures.");
+        }
+    }
+
+    // Detect features from neuron structures. The structures are valid if features are not updated, as structures
+    // are released only after features are detected.
+    [[nodiscard]] unsigned detect_features() const
+    {
+        if constexpr (is_blifat_like_v<NeuronType>)
+        {
+            unsigned features = 0;
+            for (const auto &neuron : neurons_) features |= BLIFATFeatures::detect(neuron);
+            return features;
+        }
+        else
+        {
+            return BLIFATFeatures::all;
+        }
+    }
+
+    // Detect features once after the population is changed.
+    void update_features()
+    {
+        if (is_features_updated_) return;
+        features_ = detect_features();
+        is_features_updated_ = true;
+    }
+
+    // Neuron structures can be changed by the caller, so columns must be rebuilt and features detected again.
+    void invalidate_columns()
+    {
+        update_neurons();
+        is_columns_updated_ = false;
+        is_features_updated_ = false;
+        if (is_event_driven_) active_set_.reset(neurons_.size());
+    }
+
+    // Only the neuron with the given index can be changed by the caller, so other neurons of an event-driven
+    // population keep sleeping.
+    void invalidate_neuron(size_t index)
+    {
+        if constexpr (std::is_same_v<NeuronParameters, neuron_traits::neuron_parameters<neuron_traits::BLIFATNeuron>>)
+        {
+            if (is_event_driven_ && active_set_.size() == neurons_.size())
+            {
+                active_set_.synchronize(index, neurons_[index]);
+                active_set_.activate(index);
+                is_columns_updated_ = false;
+                is_features_updated_ = false;
+                return;
+            }
+        }
+        invalidate_columns();
+    }
 
 private:
     BaseData base_;
     std::vector<NeuronParameters> neurons_;
+    // Columns are valid if `is_columns_updated_` is `true`, neuron structures are valid if `is_neurons_updated_` is
+    // `true`. At least one of the flags is always `true`.
+    BLIFATNeuronColumns columns_;
+    BLIFATFloatNeuronColumns float_columns_;
+    NeuronStorage storage_ = NeuronStorage::array_of_structures;
+    bool is_neurons_updated_ = true;
+    bool is_columns_updated_ = false;
+    PrecisionDivergence precision_divergence_;
+    unsigned features_ = BLIFATFeatures::all;
+    bool is_features_updated_ = false;
+    BLIFATActiveSet active_set_;
+    bool is_event_driven_ = false;
 };
 
 
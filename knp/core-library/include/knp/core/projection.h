@@ -22,21 +22,23 @@
 #pragma once
 
 #include <knp/core/core.h>
+#include <knp/core/mapped_synapse_file.h>
+#include <knp/core/quantized_synapses.h>
+#include <knp/core/synapse_index.h>
 #include <knp/core/uid.h>
 #include <knp/synapse-traits/all_traits.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <filesystem>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index_container.hpp>
-
 
 /**
  * @brief Core library namespace.
@@ -63,6 +65,24 @@ enum SynapseElementAccess
 };
 
 
+/**
+ * @brief Layout of synapses in projection memory.
+ */
+enum class SynapseStorage
+{
+    /**
+     * @brief Synapses are stored as a single array of `Synapse` tuples.
+     */
+    array_of_structures,
+    /**
+     * @brief Synapse parameters, source and target neuron indexes are stored in separate contiguous arrays.
+     * @details Neuron indexes are stored as 32-bit integers. Synapse tuples are rebuilt on demand if the projection is
+     * accessed through `begin()`, `end()` or `operator[]`.
+     */
+    structure_of_arrays
+};
+
+
 /**
  * @brief The Projection class is a definition of similar connections between the neurons of two populations.
  * @todo This class should later be divided to interface and implementation classes.
@@ -96,6 +116,185 @@ public:
      */
     using SynapseGenerator = std::function<std::optional<Synapse>(size_t)>;
 
+    /**
+     * @brief Parameters of parallel synapse generation.
+     * @details Passing the structure to a constructor or `add_synapses()` means that the synapse generator is
+     * thread-safe: it is called concurrently from several threads, each thread processing a contiguous range of
+     * iterations. Synapses are added in the iteration order.
+     */
+    struct ParallelGeneration
+    {
+        /**
+         * @brief Number of threads. `0` means the number of hardware threads.
+         */
+        size_t thread_count_ = 0;
+    };
+
+    /**
+     * @brief Function type that generates synapses of a single presynaptic neuron.
+     * @details The function receives a presynaptic neuron index and appends synapses of this neuron to a vector. It
+     * must append the same synapses each time it is called with the same neuron index.
+     */
+    using PresynapticSynapseGenerator = std::function<void(size_t, std::vector<Synapse> &)>;
+
+    /**
+     * @brief Description of procedural connectivity.
+     * @details A projection constructed from the description doesn't store synapses. Synapses of a presynaptic neuron
+     * are regenerated each time the neuron sends a spike. Synapses are materialized, that is generated and stored,
+     * only by `materialize()` and by methods that add or remove synapses. Presynaptic lookups use offsets of synapses
+     * of each presynaptic neuron, and the postsynaptic index is built by regenerating synapses only when postsynaptic
+     * synapses are requested. `operator[]`, `begin()` and `end()` throw `std::logic_error` until synapses are
+     * materialized.
+     */
+    struct ProceduralConnectivity
+    {
+        /**
+         * @brief Thread-safe function that generates synapses of a presynaptic neuron.
+         */
+        PresynapticSynapseGenerator generator_;
+        /**
+         * @brief Number of presynaptic neurons.
+         */
+        size_t presynaptic_size_ = 0;
+    };
+
+    /**
+     * @brief Description of a convolution with weights shared between synapses.
+     * @details Neurons of both populations are indexed in the channel-major order: index of a neuron with `(x, y)`
+     * coordinates in the `channel` channel is `(channel * height + y) * width + x`. Convolution has no padding, so an
+     * output neuron at `(x, y)` receives spikes from input neurons at `(x * stride_ + kernel_x, y * stride_ + kernel_y)`
+     * for all kernel positions.
+     */
+    struct Convolution
+    {
+        /**
+         * @brief Width of the input layer.
+         */
+        size_t input_width_ = 0;
+        /**
+         * @brief Height of the input layer.
+         */
+        size_t input_height_ = 0;
+        /**
+         * @brief Number of input channels.
+         */
+        size_t input_channels_ = 1;
+        /**
+         * @brief Kernel width.
+         */
+        size_t kernel_width_ = 0;
+        /**
+         * @brief Kernel height.
+         */
+        size_t kernel_height_ = 0;
+        /**
+         * @brief Number of output channels.
+         */
+        size_t output_channels_ = 1;
+        /**
+         * @brief Step between positions of the kernel.
+         */
+        size_t stride_ = 1;
+        /**
+         * @brief Shared synapse parameters in the `[output_channel][input_channel][kernel_y][kernel_x]` order.
+         */
+        std::vector<SynapseParameters> kernel_;
+
+        /**
+         * @brief Get width of the output layer.
+         * @return output width.
+         */
+        [[nodiscard]] size_t get_output_width() const { return (input_width_ - kernel_width_) / stride_ + 1; }
+
+        /**
+         * @brief Get height of the output layer.
+         * @return output height.
+         */
+        [[nodiscard]] size_t get_output_height() const { return (input_height_ - kernel_height_) / stride_ + 1; }
+
+        /**
+         * @brief Call a function for each synapse of an input neuron.
+         * @details Synapses are processed in the order of output channels, kernel rows and kernel columns. The method
+         * doesn't allocate memory.
+         * @tparam Function type of the function.
+         * @param presynaptic_index input neuron index.
+         * @param function function that receives synapse parameters and postsynaptic neuron index.
+         */
+        template <class Function>
+        void for_each_synapse(size_t presynaptic_index, Function &&function) const
+        {
+            const size_t input_x = presynaptic_index % input_width_;
+            const size_t input_y = presynaptic_index / input_width_ % input_height_;
+            const size_t input_channel = presynaptic_index / (input_width_ * input_height_);
+            if (input_channel >= input_channels_) return;
+
+            const size_t output_width = get_output_width();
+            const size_t output_height = get_output_height();
+            for (size_t output_channel = 0; output_channel < output_channels_; ++output_channel)
+            {
+                const size_t kernel_begin = (output_channel * input_channels_ + input_channel) * kernel_height_;
+                for (size_t kernel_y = input_y % stride_; kernel_y < kernel_height_ && kernel_y <= input_y;
+                     kernel_y += stride_)
+                {
+                    const size_t output_y = (input_y - kernel_y) / stride_;
+                    if (output_y >= output_height) continue;
+                    for (size_t kernel_x = input_x % stride_; kernel_x < kernel_width_ && kernel_x <= input_x;
+                         kernel_x += stride_)
+                    {
+                        const size_t output_x = (input_x - kernel_x) / stride_;
+                        if (output_x >= output_width) continue;
+                        function(
+                            kernel_[(kernel_begin + kernel_y) * kernel_width_ + kernel_x],
+                            (output_channel * output_height + output_y) * output_width + output_x);
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Description of a memory-mapped synapse file.
+     * @details A projection constructed from the description doesn't load synapses into memory: synapses and the
+     * presynaptic index are read directly from the mapped file, which is shared between copies of the projection.
+     * The projection is intended for inference. Synapses are materialized, that is copied into projection memory,
+     * only by `materialize()` and by methods that add or remove synapses. Constant methods don't copy synapses, so
+     * `operator[]`, `begin()`, `end()` and `get_synapse_columns()` throw `std::logic_error` until synapses are
+     * materialized.
+     * @see `save_mapped()`.
+     */
+    struct MappedSynapses
+    {
+        /**
+         * @brief Path to a file written by `save_mapped()`.
+         */
+        std::filesystem::path path_;
+    };
+
+    /**
+     * @brief Synapses stored as a structure of arrays.
+     */
+    struct SynapseColumns
+    {
+        /**
+         * @brief Synapse parameters.
+         */
+        std::vector<SynapseParameters> parameters_;
+        /**
+         * @brief Indexes of presynaptic neurons.
+         */
+        std::vector<uint32_t> source_neurons_;
+        /**
+         * @brief Indexes of postsynaptic neurons.
+         */
+        std::vector<uint32_t> target_neurons_;
+
+        /**
+         * @brief Count number of synapses.
+         * @return number of synapses.
+         */
+        [[nodiscard]] size_t size() const { return parameters_.size(); }
+    };
+
 public:
     /**
      * @brief Shared synapse parameters for the non-STDP variant of the projection.
@@ -187,6 +386,113 @@ public:
      */
     Projection(UID uid, UID presynaptic_uid, UID postsynaptic_uid, SynapseGenerator generator, size_t num_iterations);
 
+    /**
+     * @brief Construct a projection by running a thread-safe synapse generator in several threads.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param generator thread-safe function that generates synapse parameters: `params_`, `id_from_`, `id_to_`.
+     * @param num_iterations number of times to run the synapse generator.
+     * @param parallel_generation parameters of parallel generation.
+     */
+    Projection(
+        UID presynaptic_uid, UID postsynaptic_uid, SynapseGenerator generator, size_t num_iterations,
+        ParallelGeneration parallel_generation);
+
+    /**
+     * @brief Construct a projection by running a thread-safe synapse generator in several threads.
+     * @param uid projection UID.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param generator thread-safe function that generates synapse parameters: `params_`, `id_from_`, `id_to_`.
+     * @param num_iterations number of times to run the synapse generator.
+     * @param parallel_generation parameters of parallel generation.
+     */
+    Projection(
+        UID uid, UID presynaptic_uid, UID postsynaptic_uid, SynapseGenerator generator, size_t num_iterations,
+        ParallelGeneration parallel_generation);
+
+    /**
+     * @brief Construct a procedural projection that regenerates synapses instead of storing them.
+     * @details The generator is run once for each presynaptic neuron to count synapses.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param connectivity procedural connectivity description.
+     */
+    Projection(UID presynaptic_uid, UID postsynaptic_uid, ProceduralConnectivity connectivity);
+
+    /**
+     * @brief Construct a procedural projection that regenerates synapses instead of storing them.
+     * @details The generator is run once for each presynaptic neuron to count synapses.
+     * @param uid projection UID.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param connectivity procedural connectivity description.
+     */
+    Projection(UID uid, UID presynaptic_uid, UID postsynaptic_uid, ProceduralConnectivity connectivity);
+
+    /**
+     * @brief Construct a convolutional projection that stores a single kernel instead of synapses.
+     * @details The projection is procedural, see `ProceduralConnectivity`.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param convolution convolution description.
+     * @throw std::logic_error if the convolution description is inconsistent.
+     */
+    Projection(UID presynaptic_uid, UID postsynaptic_uid, Convolution convolution);
+
+    /**
+     * @brief Construct a convolutional projection that stores a single kernel instead of synapses.
+     * @details The projection is procedural, see `ProceduralConnectivity`.
+     * @param uid projection UID.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param convolution convolution description.
+     * @throw std::logic_error if the convolution description is inconsistent.
+     */
+    Projection(UID uid, UID presynaptic_uid, UID postsynaptic_uid, Convolution convolution);
+
+    /**
+     * @brief Construct a projection that reads synapses from a memory-mapped file.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param mapped_synapses mapped synapse file description.
+     * @throw std::runtime_error if the file cannot be mapped or was written for another synapse type.
+     */
+    Projection(UID presynaptic_uid, UID postsynaptic_uid, const MappedSynapses &mapped_synapses);
+
+    /**
+     * @brief Construct a projection that reads synapses from a memory-mapped file.
+     * @param uid projection UID.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param mapped_synapses mapped synapse file description.
+     * @throw std::runtime_error if the file cannot be mapped or was written for another synapse type.
+     */
+    Projection(UID uid, UID presynaptic_uid, UID postsynaptic_uid, const MappedSynapses &mapped_synapses);
+
+    /**
+     * @brief Construct a projection of delta synapses with low-precision weights.
+     * @details The projection is locked.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param synapses quantized synapses.
+     * @throw std::logic_error if the projection synapses are not delta synapses or array sizes don't match.
+     * @see `quantize_weights()`.
+     */
+    Projection(UID presynaptic_uid, UID postsynaptic_uid, QuantizedSynapses synapses);
+
+    /**
+     * @brief Construct a projection of delta synapses with low-precision weights.
+     * @details The projection is locked.
+     * @param uid projection UID.
+     * @param presynaptic_uid presynaptic population UID.
+     * @param postsynaptic_uid postsynaptic population UID.
+     * @param synapses quantized synapses.
+     * @throw std::logic_error if the projection synapses are not delta synapses or array sizes don't match.
+     * @see `quantize_weights()`.
+     */
+    Projection(UID uid, UID presynaptic_uid, UID postsynaptic_uid, QuantizedSynapses synapses);
+
 public:
     /**
      * @brief Get projection UID.
@@ -213,47 +519,183 @@ public:
      * @brief Get parameter values of a synapse with the given index.
      * @param index synapse index.
      * @return synapse parameters and indexes.
+     * @throw std::logic_error if the projection is procedural or mapped.
      */
-    [[nodiscard]] Synapse &operator[](size_t index) { return parameters_[index]; }
+    [[nodiscard]] Synapse &operator[](size_t index) { return get_synapses()[index]; }
 
     /**
      * @brief Get parameter values of a synapse with the given index.
      * @details Constant method.
      * @param index synapse index.
      * @return synapse parameters and indexes.
+     * @throw std::logic_error if the projection is procedural or mapped.
      */
-    [[nodiscard]] const Synapse &operator[](size_t index) const { return parameters_[index]; }
+    [[nodiscard]] const Synapse &operator[](size_t index) const { return get_synapses()[index]; }
 
     /**
      * @brief Get an iterator pointing to the first element of the projection.
      * @return constant projection iterator.
+     * @throw std::logic_error if the projection is procedural or mapped.
      */
-    [[nodiscard]] auto begin() const { return parameters_.cbegin(); }
+    [[nodiscard]] auto begin() const { return get_synapses().cbegin(); }
 
     /**
      * @brief Get an iterator pointing to the first element of the projection.
      * @return projection iterator.
+     * @throw std::logic_error if the projection is procedural or mapped.
      */
-    [[nodiscard]] auto begin() { return parameters_.begin(); }
+    [[nodiscard]] auto begin() { return get_synapses().begin(); }
 
     /**
      * @brief Get an iterator pointing to the last element of the projection.
      * @return constant iterator.
+     * @throw std::logic_error if the projection is procedural or mapped.
      */
-    [[nodiscard]] auto end() const { return parameters_.cend(); }
+    [[nodiscard]] auto end() const { return get_synapses().cend(); }
 
     /**
      * @brief Get an iterator pointing to the last element of the projection.
      * @return iterator.
+     * @throw std::logic_error if the projection is procedural or mapped.
      */
-    [[nodiscard]] auto end() { return parameters_.end(); }
+    [[nodiscard]] auto end() { return get_synapses().end(); }
 
 public:
     /**
      * @brief Count number of synapses in the projection.
      * @return number of synapses.
      */
-    [[nodiscard]] size_t size() const { return parameters_.size(); }
+    [[nodiscard]] size_t size() const
+    {
+        if (procedural_) return procedural_offsets_.back();
+        if (mapped_) return mapped_->size();
+        if (quantized_) return quantized_->size();
+        return is_synapses_updated_ ? parameters_.size() : columns_.size();
+    }
+
+    /**
+     * @brief Check if the projection regenerates synapses instead of storing them.
+     * @return `true` if synapses are not materialized.
+     */
+    [[nodiscard]] bool is_procedural() const { return procedural_.has_value(); }
+
+    /**
+     * @brief Get number of presynaptic neurons of a procedural projection.
+     * @return number of presynaptic neurons or `0` if the projection is not procedural.
+     */
+    [[nodiscard]] size_t get_procedural_presynaptic_size() const
+    {
+        return procedural_ ? procedural_->presynaptic_size_ : 0;
+    }
+
+    /**
+     * @brief Get convolution description of a convolutional projection.
+     * @return pointer to the convolution description or `nullptr` if the projection is not convolutional or was
+     * materialized.
+     */
+    [[nodiscard]] const Convolution *get_convolution() const { return convolution_.get(); }
+
+    /**
+     * @brief Get index of the first synapse of a presynaptic neuron of a procedural projection.
+     * @param neuron_index index of a presynaptic neuron.
+     * @return synapse index.
+     * @throw std::logic_error if the projection is not procedural.
+     */
+    [[nodiscard]] size_t get_procedural_synapse_index(size_t neuron_index) const;
+
+    /**
+     * @brief Generate synapses of a presynaptic neuron of a procedural projection.
+     * @details Synapses are generated in the order they would have after materialization, so the index of a synapse
+     * is the returned index plus its position in the vector. The method is thread-safe if the generator is
+     * thread-safe.
+     * @param neuron_index index of a presynaptic neuron.
+     * @param synapses vector that is cleared and filled with synapses of the neuron. Its capacity is reused.
+     * @return index of the first generated synapse.
+     * @throw std::logic_error if the projection is not procedural.
+     */
+    size_t generate_presynaptic_synapses(size_t neuron_index, std::vector<Synapse> &synapses) const;
+
+    /**
+     * @brief Generate and store all synapses of a procedural projection, copy synapses of a mapped projection into
+     * memory or dequantize synapse weights.
+     * @details After materialization the projection is neither procedural, mapped nor quantized. Otherwise the method
+     * does nothing. Synapse indexes are kept, as synapses keep their order.
+     */
+    void materialize();
+
+    /**
+     * @brief Check if the projection reads synapses from a memory-mapped file.
+     * @return `true` if synapses are not materialized.
+     */
+    [[nodiscard]] bool is_mapped() const { return nullptr != mapped_; }
+
+    /**
+     * @brief Get memory-mapped synapse file of the projection.
+     * @return pointer to the mapped file or `nullptr` if the projection is not mapped or was materialized.
+     */
+    [[nodiscard]] const MappedSynapseFile *get_mapped_file() const { return mapped_.get(); }
+
+    /**
+     * @brief Write synapses and the presynaptic index to a file that can be memory-mapped.
+     * @details Synapses of a mapped projection are written by copying the mapped file.
+     * @param path path to the file. The file is overwritten if it exists.
+     * @throw std::logic_error if synapse parameters are not trivially copyable or the projection is procedural.
+     * @throw std::runtime_error if the file cannot be written.
+     * @see `MappedSynapses`.
+     */
+    void save_mapped(const std::filesystem::path &path) const;
+
+    /**
+     * @brief Store weights of a locked projection with low precision.
+     * @details Synapses are stored as `QuantizedSynapses`, and the projection is intended for inference. Constant
+     * methods that require stored synapses return dequantized synapses and keep quantized weights. Synapses are
+     * materialized as soon as they are accessed by a non-constant method, for example, to be modified. `int8` weights
+     * use the scale that maps the largest weight magnitude to `127`. Passing `WeightQuantization::none` dequantizes
+     * synapses.
+     * @param quantization weight representation.
+     * @throw std::logic_error if the projection is not locked or its synapses are not delta synapses.
+     */
+    void quantize_weights(WeightQuantization quantization);
+
+    /**
+     * @brief Get weight representation of the projection.
+     * @return weight quantization type.
+     */
+    [[nodiscard]] WeightQuantization get_weight_quantization() const
+    {
+        return quantized_ ? quantized_->quantization_ : WeightQuantization::none;
+    }
+
+    /**
+     * @brief Get synapses with low-precision weights.
+     * @return pointer to quantized synapses or `nullptr` if weights are not quantized.
+     */
+    [[nodiscard]] const QuantizedSynapses *get_quantized_synapses() const { return quantized_.get(); }
+
+    /**
+     * @brief Get layout of synapses in projection memory.
+     * @return synapse storage type.
+     */
+    [[nodiscard]] SynapseStorage get_storage() const { return storage_; }
+
+    /**
+     * @brief Set layout of synapses in projection memory.
+     * @param storage synapse storage type.
+     * @throw std::out_of_range if a neuron index doesn't fit into a 32-bit synapse column.
+     * @note Iterators and references to synapses are invalidated.
+     */
+    void set_storage(SynapseStorage storage);
+
+    /**
+     * @brief Get synapses as a structure of arrays.
+     * @details If synapses were modified through a non-constant iterator or `operator[]`, columns are rebuilt. For a
+     * projection with the `array_of_structures` storage, columns are built in addition to the synapse array.
+     * @return synapse columns.
+     * @throw std::logic_error if the projection is procedural or mapped.
+     * @throw std::out_of_range if a neuron index doesn't fit into a 32-bit synapse column.
+     * @warning The method is not thread-safe if synapses were modified since the last call.
+     */
+    [[nodiscard]] const SynapseColumns &get_synapse_columns() const;
 
     /**
      * @brief Get UID of the associated population from which this projection receives spikes.
@@ -290,14 +732,50 @@ public:
      */
     [[nodiscard]] std::vector<size_t> find_synapses(size_t neuron_index, Search search_method) const;
 
+    /**
+     * @brief Get indexes of synapses that originate from a neuron with the given index.
+     * @details Unlike `find_synapses`, the method does not allocate memory. Synapses of a procedural projection are
+     * found without an index.
+     * @param neuron_index index of a presynaptic neuron.
+     * @return range of synapse indexes in ascending order.
+     * @warning The range is invalidated by any modification of the projection synapses.
+     */
+    [[nodiscard]] SynapseIndex::Range get_presynaptic_synapses(size_t neuron_index) const;
+
+    /**
+     * @brief Get indexes of synapses that lead to a neuron with the given index.
+     * @details The postsynaptic index is kept between calls and updated along with synapses, so the method does not
+     * allocate memory unless the index must be rebuilt. The index of a procedural projection is built on the first
+     * call by regenerating all synapses.
+     * @param neuron_index index of a postsynaptic neuron.
+     * @return range of synapse indexes in ascending order.
+     * @warning The range is invalidated by any modification of the projection synapses and by materialization.
+     */
+    [[nodiscard]] SynapseIndex::Range get_postsynaptic_synapses(size_t neuron_index) const;
+
     /**
      * @brief Append connections to the existing projection.
      * @param generator synapse generation function.
      * @param num_iterations number of iterations to run the synapse generator.
      * @return number of synapses added to the projection, which can be less or equal to the `num_iterations` value.
+     * @throw std::out_of_range if the projection uses the `structure_of_arrays` storage and a neuron index doesn't
+     * fit into a 32-bit synapse column.
      */
     size_t add_synapses(SynapseGenerator generator, size_t num_iterations);
 
+    /**
+     * @brief Append connections to the existing projection by running a thread-safe synapse generator in several
+     * threads.
+     * @param generator thread-safe synapse generation function.
+     * @param num_iterations number of iterations to run the synapse generator.
+     * @param parallel_generation parameters of parallel generation.
+     * @return number of synapses added to the projection, which can be less or equal to the `num_iterations` value.
+     * @throw std::out_of_range if the projection uses the `structure_of_arrays` storage and a neuron index doesn't
+     * fit into a 32-bit synapse column.
+     */
+    size_t add_synapses(
+        SynapseGenerator generator, size_t num_iterations, ParallelGeneration parallel_generation);
+
     /**
      * @brief Remove all synapses from the projection.
      */
@@ -309,6 +787,14 @@ public:
      */
     void remove_synapse(size_t index);
 
+    /**
+     * @brief Remove synapses with the given indexes from the projection.
+     * @details Synapses are removed in a single pass, and the index is updated without rebuilding.
+     * @param synapse_indexes indexes of synapses to remove. Indexes can be unsorted.
+     * @return number of deleted synapses.
+     */
+    size_t remove_synapses(const std::vector<size_t> &synapse_indexes);
+
     /**
      * @brief Remove synapses according to a given criterion.
      * @param predicate functor that receives a synapse and returns `true` if the synapse must be deleted.
@@ -347,6 +833,23 @@ public:
      */
     bool is_locked() const { return is_locked_; }
 
+public:
+    /**
+     * @brief Determine if synaptic impacts are accumulated directly into inputs of the postsynaptic population.
+     * @return `true` if dense delivery is enabled.
+     */
+    [[nodiscard]] bool is_dense_delivery() const { return is_dense_delivery_; }
+
+    /**
+     * @brief Enable or disable accumulation of synaptic impacts directly into inputs of the postsynaptic population.
+     * @details If the postsynaptic population is calculated by the same backend, the backend can sum impacts into
+     * dense per-neuron inputs of the population instead of sending synaptic impact messages. Other receivers, such as
+     * observers or populations of other backends, don't get impacts of such projection. Backends send impacts as
+     * messages if they don't support dense delivery for the projection or the postsynaptic population.
+     * @param is_dense `true` to enable dense delivery.
+     */
+    void set_dense_delivery(bool is_dense) { is_dense_delivery_ = is_dense; }
+
 public:
     /**
      * @brief Get parameters shared between all synapses.
@@ -361,7 +864,12 @@ public:
     const SharedSynapseParameters &get_shared_parameters() const { return shared_parameters_; }
 
 private:
-    void reindex() const;
+    void reindex(size_t thread_count = 1) const;
+    void set_procedural(ProceduralConnectivity connectivity);
+    std::vector<Synapse> &get_synapses();
+    const std::vector<Synapse> &get_synapses() const;
+    void update_storage();
+    size_t remove_marked_synapses(const std::vector<bool> &is_removed);
 
     BaseData base_;
 
@@ -380,39 +888,42 @@ private:
      */
     bool is_locked_ = true;
 
+    /**
+     * @brief Return `true` if synaptic impacts can be accumulated into inputs of the postsynaptic population.
+     */
+    bool is_dense_delivery_ = false;
+
     /**
      * @brief Container of synapse parameters.
      */
-    std::vector<Synapse> parameters_;
-    // So far the index is mutable so we can reindex a const object that has a non-updated index.
-    struct Connection
-    {
-        size_t from_;
-        size_t to_;
-        size_t index_;
-        bool operator==(const Connection &connection) const
-        {
-            return from_ == connection.from_ && to_ == connection.to_ && index_ == connection.index_;
-        }
-    };
+    mutable std::vector<Synapse> parameters_;
+
+    // Synapses are kept either as tuples, as columns or both. The storage type defines which of them is kept after
+    // modification.
+    SynapseStorage storage_ = SynapseStorage::array_of_structures;
+    mutable SynapseColumns columns_;
+    mutable bool is_synapses_updated_ = true;
+    mutable bool is_columns_updated_ = false;
 
-    typedef boost::multi_index::multi_index_container<
-        Connection,
-        boost::multi_index::indexed_by<
-            boost::multi_index::hashed_non_unique<
-                boost::multi_index::tag<struct mi_presynaptic>, BOOST_MULTI_INDEX_MEMBER(Connection, size_t, from_)>,
-            boost::multi_index::hashed_non_unique<
-                boost::multi_index::tag<struct mi_postsynaptic>, BOOST_MULTI_INDEX_MEMBER(Connection, size_t, to_)>,
-            boost::multi_index::hashed_unique<
-                boost::multi_index::tag<struct mi_synapse_index>,
-                BOOST_MULTI_INDEX_MEMBER(Connection, size_t, index_)>>>
-        Index;
-    using ByPresynaptic = mi_presynaptic;
-    using ByPostsynaptic = mi_postsynaptic;
-
-    mutable Index index_;
+    // Indexes are mutable so we can reindex a const object that has a non-updated index.
+    mutable SynapseIndex presynaptic_index_;
+    mutable SynapseIndex postsynaptic_index_;
     mutable bool is_index_updated_ = false;
 
+    // Procedural projection keeps only the connectivity description and offsets of synapses of each presynaptic
+    // neuron. The convolution description is shared with the generator of a convolutional projection. All of them are
+    // reset when synapses are materialized.
+    mutable std::optional<ProceduralConnectivity> procedural_;
+    mutable std::vector<size_t> procedural_offsets_;
+    mutable std::shared_ptr<const Convolution> convolution_;
+
+    // Mapped projection reads synapses from a file until they are materialized.
+    mutable std::shared_ptr<const MappedSynapseFile> mapped_;
+
+    // Quantized synapses replace both synapse tuples and columns, but keep the synapse order, so the index stays valid
+    // when they are quantized or dequantized. Synapse tuples can cache dequantized synapses.
+    mutable std::shared_ptr<const QuantizedSynapses> quantized_;
+
     SharedSynapseParameters shared_parameters_;
 };
 
@@ -0,0 +1,193 @@
+/**
+ * @file quantized_synapses.h
+ * @brief Delta synapses with low-precision weights.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/synapse-traits/delta.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief Representation of synapse weights.
+ */
+enum class WeightQuantization
+{
+    /**
+     * @brief Weights are stored as 32-bit floats.
+     */
+    none,
+    /**
+     * @brief Weights are stored as IEEE 754 half-precision floats.
+     */
+    float16,
+    /**
+     * @brief Weights are stored as 8-bit integers multiplied by a scale shared by all synapses of a projection.
+     */
+    int8
+};
+
+
+/**
+ * @brief Convert a 32-bit float to a half-precision float.
+ * @details Values are rounded to the nearest even, values that are too large become infinity.
+ * @param value 32-bit float value.
+ * @return bits of the half-precision value.
+ */
+inline uint16_t float_to_float16(float value)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000U);
+    const uint32_t exponent = (bits >> 23) & 0xffU;
+    uint32_t mantissa = bits & 0x7fffffU;
+
+    if (0xffU == exponent) return static_cast<uint16_t>(sign | 0x7c00U | (mantissa ? 0x200U : 0U));
+
+    const int half_exponent = static_cast<int>(exponent) - 127 + 15;
+    if (half_exponent >= 0x1f) return static_cast<uint16_t>(sign | 0x7c00U);
+    if (half_exponent <= 0)
+    {
+        // The value is subnormal in half precision.
+        if (half_exponent < -10) return sign;
+        mantissa |= 0x800000U;
+        const auto shift = static_cast<uint32_t>(14 - half_exponent);
+        uint32_t half_mantissa = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1U << shift) - 1);
+        const uint32_t halfway = 1U << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half_mantissa & 1U))) ++half_mantissa;
+        return static_cast<uint16_t>(sign | half_mantissa);
+    }
+
+    // Rounding carry correctly moves to the exponent.
+    uint32_t half = sign | (static_cast<uint32_t>(half_exponent) << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1fffU;
+    if (remainder > 0x1000U || (remainder == 0x1000U && (half & 1U))) ++half;
+    return static_cast<uint16_t>(half);
+}
+
+
+/**
+ * @brief Convert a half-precision float to a 32-bit float.
+ * @param value bits of the half-precision value.
+ * @return 32-bit float value.
+ */
+inline float float16_to_float(uint16_t value)
+{
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000U) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1fU;
+    const uint32_t mantissa = value & 0x3ffU;
+
+    if (0 == exponent)
+    {
+        const float result = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -result : result;
+    }
+
+    const uint32_t bits = sign | (0x1fU == exponent ? 0x7f800000U : (exponent + 112) << 23) | (mantissa << 13);
+    float result = 0;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+
+/**
+ * @brief Delta synapses with low-precision weights stored as a structure of arrays.
+ * @details Only one of the weight arrays is used, depending on the quantization type.
+ */
+struct QuantizedSynapses
+{
+    /**
+     * @brief Parameters of the delta synapse.
+     */
+    using SynapseParameters = synapse_traits::synapse_parameters<synapse_traits::DeltaSynapse>;
+
+    /**
+     * @brief Weight representation.
+     */
+    WeightQuantization quantization_ = WeightQuantization::float16;
+    /**
+     * @brief Scale of `int8` weights.
+     */
+    float scale_ = 1;
+    /**
+     * @brief Half-precision weights.
+     */
+    std::vector<uint16_t> float16_weights_;
+    /**
+     * @brief 8-bit integer weights.
+     */
+    std::vector<int8_t> int8_weights_;
+    /**
+     * @brief Synaptic delays.
+     */
+    std::vector<uint32_t> delays_;
+    /**
+     * @brief Synapse output types.
+     */
+    std::vector<uint8_t> output_types_;
+    /**
+     * @brief Indexes of presynaptic neurons.
+     */
+    std::vector<uint32_t> source_neurons_;
+    /**
+     * @brief Indexes of postsynaptic neurons.
+     */
+    std::vector<uint32_t> target_neurons_;
+
+    /**
+     * @brief Count number of synapses.
+     * @return number of synapses.
+     */
+    [[nodiscard]] size_t size() const { return source_neurons_.size(); }
+
+    /**
+     * @brief Get dequantized synapse weight.
+     * @param index synapse index.
+     * @return synapse weight.
+     */
+    [[nodiscard]] float get_weight(size_t index) const
+    {
+        return WeightQuantization::int8 == quantization_ ? static_cast<float>(int8_weights_[index]) * scale_
+                                                         : float16_to_float(float16_weights_[index]);
+    }
+
+    /**
+     * @brief Get synapse parameters with dequantized weight.
+     * @param index synapse index.
+     * @return synapse parameters.
+     */
+    [[nodiscard]] SynapseParameters get_parameters(size_t index) const
+    {
+        return {get_weight(index), delays_[index], static_cast<synapse_traits::OutputType>(output_types_[index])};
+    }
+};
+
+}  // namespace knp::core
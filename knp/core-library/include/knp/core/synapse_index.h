@@ -0,0 +1,459 @@
+/**
+ * @file synapse_index.h
+ * @brief Compressed sparse row index of projection synapses.
+ * @kaspersky_support Artiom N.
+ * @date 16.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief The SynapseIndex class is a compressed sparse row (CSR) index that maps a neuron index to indexes of
+ * the synapses associated with this neuron.
+ * @details The index contains row offsets and synapse indexes. Synapse indexes of a single neuron are stored
+ * contiguously and in ascending order, so a lookup does not allocate memory. Rows can have free slots, which allows
+ * adding synapses without rebuilding the whole index.
+ */
+class SynapseIndex
+{
+public:
+    /**
+     * @brief The Range class is a non-owning view of synapse indexes that belong to a single neuron.
+     * @details A range either refers to stored synapse indexes or represents a sequence of consecutive synapse indexes,
+     * which is not stored.
+     * @note A range of stored indexes remains valid until the index is rebuilt or cleared.
+     */
+    class Range
+    {
+    public:
+        /**
+         * @brief Iterator over synapse indexes of a range.
+         */
+        class Iterator
+        {
+        public:
+            /**
+             * @brief Iterator category.
+             */
+            using iterator_category = std::forward_iterator_tag;
+            /**
+             * @brief Type of synapse indexes.
+             */
+            using value_type = size_t;
+            /**
+             * @brief Type of the distance between iterators.
+             */
+            using difference_type = std::ptrdiff_t;
+            /**
+             * @brief Pointer type.
+             */
+            using pointer = const size_t *;
+            /**
+             * @brief Synapse indexes are returned by value.
+             */
+            using reference = size_t;
+
+            /**
+             * @brief Construct an iterator.
+             * @param synapses stored synapse indexes or `nullptr` if the position is the synapse index.
+             * @param position position in stored synapse indexes or synapse index.
+             */
+            Iterator(const size_t *synapses, size_t position) : synapses_(synapses), position_(position) {}
+
+            /**
+             * @brief Get synapse index.
+             * @return synapse index.
+             */
+            [[nodiscard]] size_t operator*() const { return synapses_ ? synapses_[position_] : position_; }
+
+            /**
+             * @brief Move to the next synapse index.
+             * @return reference to the iterator.
+             */
+            Iterator &operator++()
+            {
+                ++position_;
+                return *this;
+            }
+
+            /**
+             * @brief Move to the next synapse index.
+             * @return iterator before the increment.
+             */
+            Iterator operator++(int)
+            {
+                Iterator result = *this;
+                ++position_;
+                return result;
+            }
+
+            /**
+             * @brief Compare iterators of the same range.
+             * @param other other iterator.
+             * @return `true` if iterators point to the same synapse index.
+             */
+            [[nodiscard]] bool operator==(const Iterator &other) const { return position_ == other.position_; }
+
+            /**
+             * @brief Compare iterators of the same range.
+             * @param other other iterator.
+             * @return `true` if iterators point to different synapse indexes.
+             */
+            [[nodiscard]] bool operator!=(const Iterator &other) const { return position_ != other.position_; }
+
+        private:
+            const size_t *synapses_;
+            size_t position_;
+        };
+
+        /**
+         * @brief Construct an empty range.
+         */
+        Range() = default;
+
+        /**
+         * @brief Construct a range from a pair of pointers.
+         * @param begin pointer to the first synapse index.
+         * @param end pointer past the last synapse index.
+         */
+        Range(const size_t *begin, const size_t *end) : synapses_(begin), end_(static_cast<size_t>(end - begin)) {}
+
+        /**
+         * @brief Create a range of consecutive synapse indexes that are not stored.
+         * @param first first synapse index.
+         * @param last synapse index past the last synapse index of the range.
+         * @return range of synapse indexes.
+         */
+        [[nodiscard]] static Range make_sequence(size_t first, size_t last)
+        {
+            Range range;
+            range.begin_ = first;
+            range.end_ = std::max(first, last);
+            return range;
+        }
+
+        /**
+         * @brief Get an iterator pointing to the first synapse index.
+         * @return iterator.
+         */
+        [[nodiscard]] Iterator begin() const { return {synapses_, begin_}; }
+
+        /**
+         * @brief Get an iterator pointing past the last synapse index.
+         * @return iterator.
+         */
+        [[nodiscard]] Iterator end() const { return {synapses_, end_}; }
+
+        /**
+         * @brief Get number of synapse indexes in the range.
+         * @return number of synapses.
+         */
+        [[nodiscard]] size_t size() const { return end_ - begin_; }
+
+        /**
+         * @brief Check if the range is empty.
+         * @return `true` if the range contains no synapses.
+         */
+        [[nodiscard]] bool empty() const { return begin_ == end_; }
+
+        /**
+         * @brief Get synapse index by its position in the range.
+         * @param pos position in the range.
+         * @return synapse index.
+         */
+        [[nodiscard]] size_t operator[](size_t pos) const { return synapses_ ? synapses_[pos] : begin_ + pos; }
+
+    private:
+        // Stored synapse indexes, or `nullptr` if the range is a sequence from `begin_` to `end_`.
+        const size_t *synapses_ = nullptr;
+        size_t begin_ = 0;
+        size_t end_ = 0;
+    };
+
+public:
+    /**
+     * @brief Value that marks a removed synapse in the `remap()` argument.
+     */
+    static constexpr size_t removed_synapse = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief Maximum share of slots that do not belong to any row, after which the index is compacted.
+     */
+    static constexpr double max_fragmentation = 0.5;
+
+    /**
+     * @brief Number of slots that do not belong to any row, below which the index is never compacted.
+     */
+    static constexpr size_t min_compacted_slots = 4096;
+
+    /**
+     * @brief Rebuild the index.
+     * @details The index is built with a counting sort in two passes over synapses, so its complexity is
+     * `O(synapses_count + neurons_count)`.
+     * @tparam KeyGetter type of the functor that returns a neuron index for a synapse index.
+     * @param synapses_count number of synapses.
+     * @param get_key functor that returns the neuron index by which the synapse is indexed.
+     */
+    template <class KeyGetter>
+    void build(size_t synapses_count, KeyGetter &&get_key)
+    {
+        row_sizes_.clear();
+        for (size_t synapse_index = 0; synapse_index < synapses_count; ++synapse_index)
+        {
+            const size_t key = get_key(synapse_index);
+            if (key >= row_sizes_.size()) row_sizes_.resize(key + 1, 0);
+            ++row_sizes_[key];
+        }
+
+        row_begins_.resize(row_sizes_.size());
+        size_t row_begin = 0;
+        for (size_t row = 0; row < row_sizes_.size(); ++row)
+        {
+            row_begins_[row] = row_begin;
+            row_begin += row_sizes_[row];
+        }
+        row_capacities_ = row_sizes_;
+        capacity_count_ = synapses_count;
+
+        // Row sizes are recalculated during the fill pass.
+        std::fill(row_sizes_.begin(), row_sizes_.end(), 0);
+        synapses_.resize(synapses_count);
+        for (size_t synapse_index = 0; synapse_index < synapses_count; ++synapse_index)
+        {
+            const size_t key = get_key(synapse_index);
+            synapses_[row_begins_[key] + row_sizes_[key]++] = synapse_index;
+        }
+    }
+
+    /**
+     * @brief Rebuild the index using several threads.
+     * @details Each thread counts and places synapses of its own contiguous range. Synapses of a single neuron remain
+     * sorted, as ranges of the threads are placed in a row one after another.
+     * @tparam KeyGetter type of the functor that returns a neuron index for a synapse index.
+     * @param synapses_count number of synapses.
+     * @param get_key thread-safe functor that returns the neuron index by which the synapse is indexed.
+     * @param thread_count number of threads.
+     */
+    template <class KeyGetter>
+    void build(size_t synapses_count, KeyGetter &&get_key, size_t thread_count)
+    {
+        thread_count = std::min(thread_count, synapses_count);
+        if (thread_count < 2)
+        {
+            build(synapses_count, get_key);
+            return;
+        }
+
+        auto run_parallel = [synapses_count, thread_count](auto &&function)
+        {
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count);
+            for (size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+            {
+                threads.emplace_back(
+                    function, thread_index, synapses_count * thread_index / thread_count,
+                    synapses_count * (thread_index + 1) / thread_count);
+            }
+            for (auto &thread : threads) thread.join();
+        };
+
+        // Cursors contain row sizes of each thread range after the first pass, and write positions after that.
+        std::vector<std::vector<size_t>> cursors(thread_count);
+        run_parallel(
+            [&cursors, &get_key](size_t thread_index, size_t range_begin, size_t range_end)
+            {
+                auto &row_sizes = cursors[thread_index];
+                for (size_t synapse_index = range_begin; synapse_index < range_end; ++synapse_index)
+                {
+                    const size_t key = get_key(synapse_index);
+                    if (key >= row_sizes.size()) row_sizes.resize(key + 1, 0);
+                    ++row_sizes[key];
+                }
+            });
+
+        size_t rows_count = 0;
+        for (const auto &row_sizes : cursors) rows_count = std::max(rows_count, row_sizes.size());
+        row_begins_.resize(rows_count);
+        row_sizes_.assign(rows_count, 0);
+        size_t row_begin = 0;
+        for (size_t row = 0; row < rows_count; ++row)
+        {
+            row_begins_[row] = row_begin;
+            for (auto &row_sizes : cursors)
+            {
+                if (row >= row_sizes.size()) continue;
+                const size_t thread_row_size = row_sizes[row];
+                row_sizes[row] = row_begin;
+                row_begin += thread_row_size;
+            }
+            row_sizes_[row] = row_begin - row_begins_[row];
+        }
+        row_capacities_ = row_sizes_;
+        capacity_count_ = synapses_count;
+
+        synapses_.resize(synapses_count);
+        run_parallel(
+            [this, &cursors, &get_key](size_t thread_index, size_t range_begin, size_t range_end)
+            {
+                auto &row_cursors = cursors[thread_index];
+                for (size_t synapse_index = range_begin; synapse_index < range_end; ++synapse_index)
+                {
+                    synapses_[row_cursors[get_key(synapse_index)]++] = synapse_index;
+                }
+            });
+    }
+
+    /**
+     * @brief Add a synapse to the index.
+     * @details A row that has no free slots is moved to the end of the index with doubled capacity, so the amortized
+     * complexity is `O(1)`. Slots of the moved row become unused. The index is compacted if the share of unused
+     * slots exceeds `max_fragmentation` and there are at least `min_compacted_slots` unused slots.
+     * @param synapse_index synapse index. It must be greater than indexes of all synapses in the index.
+     * @param neuron_index neuron index by which the synapse is indexed.
+     */
+    void append(size_t synapse_index, size_t neuron_index)
+    {
+        if (neuron_index >= row_sizes_.size())
+        {
+            row_begins_.resize(neuron_index + 1, synapses_.size());
+            row_sizes_.resize(neuron_index + 1, 0);
+            row_capacities_.resize(neuron_index + 1, 0);
+        }
+
+        if (row_sizes_[neuron_index] == row_capacities_[neuron_index])
+        {
+            const size_t row_begin = row_begins_[neuron_index];
+            const size_t row_size = row_sizes_[neuron_index];
+            const size_t new_capacity = std::max<size_t>(2 * row_size, 4);
+            const size_t new_begin = synapses_.size();
+            synapses_.resize(new_begin + new_capacity);
+            std::copy(
+                synapses_.begin() + static_cast<std::ptrdiff_t>(row_begin),
+                synapses_.begin() + static_cast<std::ptrdiff_t>(row_begin + row_size),
+                synapses_.begin() + static_cast<std::ptrdiff_t>(new_begin));
+            row_begins_[neuron_index] = new_begin;
+            capacity_count_ += new_capacity - row_capacities_[neuron_index];
+            row_capacities_[neuron_index] = new_capacity;
+            compact_if_fragmented();
+        }
+
+        synapses_[row_begins_[neuron_index] + row_sizes_[neuron_index]++] = synapse_index;
+    }
+
+    /**
+     * @brief Update synapse indexes after synapses were removed from the projection.
+     * @details Relative order of the remaining synapses must be preserved. Freed slots remain in their rows and are
+     * reused by `append()`. Complexity is `O(synapses_count)`.
+     * @param new_indexes new index of each synapse or `removed_synapse` if the synapse was removed.
+     */
+    void remap(const std::vector<size_t> &new_indexes)
+    {
+        for (size_t row = 0; row < row_sizes_.size(); ++row)
+        {
+            const size_t row_begin = row_begins_[row];
+            size_t new_size = 0;
+            for (size_t pos = row_begin; pos < row_begin + row_sizes_[row]; ++pos)
+            {
+                const size_t new_index = new_indexes[synapses_[pos]];
+                if (removed_synapse != new_index) synapses_[row_begin + new_size++] = new_index;
+            }
+            row_sizes_[row] = new_size;
+        }
+    }
+
+    /**
+     * @brief Remove all elements from the index.
+     */
+    void clear()
+    {
+        row_begins_.clear();
+        row_sizes_.clear();
+        row_capacities_.clear();
+        synapses_.clear();
+        capacity_count_ = 0;
+    }
+
+    /**
+     * @brief Find indexes of synapses associated with a neuron.
+     * @param neuron_index neuron index.
+     * @return range of synapse indexes in ascending order.
+     */
+    [[nodiscard]] Range find(size_t neuron_index) const
+    {
+        if (neuron_index >= row_sizes_.size()) return {};
+        const size_t *row_begin = synapses_.data() + row_begins_[neuron_index];
+        return {row_begin, row_begin + row_sizes_[neuron_index]};
+    }
+
+    /**
+     * @brief Get number of neuron rows in the index.
+     * @return maximum indexed neuron index plus one.
+     */
+    [[nodiscard]] size_t rows_count() const { return row_sizes_.size(); }
+
+    /**
+     * @brief Get share of index slots that do not belong to any row.
+     * @return value from `0` to `1`.
+     */
+    [[nodiscard]] double get_fragmentation() const
+    {
+        return synapses_.empty() ? 0.
+                                 : 1. - static_cast<double>(capacity_count_) / static_cast<double>(synapses_.size());
+    }
+
+private:
+    void compact_if_fragmented()
+    {
+        if (synapses_.size() - capacity_count_ < min_compacted_slots || get_fragmentation() <= max_fragmentation)
+            return;
+
+        // Rows keep free slots, so that compaction doesn't make the next appends move rows again.
+        std::vector<size_t> synapses;
+        synapses.reserve(capacity_count_);
+        for (size_t row = 0; row < row_sizes_.size(); ++row)
+        {
+            const auto row_synapses = find(row);
+            row_begins_[row] = synapses.size();
+            synapses.insert(synapses.end(), row_synapses.begin(), row_synapses.end());
+            synapses.resize(synapses.size() + row_capacities_[row] - row_sizes_[row]);
+        }
+        synapses_ = std::move(synapses);
+    }
+
+private:
+    std::vector<size_t> row_begins_;
+    std::vector<size_t> row_sizes_;
+    std::vector<size_t> row_capacities_;
+    std::vector<size_t> synapses_;
+    size_t capacity_count_ = 0;
+};
+
+}  // namespace knp::core
@@ -75,7 +75,7 @@ struct default_values<AltAILIF>
      * @brief The parameter defines the default value for `saturate_` flag of AltAILIF neuron.
      * @details If `saturate_` flag is set to `true` and the neuron potential is less than
      * a negative `negative_activation_threshold_` value after the neuron receives a spike,
-     * the `potential_` parameter takes the `negative_activation_threshold_` value.
+     * the `potential_` parameter takes the `-negative_activation_threshold_` value.
      */
     constexpr static bool saturate_ = true;
 
@@ -135,10 +135,10 @@ struct neuron_parameters<AltAILIF>
      * }
      * else if (potential_ < -negative_activation_threshold_)
      * {
-     *  if (saturate_) potential_ = negative_activation_threshold_;
+     *  if (saturate_) potential_ = -negative_activation_threshold_;
      *  else {
      *      if (is_reset_) potential_ = -potential_reset_value_;
-     *      else if (is_diff_) potential_ -= negative_activation_threshold_;
+     *      else if (is_diff_) potential_ += negative_activation_threshold_;
      *  }
      * }
      * @endcode
@@ -158,10 +158,10 @@ struct neuron_parameters<AltAILIF>
      * }
      * else if (potential_ < -negative_activation_threshold_)
      * {
-     *  if (saturate_) potential_ = negative_activation_threshold_;
+     *  if (saturate_) potential_ = -negative_activation_threshold_;
      *  else {
      *      if (is_reset_) potential_ = -potential_reset_value_;
-     *      else if (is_diff_) potential_ -= negative_activation_threshold_;
+     *      else if (is_diff_) potential_ += negative_activation_threshold_;
      *  }
      * }
      * @endcode
@@ -184,7 +184,7 @@ struct neuron_parameters<AltAILIF>
     /**
      * @brief If `saturate_` flag is set to `true` and the neuron potential is less than
      * a negative `negative_activation_threshold_` value after the neuron receives a spike,
-     * the `potential_` parameter takes the `negative_activation_threshold_` value.
+     * the `potential_` parameter takes the `-negative_activation_threshold_` value.
      * @details The code below demonstrates the logic of after-spike flags for AltAILIF neuron:
      * @code{.cpp}
      * if (potential_ >= activation_threshold_)
@@ -194,10 +194,10 @@ struct neuron_parameters<AltAILIF>
      * }
      * else if (potential_ < -negative_activation_threshold_)
      * {
-     *  if (saturate_) potential_ = negative_activation_threshold_;
+     *  if (saturate_) potential_ = -negative_activation_threshold_;
      *  else {
      *      if (is_reset_) potential_ = -potential_reset_value_;
-     *      else if (is_diff_) potential_ -= negative_activation_threshold_;
+     *      else if (is_diff_) potential_ += negative_activation_threshold_;
      *  }
      * }
      * @endcode
@@ -257,10 +257,10 @@ struct neuron_parameters<AltAILIF>
      * }
      * else if (potential_ < -negative_activation_threshold_)
      * {
-     *  if (saturate_) potential_ = negative_activation_threshold_;
+     *  if (saturate_) potential_ = -negative_activation_threshold_;
      *  else {
      *      if (is_reset_) potential_ = -potential_reset_value_;
-     *      else if (is_diff_) potential_ -= negative_activation_threshold_;
+     *      else if (is_diff_) potential_ += negative_activation_threshold_;
      *  }
      * }
      * @endcode
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <limits>
 #include <numeric>
 #include <utility>
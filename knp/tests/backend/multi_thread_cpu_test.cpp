@@ -20,8 +20,10 @@
  */
 
 #include <knp/backends/cpu-multi-threaded/backend.h>
+#include <knp/backends/thread_pool/numa_topology.h>
 #include <knp/backends/thread_pool/thread_pool_context.h>
 #include <knp/backends/thread_pool/thread_pool_executor.h>
+#include <knp/backends/thread_pool/work_stealing_pool.h>
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
 
@@ -29,7 +31,15 @@
 #include <spdlog/spdlog.h>
 #include <tests_common.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
 #include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
 #include <vector>
 
 
@@ -44,6 +54,7 @@ class MTestingBack : public knp::backends::multi_threaded_cpu::MultiThreadedCPUB
 {
 public:
     MTestingBack() = default;
+    using knp::backends::multi_threaded_cpu::MultiThreadedCPUBackend::MultiThreadedCPUBackend;
     void _init() override { knp::backends::multi_threaded_cpu::MultiThreadedCPUBackend::_init(); }
 };
 
@@ -117,6 +128,463 @@ TEST(MultiThreadCpuSuite, SmallestNetwork)
 }
 
 
+TEST(MultiThreadCpuSuite, ProceduralSmallestNetwork)
+{
+    // Create the smallest network with a procedural loop projection, which must behave as a stored one.
+
+    namespace kt = knp::testing;
+    kt::MTestingBack backend;
+
+    kt::BLIFATPopulation population{kt::neuron_generator, 1};
+    Projection loop_projection = kt::DeltaProjection{
+        population.get_uid(), population.get_uid(),
+        kt::DeltaProjection::ProceduralConnectivity{
+            [](size_t, std::vector<kt::DeltaProjection::Synapse> &synapses)
+            { synapses.push_back(kt::synapse_generator(0).value()); },
+            1}};
+    Projection input_projection =
+        kt::DeltaProjection{knp::core::UID{false}, population.get_uid(), kt::input_projection_gen, 1};
+    knp::core::UID input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+
+    backend.load_populations({population});
+    backend.load_projections({input_projection, loop_projection});
+
+    auto endpoint = backend.get_message_bus().create_endpoint();
+
+    knp::core::UID in_channel_uid;
+    knp::core::UID out_channel_uid;
+
+    // Create input and output.
+    backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+    endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+    std::vector<knp::core::Step> results;
+
+    backend._init();
+
+    for (knp::core::Step step = 0; step < 20; ++step)
+    {
+        // Send inputs on steps 0, 5, 10, 15.
+        send_messages_smallest_network(in_channel_uid, endpoint, step);
+        backend._step();
+        if (receive_messages_smallest_network(out_channel_uid, endpoint)) results.push_back(step);
+    }
+
+    // Spikes on steps "5n + 1" (input) and on "previous_spike_n + 6" (positive feedback loop).
+    const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+    ASSERT_EQ(results, expected_results);
+}
+
+
+TEST(MultiThreadCpuSuite, StructureOfArraysSmallestNetwork)
+{
+    // Create the smallest network with a population stored as a structure of arrays, which must behave as usual in
+    // any precision.
+
+    namespace kt = knp::testing;
+
+    for (const auto storage :
+         {knp::core::NeuronStorage::structure_of_arrays, knp::core::NeuronStorage::single_precision_structure_of_arrays,
+          knp::core::NeuronStorage::precision_validation, knp::core::NeuronStorage::shared_parameters})
+    {
+        kt::MTestingBack backend;
+
+        kt::BLIFATPopulation population{kt::neuron_generator, 1};
+        population.set_storage(storage);
+        Projection loop_projection =
+            kt::DeltaProjection{population.get_uid(), population.get_uid(), kt::synapse_generator, 1};
+        Projection input_projection =
+            kt::DeltaProjection{knp::core::UID{false}, population.get_uid(), kt::input_projection_gen, 1};
+        knp::core::UID input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+
+        backend.load_populations({population});
+        backend.load_projections({input_projection, loop_projection});
+
+        auto endpoint = backend.get_message_bus().create_endpoint();
+
+        knp::core::UID in_channel_uid;
+        knp::core::UID out_channel_uid;
+
+        // Create input and output.
+        backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+        endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+        std::vector<knp::core::Step> results;
+
+        backend._init();
+
+        for (knp::core::Step step = 0; step < 20; ++step)
+        {
+            // Send inputs on steps 0, 5, 10, 15.
+            send_messages_smallest_network(in_channel_uid, endpoint, step);
+            backend._step();
+            if (receive_messages_smallest_network(out_channel_uid, endpoint)) results.push_back(step);
+        }
+
+        // Spikes on steps "5n + 1" (input) and on "previous_spike_n + 6" (positive feedback loop).
+        const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+        ASSERT_EQ(results, expected_results);
+    }
+}
+
+
+TEST(MultiThreadCpuSuite, DenseDeliverySmallestNetwork)
+{
+    // Create the smallest network with projections that add impacts to dense inputs of the population.
+
+    namespace kt = knp::testing;
+    kt::MTestingBack backend;
+
+    kt::BLIFATPopulation population{kt::neuron_generator, 1};
+    kt::DeltaProjection loop_delta_projection{population.get_uid(), population.get_uid(), kt::synapse_generator, 1};
+    kt::DeltaProjection input_delta_projection{
+        knp::core::UID{false}, population.get_uid(), kt::input_projection_gen, 1};
+    loop_delta_projection.set_dense_delivery(true);
+    input_delta_projection.set_dense_delivery(true);
+    knp::core::UID loop_uid = loop_delta_projection.get_uid();
+    knp::core::UID input_uid = input_delta_projection.get_uid();
+
+    backend.load_populations({population});
+    backend.load_projections({input_delta_projection, loop_delta_projection});
+
+    auto endpoint = backend.get_message_bus().create_endpoint();
+
+    knp::core::UID in_channel_uid;
+    knp::core::UID out_channel_uid;
+    knp::core::UID impact_channel_uid;
+
+    // Create input and output.
+    backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+    endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+    endpoint.subscribe<knp::core::messaging::SynapticImpactMessage>(impact_channel_uid, {loop_uid});
+
+    std::vector<knp::core::Step> results;
+
+    backend._init();
+
+    for (knp::core::Step step = 0; step < 20; ++step)
+    {
+        // Send inputs on steps 0, 5, 10, 15.
+        send_messages_smallest_network(in_channel_uid, endpoint, step);
+        backend._step();
+        if (receive_messages_smallest_network(out_channel_uid, endpoint)) results.push_back(step);
+    }
+
+    // Spikes on steps "5n + 1" (input) and on "previous_spike_n + 6" (positive feedback loop).
+    const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+    ASSERT_EQ(results, expected_results);
+    // Impacts are not sent as messages.
+    ASSERT_TRUE(endpoint.unload_messages<knp::core::messaging::SynapticImpactMessage>(impact_channel_uid).empty());
+}
+
+
+TEST(MultiThreadCpuSuite, PartitionedPopulationNetwork)
+{
+    // Create a network of independent copies of the smallest network, so that population inputs are processed by
+    // several parts, the last of which is incomplete.
+    constexpr size_t neurons_count = 10;
+    constexpr size_t population_part_size = 3;
+
+    namespace kt = knp::testing;
+
+    auto run_network = [](auto population, bool is_numa_aware = false)
+    {
+        kt::MTestingBack backend{
+            0, population_part_size, knp::backends::multi_threaded_cpu::default_projection_part_size, is_numa_aware};
+
+        Projection loop_projection = kt::DeltaProjection{
+            population.get_uid(), population.get_uid(),
+            [](size_t index)
+            {
+                return kt::DeltaProjection::Synapse{
+                    {1.0, 6, knp::synapse_traits::OutputType::EXCITATORY}, index, index};
+            },
+            neurons_count};
+        Projection input_projection = kt::DeltaProjection{
+            knp::core::UID{false}, population.get_uid(),
+            [](size_t index)
+            { return kt::DeltaProjection::Synapse{{1.0, 1, knp::synapse_traits::OutputType::EXCITATORY}, 0, index}; },
+            neurons_count};
+        knp::core::UID input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+
+        backend.load_populations({population});
+        backend.load_projections({input_projection, loop_projection});
+
+        auto endpoint = backend.get_message_bus().create_endpoint();
+
+        knp::core::UID in_channel_uid;
+        knp::core::UID out_channel_uid;
+
+        backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+        endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+        std::vector<knp::core::Step> results;
+
+        backend._init();
+
+        for (knp::core::Step step = 0; step < 20; ++step)
+        {
+            send_messages_smallest_network(in_channel_uid, endpoint, step);
+            backend._step();
+            endpoint.receive_all_messages();
+            auto messages = endpoint.unload_messages<knp::core::messaging::SpikeMessage>(out_channel_uid);
+            if (messages.empty()) continue;
+            // All neurons get the same inputs, so they spike together, and parts add their spikes in order.
+            EXPECT_EQ(messages.size(), 1);
+            knp::core::messaging::SpikeData expected_indexes(neurons_count);
+            std::iota(expected_indexes.begin(), expected_indexes.end(), 0);
+            EXPECT_EQ(messages[0].neuron_indexes_, expected_indexes);
+            results.push_back(step);
+        }
+
+        // All workers are assigned to nodes.
+        size_t workers_count = 0;
+        for (const auto &load : backend.get_numa_node_loads()) workers_count += load.workers_count_;
+        EXPECT_EQ(workers_count, std::thread::hardware_concurrency());
+        return results;
+    };
+
+    const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+    ASSERT_EQ(run_network(kt::BLIFATPopulation{kt::neuron_generator, neurons_count}), expected_results);
+    ASSERT_EQ(run_network(kt::AltAILIFPopulation{kt::altai_lif_neuron_generator, neurons_count}), expected_results);
+
+    auto event_driven_population = kt::BLIFATPopulation{kt::neuron_generator, neurons_count};
+    event_driven_population.set_event_driven(true);
+    ASSERT_EQ(run_network(event_driven_population), expected_results);
+
+    // Parts bound to NUMA nodes give the same results.
+    ASSERT_EQ(run_network(kt::BLIFATPopulation{kt::neuron_generator, neurons_count}, true), expected_results);
+}
+
+
+TEST(MultiThreadCpuSuite, PartSizeTuningTest)
+{
+    namespace kt = knp::testing;
+    using knp::backends::multi_threaded_cpu::PartSizeTuner;
+
+    const auto profile_path = std::filesystem::temp_directory_path() / "knp_part_size_profile.txt";
+    kt::BLIFATPopulation population{kt::neuron_generator, 1};
+    Projection loop_projection =
+        kt::DeltaProjection{population.get_uid(), population.get_uid(), kt::synapse_generator, 1};
+    Projection input_projection =
+        kt::DeltaProjection{knp::core::UID{false}, population.get_uid(), kt::input_projection_gen, 1};
+    knp::core::UID input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+    knp::core::UID loop_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, loop_projection);
+
+    {
+        kt::MTestingBack backend;
+        backend.start_part_size_tuning(3);
+
+        backend.load_populations({population});
+        backend.load_projections({input_projection, loop_projection});
+
+        auto endpoint = backend.get_message_bus().create_endpoint();
+
+        knp::core::UID in_channel_uid;
+        knp::core::UID out_channel_uid;
+
+        backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+        endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+        std::vector<knp::core::Step> results;
+
+        backend._init();
+
+        for (knp::core::Step step = 0; step < 20; ++step)
+        {
+            send_messages_smallest_network(in_channel_uid, endpoint, step);
+            backend._step();
+            if (receive_messages_smallest_network(out_channel_uid, endpoint)) results.push_back(step);
+        }
+
+        // Tuning doesn't change results.
+        const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+        ASSERT_EQ(results, expected_results);
+
+        // Steps 1-3 are measured after the first step. Entities smaller than the minimal part size get the minimal
+        // part size, and the input projection, which gets no spikes on these steps, keeps the default part size.
+        ASSERT_FALSE(backend.is_tuning_part_sizes());
+        ASSERT_EQ(backend.get_population_part_size(population.get_uid()), PartSizeTuner::min_part_size);
+        ASSERT_EQ(backend.get_projection_part_size(loop_uid), PartSizeTuner::min_part_size);
+        ASSERT_EQ(
+            backend.get_projection_part_size(input_uid),
+            knp::backends::multi_threaded_cpu::default_projection_part_size);
+        backend.save_part_size_profile(profile_path);
+    }
+
+    // A new backend starts with part sizes from the profile.
+    kt::MTestingBack backend;
+    backend.load_part_size_profile(profile_path);
+    ASSERT_EQ(backend.get_population_part_size(population.get_uid()), PartSizeTuner::min_part_size);
+    ASSERT_EQ(backend.get_projection_part_size(loop_uid), PartSizeTuner::min_part_size);
+
+    std::ofstream(profile_path) << "corrupted profile";
+    ASSERT_THROW(backend.load_part_size_profile(profile_path), std::runtime_error);
+    std::filesystem::remove(profile_path);
+    ASSERT_THROW(backend.load_part_size_profile(profile_path), std::runtime_error);
+}
+
+
+TEST(MultiThreadCpuSuite, PipelinedStepEquivalence)
+{
+    // Create a recurrent network with different synapse delays, so that impacts of several steps are in flight.
+    constexpr size_t neurons_count = 20;
+    constexpr knp::core::Step steps_count = 40;
+
+    namespace kt = knp::testing;
+
+    auto run_network = [](uint32_t min_delay, bool is_pipelined)
+    {
+        kt::MTestingBack backend{0, 4, 7};
+        if (is_pipelined) backend.set_pipelined_execution(true, 1);
+
+        kt::BLIFATPopulation population{kt::neuron_generator, neurons_count};
+        Projection loop_projection = kt::DeltaProjection{
+            population.get_uid(), population.get_uid(),
+            [min_delay](size_t index)
+            {
+                return kt::DeltaProjection::Synapse{
+                    {index % 3 ? 1.0F : 0.5F, static_cast<uint32_t>(min_delay + index % 4),
+                     knp::synapse_traits::OutputType::EXCITATORY},
+                    index % neurons_count, (index * 7 + 3) % neurons_count};
+            },
+            2 * neurons_count};
+        Projection input_projection = kt::DeltaProjection{
+            knp::core::UID{false}, population.get_uid(),
+            [min_delay](size_t index)
+            {
+                return kt::DeltaProjection::Synapse{
+                    {1.0, static_cast<uint32_t>(min_delay + index % 2), knp::synapse_traits::OutputType::EXCITATORY},
+                    0, index * 3};
+            },
+            neurons_count / 3};
+        knp::core::UID input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+
+        backend.load_populations({population});
+        backend.load_projections({input_projection, loop_projection});
+        EXPECT_EQ(backend.get_min_synapse_delay(), min_delay);
+
+        auto endpoint = backend.get_message_bus().create_endpoint();
+
+        knp::core::UID in_channel_uid;
+        knp::core::UID out_channel_uid;
+
+        backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+        endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+        std::vector<knp::core::messaging::SpikeData> results(steps_count);
+
+        backend._init();
+
+        for (knp::core::Step step = 0; step < steps_count; ++step)
+        {
+            // Switching the mode calculates projections of the last pipelined step.
+            if (is_pipelined && 25 == step) backend.set_pipelined_execution(false);
+            if (is_pipelined && 30 == step) backend.set_pipelined_execution(true);
+            send_messages_smallest_network(in_channel_uid, endpoint, step);
+            backend._step();
+            endpoint.receive_all_messages();
+            auto messages = endpoint.unload_messages<knp::core::messaging::SpikeMessage>(out_channel_uid);
+            EXPECT_LE(messages.size(), 1);
+            if (!messages.empty()) results[step] = messages[0].neuron_indexes_;
+        }
+        return results;
+    };
+
+    const auto serial_results = run_network(2, false);
+    // The network must spike on several steps, so that the comparison is not trivial.
+    ASSERT_GT(
+        std::count_if(
+            serial_results.begin(), serial_results.end(), [](const auto &spikes) { return !spikes.empty(); }),
+        5);
+    ASSERT_EQ(run_network(2, true), serial_results);
+
+    // Steps of a network with delay 1 are calculated serially.
+    ASSERT_EQ(run_network(1, true), run_network(1, false));
+}
+
+
+TEST(MultiThreadCpuSuite, PipelinedThreadsAndDelayChange)
+{
+    namespace kt = knp::testing;
+
+    auto count_workers = [](const kt::MTestingBack &backend)
+    {
+        size_t workers_count = 0;
+        for (const auto &load : backend.get_numa_node_loads()) workers_count += load.workers_count_;
+        return workers_count;
+    };
+
+    kt::MTestingBack backend{4};
+    // Projection threads are taken from backend threads.
+    backend.set_pipelined_execution(true, 1);
+    ASSERT_EQ(count_workers(backend), 3);
+    backend.set_pipelined_execution(true, 10);
+    ASSERT_EQ(count_workers(backend), 1);
+    backend.set_pipelined_execution(false);
+    ASSERT_EQ(count_workers(backend), 4);
+
+    kt::BLIFATPopulation population{kt::neuron_generator, 2};
+    backend.load_projections({kt::DeltaProjection{
+        population.get_uid(), population.get_uid(),
+        [](size_t index)
+        {
+            return kt::DeltaProjection::Synapse{{1.0, 2, knp::synapse_traits::OutputType::EXCITATORY}, index, index};
+        },
+        2}});
+    ASSERT_EQ(backend.get_min_synapse_delay(), 2);
+
+    // Changing synapses through projection iterators resets the delay.
+    auto &projection = std::get<kt::DeltaProjection>(backend.begin_projections()->arg_);
+    std::get<knp::core::synapse_data>(projection[1]).delay_ = 1;
+    ASSERT_EQ(backend.get_min_synapse_delay(), 1);
+}
+
+
+TEST(MultiThreadCpuSuite, AltAILIFSmallestNetwork)
+{
+    // Create the smallest network with an integer AltAILIF population, which must spike as a BLIFAT one.
+
+    namespace kt = knp::testing;
+    kt::MTestingBack backend;
+
+    kt::AltAILIFPopulation population{kt::altai_lif_neuron_generator, 1};
+    Projection loop_projection =
+        kt::DeltaProjection{population.get_uid(), population.get_uid(), kt::synapse_generator, 1};
+    Projection input_projection =
+        kt::DeltaProjection{knp::core::UID{false}, population.get_uid(), kt::input_projection_gen, 1};
+    knp::core::UID input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+
+    backend.load_populations({population});
+    backend.load_projections({input_projection, loop_projection});
+
+    auto endpoint = backend.get_message_bus().create_endpoint();
+
+    knp::core::UID in_channel_uid;
+    knp::core::UID out_channel_uid;
+
+    // Create input and output.
+    backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+    endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+    std::vector<knp::core::Step> results;
+
+    backend._init();
+
+    for (knp::core::Step step = 0; step < 20; ++step)
+    {
+        // Send inputs on steps 0, 5, 10, 15.
+        send_messages_smallest_network(in_channel_uid, endpoint, step);
+        backend._step();
+        if (receive_messages_smallest_network(out_channel_uid, endpoint)) results.push_back(step);
+    }
+
+    // Spikes on steps "5n + 1" (input) and on "previous_spike_n + 6" (positive feedback loop).
+    const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+    ASSERT_EQ(results, expected_results);
+}
+
+
 TEST(MultiThreadCpuSuite, NeuronsGettingTest)
 {
     const knp::testing::MTestingBack backend;
@@ -184,3 +652,109 @@ TEST(MultiThreadCpuSuite, ThreadPoolTest)
     ASSERT_EQ(result[1], 445);
     ASSERT_EQ(result[0], result[7]);  // Delayed tasks should give the same results as the first ones.
 }
+
+
+TEST(MultiThreadCpuSuite, WorkStealingPoolTest)
+{
+    knp::backends::cpu_executors::WorkStealingPool pool(3);
+    const int num_iterations = 10;  // Corresponding Fibonacci number is 89.
+    std::vector<uint64_t> result(100, 0);
+    for (size_t i = 0; i < result.size(); ++i) pool.post(fibonacci, i, num_iterations, &result[i]);
+    pool.join();
+    for (size_t i = 0; i < result.size(); ++i) ASSERT_EQ(result[i], i * 89 % 1000);
+
+    // Check that pool is reusable, and that tasks too large to be stored in place and tasks posted by workers are
+    // executed.
+    std::array<uint64_t, 32> large_capture{};
+    std::atomic<uint64_t> sum = 0;
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        pool.post(
+            [&pool, &sum, large_capture, i]()
+            {
+                sum += large_capture[0] + i;
+                pool.post([&sum]() { ++sum; });
+            });
+    }
+    pool.join();
+    ASSERT_EQ(sum, 99 * 100 / 2 + 100);
+
+    // Check that tasks of phases are executed before the phase is finished. Fibonacci numbers of phases are 1, 2, 3.
+    for (size_t phase = 1; phase <= 3; ++phase)
+    {
+        for (size_t i = 0; i < result.size(); ++i) pool.post_to_phase(fibonacci, i, phase, &result[i]);
+        pool.run_phase();
+        for (size_t i = 0; i < result.size(); ++i) ASSERT_EQ(result[i], i * phase);
+    }
+
+    // Check that an exception of a task is thrown by `join()`.
+    pool.post([]() { throw std::runtime_error("Task failed."); });
+    ASSERT_THROW(pool.join(), std::runtime_error);
+    pool.join();
+}
+
+
+TEST(MultiThreadCpuSuite, NumaAwarePoolTest)
+{
+    namespace ke = knp::backends::cpu_executors;
+
+    ASSERT_EQ(ke::parse_cpu_list("0-3,8,10-11\n"), std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+    ASSERT_TRUE(ke::parse_cpu_list("").empty());
+    const auto nodes = ke::get_numa_nodes();
+    ASSERT_FALSE(nodes.empty());
+    for (const auto &node : nodes) ASSERT_FALSE(node.cpus_.empty());
+
+    ke::WorkStealingPool pool(4, true);
+    ASSERT_TRUE(pool.is_numa_aware());
+    ASSERT_GE(pool.nodes_count(), 1);
+    ASSERT_LE(pool.nodes_count(), nodes.size());
+
+    // Check that tasks bound to nodes and unbound tasks of a phase are all executed.
+    std::vector<uint64_t> result(100, 0);
+    for (size_t i = 0; i < result.size(); ++i)
+    {
+        if (i % 3)
+            pool.post_to_node_phase(i, fibonacci, i, 2, &result[i]);
+        else
+            pool.post_to_phase(fibonacci, i, 2, &result[i]);
+    }
+    pool.run_phase();
+    for (size_t i = 0; i < result.size(); ++i) ASSERT_EQ(result[i], i * 2);
+
+    const auto loads = pool.get_node_loads();
+    ASSERT_EQ(loads.size(), pool.nodes_count());
+    size_t workers_count = 0;
+    size_t tasks_count = 0;
+    for (const auto &load : loads)
+    {
+        workers_count += load.workers_count_;
+        tasks_count += load.tasks_count_;
+    }
+    ASSERT_EQ(workers_count, pool.size());
+    // Tasks executed by the thread that runs the phase are not counted.
+    ASSERT_LE(tasks_count, result.size());
+}
+
+
+TEST(MultiThreadCpuSuite, PoolCpuSharingTest)
+{
+    namespace ke = knp::backends::cpu_executors;
+    const std::vector<ke::NumaNode> nodes{{0, {100, 101}}, {1, {102, 103}}};
+
+    // Pools created one after another are pinned to different CPUs while there are free ones.
+    auto first_pool = std::make_unique<ke::WorkStealingPool>(1, false, nodes);
+    const ke::WorkStealingPool second_pool(1, false, nodes);
+    ASSERT_EQ(first_pool->get_worker_cpu(0), 100);
+    ASSERT_EQ(second_pool.get_worker_cpu(0), 101);
+
+    // CPUs of a destroyed pool are free again.
+    first_pool.reset();
+    const ke::WorkStealingPool third_pool(2, false, nodes);
+    ASSERT_EQ(third_pool.get_worker_cpu(0), 100);
+    ASSERT_EQ(third_pool.get_worker_cpu(1), 102);
+
+    // NUMA-aware pools take the least used CPUs of their nodes.
+    const ke::WorkStealingPool numa_pool(2, true, nodes);
+    ASSERT_EQ(numa_pool.get_worker_cpu(0), 100);
+    ASSERT_EQ(numa_pool.get_worker_cpu(1), 103);
+}
@@ -99,6 +99,206 @@ TEST(SingleThreadCpuSuite, SmallestNetwork)
 }
 
 
+TEST(SingleThreadCpuSuite, ProceduralSmallestNetwork)
+{
+    // Create the smallest network with a procedural loop projection, which must behave as a stored one.
+    knp::testing::STestingBack backend;
+
+    knp::testing::BLIFATPopulation population{knp::testing::neuron_generator, 1};
+    Projection loop_projection = knp::testing::DeltaProjection{
+        population.get_uid(), population.get_uid(),
+        knp::testing::DeltaProjection::ProceduralConnectivity{
+            [](size_t, std::vector<knp::testing::DeltaProjection::Synapse> &synapses)
+            { synapses.push_back(knp::testing::synapse_generator(0).value()); },
+            1}};
+    Projection input_projection = knp::testing::DeltaProjection{
+        knp::core::UID{false}, population.get_uid(), knp::testing::input_projection_gen, 1};
+    knp::core::UID const input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+
+    backend.load_populations({population});
+    backend.load_projections({input_projection, loop_projection});
+
+    backend._init();
+    auto endpoint = backend.get_message_bus().create_endpoint();
+
+    const knp::core::UID in_channel_uid, out_channel_uid;
+
+    // Create input and output.
+    backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+    endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+    std::vector<knp::core::Step> results;
+
+    for (knp::core::Step step = 0; step < 20; ++step)
+    {
+        // Send inputs on steps 0, 5, 10, 15.
+        if (step % 5 == 0)
+        {
+            knp::core::messaging::SpikeMessage message{{in_channel_uid, step}, {0}};
+            endpoint.send_message(message);
+        }
+        backend._step();
+        endpoint.receive_all_messages();
+        // Write the steps on which the network sends a spike.
+        if (!endpoint.unload_messages<knp::core::messaging::SpikeMessage>(out_channel_uid).empty())
+        {
+            results.push_back(step);
+        }
+    }
+
+    // Spikes on steps "5n + 1" (input) and on "previous_spike_n + 6" (positive feedback loop).
+    const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+    ASSERT_EQ(results, expected_results);
+}
+
+
+TEST(SingleThreadCpuSuite, DenseDeliverySmallestNetwork)
+{
+    // Create the smallest network with projections that add impacts to dense inputs of the population.
+    knp::testing::STestingBack backend;
+
+    knp::testing::BLIFATPopulation population{knp::testing::neuron_generator, 1};
+    knp::testing::DeltaProjection loop_delta_projection{
+        population.get_uid(), population.get_uid(), knp::testing::synapse_generator, 1};
+    knp::testing::DeltaProjection input_delta_projection{
+        knp::core::UID{false}, population.get_uid(), knp::testing::input_projection_gen, 1};
+    loop_delta_projection.set_dense_delivery(true);
+    input_delta_projection.set_dense_delivery(true);
+    const knp::core::UID loop_uid = loop_delta_projection.get_uid();
+    const knp::core::UID input_uid = input_delta_projection.get_uid();
+
+    backend.load_populations({population});
+    backend.load_projections({input_delta_projection, loop_delta_projection});
+
+    backend._init();
+    auto endpoint = backend.get_message_bus().create_endpoint();
+
+    const knp::core::UID in_channel_uid, out_channel_uid, impact_channel_uid;
+
+    // Create input and output.
+    backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+    endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+    endpoint.subscribe<knp::core::messaging::SynapticImpactMessage>(impact_channel_uid, {loop_uid});
+
+    std::vector<knp::core::Step> results;
+
+    for (knp::core::Step step = 0; step < 20; ++step)
+    {
+        // Send inputs on steps 0, 5, 10, 15.
+        if (step % 5 == 0)
+        {
+            knp::core::messaging::SpikeMessage message{{in_channel_uid, step}, {0}};
+            endpoint.send_message(message);
+        }
+        backend._step();
+        endpoint.receive_all_messages();
+        // Write the steps on which the network sends a spike.
+        if (!endpoint.unload_messages<knp::core::messaging::SpikeMessage>(out_channel_uid).empty())
+        {
+            results.push_back(step);
+        }
+    }
+
+    // Spikes on steps "5n + 1" (input) and on "previous_spike_n + 6" (positive feedback loop).
+    const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+    ASSERT_EQ(results, expected_results);
+    // Impacts are not sent as messages.
+    ASSERT_TRUE(endpoint.unload_messages<knp::core::messaging::SynapticImpactMessage>(impact_channel_uid).empty());
+}
+
+
+TEST(SingleThreadCpuSuite, AltAILIFSmallestNetwork)
+{
+    // Create the smallest network with an integer AltAILIF population, which must spike as a BLIFAT one.
+    knp::testing::STestingBack backend;
+
+    knp::testing::AltAILIFPopulation population{knp::testing::altai_lif_neuron_generator, 1};
+    Projection loop_projection =
+        knp::testing::DeltaProjection{population.get_uid(), population.get_uid(), knp::testing::synapse_generator, 1};
+    Projection input_projection = knp::testing::DeltaProjection{
+        knp::core::UID{false}, population.get_uid(), knp::testing::input_projection_gen, 1};
+    knp::core::UID const input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+
+    backend.load_populations({population});
+    backend.load_projections({input_projection, loop_projection});
+
+    backend._init();
+    auto endpoint = backend.get_message_bus().create_endpoint();
+
+    const knp::core::UID in_channel_uid, out_channel_uid;
+
+    // Create input and output.
+    backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+    endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+    std::vector<knp::core::Step> results;
+
+    for (knp::core::Step step = 0; step < 20; ++step)
+    {
+        // Send inputs on steps 0, 5, 10, 15.
+        if (step % 5 == 0)
+        {
+            knp::core::messaging::SpikeMessage message{{in_channel_uid, step}, {0}};
+            endpoint.send_message(message);
+        }
+        backend._step();
+        endpoint.receive_all_messages();
+        // Write the steps on which the network sends a spike.
+        if (!endpoint.unload_messages<knp::core::messaging::SpikeMessage>(out_channel_uid).empty())
+        {
+            results.push_back(step);
+        }
+    }
+
+    // Spikes on steps "5n + 1" (input) and on "previous_spike_n + 6" (positive feedback loop).
+    const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+    ASSERT_EQ(results, expected_results);
+}
+
+
+TEST(SingleThreadCpuSuite, AltAILIFAfterSpikeFlags)
+{
+    // A potential that falls below the negative threshold saturates to it, is reset to the negative reset value, or
+    // takes the value by which the threshold is exceeded, as a potential that reaches the activation threshold does.
+    struct FlagCase
+    {
+        bool saturate_;
+        bool is_reset_;
+        bool is_diff_;
+        int16_t potential_;
+        int16_t expected_potential_;
+    };
+    const std::vector<FlagCase> cases{
+        {true, true, true, -20, -5}, {false, true, true, -20, -2}, {false, false, true, -20, -15},
+        {false, false, false, -20, -20}, {false, false, true, 13, 3}, {false, true, true, 13, 2}};
+
+    knp::testing::STestingBack backend;
+    knp::testing::AltAILIFPopulation population{
+        [&cases](size_t index)
+        {
+            auto neuron = knp::testing::altai_lif_neuron_generator(index);
+            neuron.saturate_ = cases[index].saturate_;
+            neuron.is_reset_ = cases[index].is_reset_;
+            neuron.is_diff_ = cases[index].is_diff_;
+            neuron.potential_ = cases[index].potential_;
+            neuron.activation_threshold_ = 10;
+            neuron.negative_activation_threshold_ = 5;
+            neuron.potential_reset_value_ = 2;
+            return neuron;
+        },
+        cases.size()};
+    backend.load_populations({population});
+    backend._init();
+    backend._step();
+
+    const auto &result = std::get<knp::testing::AltAILIFPopulation>(*backend.begin_populations());
+    for (size_t index = 0; index < cases.size(); ++index)
+    {
+        ASSERT_EQ(result[index].potential_, cases[index].expected_potential_);
+    }
+}
+
+
 TEST(SingleThreadCpuSuite, AdditiveSTDPNetwork)
 {
     using STDPDeltaProjection = knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse>;
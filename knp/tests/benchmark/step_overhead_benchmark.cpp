@@ -0,0 +1,180 @@
+/**
+ * @file step_overhead_benchmark.cpp
+ * @brief Benchmark of step overhead of CPU backends on small networks.
+ * @kaspersky_support Artiom N.
+ * @date 17.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knp/backends/cpu-multi-threaded/backend.h>
+#include <knp/backends/cpu-single-threaded/backend.h>
+#include <knp/core/message_bus.h>
+#include <knp/core/population.h>
+#include <knp/core/projection.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+using BLIFATPopulation = knp::core::Population<knp::neuron_traits::BLIFATNeuron>;
+using DeltaProjection = knp::core::Projection<knp::synapse_traits::DeltaSynapse>;
+using knp::core::messaging::SpikeMessage;
+using knp::core::messaging::SynapticImpactMessage;
+
+constexpr size_t steps_count = 2000;
+constexpr int repetitions_count = 5;
+
+
+// Backend that can be initialized without a model.
+template <class Backend>
+class BenchmarkBackend : public Backend
+{
+public:
+    using Backend::Backend;
+    void _init() override { Backend::_init(); }
+};
+
+
+// Returns the shortest time in microseconds of a single call of the function.
+template <class Function>
+double measure(Function &&function)
+{
+    double best_time = std::numeric_limits<double>::max();
+    for (int repetition = 0; repetition < repetitions_count; ++repetition)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t step = 0; step < steps_count; ++step) function(step);
+        const std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+        best_time = std::min(best_time, time.count() / steps_count);
+    }
+    return best_time;
+}
+
+
+// Control loop: all input neurons get a spike on each step, and spikes of the population are read after each step.
+// Neurons spike on every other step, as the input projection and the loop projection have different delays.
+template <class Backend>
+double measure_step(Backend &backend, size_t neurons_count)
+{
+    BLIFATPopulation population(
+        [](size_t)
+        {
+            knp::neuron_traits::neuron_parameters<knp::neuron_traits::BLIFATNeuron> neuron;
+            neuron.activation_threshold_ = 1;
+            return neuron;
+        },
+        neurons_count);
+    auto one_to_one = [](size_t index)
+    { return DeltaProjection::Synapse{{1.0F, 1, knp::synapse_traits::OutputType::EXCITATORY}, index, index}; };
+    auto loop_synapse = [](size_t index)
+    { return DeltaProjection::Synapse{{1.0F, 2, knp::synapse_traits::OutputType::EXCITATORY}, index, index}; };
+    const DeltaProjection input_projection{knp::core::UID{false}, population.get_uid(), one_to_one, neurons_count};
+    const DeltaProjection loop_projection{population.get_uid(), population.get_uid(), loop_synapse, neurons_count};
+
+    backend.load_populations({population});
+    backend.load_projections({input_projection, loop_projection});
+    const knp::core::UID in_channel_uid;
+    const knp::core::UID out_channel_uid;
+    backend.template subscribe<SpikeMessage>(input_projection.get_uid(), {in_channel_uid});
+    auto endpoint = backend.get_message_bus().create_endpoint();
+    endpoint.template subscribe<SpikeMessage>(out_channel_uid, {population.get_uid()});
+    backend._init();
+
+    knp::core::messaging::SpikeData input_spikes(neurons_count);
+    std::iota(input_spikes.begin(), input_spikes.end(), 0);
+    return measure(
+        [&](size_t step)
+        {
+            endpoint.send_message(SpikeMessage{{in_channel_uid, step}, input_spikes});
+            backend._step();
+            endpoint.receive_all_messages();
+            (void)endpoint.template unload_messages<SpikeMessage>(out_channel_uid);
+        });
+}
+
+
+// Routing and delivery of messages of a step, as the backend does them on the calling thread: spikes of the
+// population are sent to a projection, and impacts of the projection are sent back.
+double measure_routing(size_t neurons_count)
+{
+    auto bus = knp::core::MessageBus::construct_cpu_bus();
+    auto population_endpoint = bus.create_endpoint();
+    auto projection_endpoint = bus.create_endpoint();
+    const knp::core::UID population_uid;
+    const knp::core::UID projection_uid;
+    projection_endpoint.subscribe<SpikeMessage>(projection_uid, {population_uid});
+    population_endpoint.subscribe<SynapticImpactMessage>(population_uid, {projection_uid});
+
+    knp::core::messaging::SpikeData spikes(neurons_count);
+    std::iota(spikes.begin(), spikes.end(), 0);
+    SynapticImpactMessage impacts;
+    impacts.header_.sender_uid_ = projection_uid;
+    impacts.presynaptic_population_uid_ = population_uid;
+    impacts.postsynaptic_population_uid_ = population_uid;
+    impacts.impacts_.resize(neurons_count);
+    return measure(
+        [&](size_t step)
+        {
+            population_endpoint.send_message(SpikeMessage{{population_uid, step}, spikes});
+            bus.route_messages();
+            projection_endpoint.receive_all_messages();
+            (void)projection_endpoint.unload_messages<SpikeMessage>(projection_uid);
+            impacts.header_.send_time_ = step;
+            projection_endpoint.send_message(impacts);
+            bus.route_messages();
+            population_endpoint.receive_all_messages();
+            (void)population_endpoint.unload_messages<SynapticImpactMessage>(population_uid);
+        });
+}
+
+}  // namespace
+
+
+// Prints time of a step of the control loop in microseconds. The single-threaded backend runs everything on the
+// calling thread, so its time is an upper bound of the serial part of a multi-threaded step, which includes routing.
+int main()
+{
+    spdlog::set_level(spdlog::level::warn);
+    const size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+    std::cout << std::setw(8) << "neurons" << std::setw(10) << "routing" << std::setw(10) << "single";
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) std::cout << std::setw(8) << "mt" << threads;
+    std::cout << std::endl << std::fixed << std::setprecision(1);
+
+    for (const size_t neurons_count : {1, 16, 256, 4096})
+    {
+        std::cout << std::setw(8) << neurons_count << std::setw(10) << measure_routing(neurons_count);
+        BenchmarkBackend<knp::backends::single_threaded_cpu::SingleThreadedCPUBackend> single_threaded;
+        std::cout << std::setw(10) << measure_step(single_threaded, neurons_count);
+        for (size_t threads = 1; threads <= max_threads; threads *= 2)
+        {
+            BenchmarkBackend<knp::backends::multi_threaded_cpu::MultiThreadedCPUBackend> multi_threaded(threads);
+            std::cout << std::setw(9) << measure_step(multi_threaded, neurons_count);
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -23,6 +23,7 @@
 
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
+#include <knp/neuron-traits/altai_lif.h>
 #include <knp/neuron-traits/blifat.h>
 #include <knp/synapse-traits/delta.h>
 
@@ -36,6 +37,7 @@ namespace knp::testing
 {
 using DeltaProjection = knp::core::Projection<knp::synapse_traits::DeltaSynapse>;
 using BLIFATPopulation = knp::core::Population<knp::neuron_traits::BLIFATNeuron>;
+using AltAILIFPopulation = knp::core::Population<knp::neuron_traits::AltAILIF>;
 
 // Create an input projection.
 inline std::optional<DeltaProjection::Synapse> input_projection_gen(size_t /*index*/)  // NOLINT
@@ -55,4 +57,11 @@ inline knp::neuron_traits::neuron_parameters<knp::neuron_traits::BLIFATNeuron> n
 {
     return knp::neuron_traits::neuron_parameters<knp::neuron_traits::BLIFATNeuron>{};
 }
+
+
+// Create AltAILIF population.
+inline knp::neuron_traits::neuron_parameters<knp::neuron_traits::AltAILIF> altai_lif_neuron_generator(size_t)  // NOLINT
+{
+    return knp::neuron_traits::neuron_parameters<knp::neuron_traits::AltAILIF>{};
+}
 }  // namespace knp::testing
@@ -69,6 +69,21 @@ TEST(PopulationSuite, RemoveNeurons)
 }
 
 
+TEST(PopulationSuite, RemoveUnsortedNeurons)
+{
+    knp::core::Population<knp::neuron_traits::BLIFATNeuron> population(neuron_generator, neurons_count);
+
+    population.remove_neurons({7, 0, 3, 7});
+
+    const std::vector<double> expected_potentials{1, 2, 4, 5, 6, 8, 9};
+    ASSERT_EQ(population.size(), expected_potentials.size());
+    for (size_t i = 0; i < expected_potentials.size(); ++i)
+    {
+        ASSERT_EQ(population[i].potential_, expected_potentials[i]);
+    }
+}
+
+
 TEST(PopulationSuite, SetNeuronParameter)
 {
     knp::core::Population<knp::neuron_traits::BLIFATNeuron> population(neuron_generator, neurons_count);
@@ -81,3 +96,173 @@ TEST(PopulationSuite, SetNeuronParameter)
 
     ASSERT_EQ(150, population[p_index].potential_);
 }
+
+
+TEST(PopulationSuite, StructureOfArraysStorage)
+{
+    knp::core::Population<knp::neuron_traits::BLIFATNeuron> population(neuron_generator, neurons_count);
+    population.set_storage(knp::core::NeuronStorage::structure_of_arrays);
+
+    // Columns are changed directly, and neuron parameters are updated on synchronization.
+    auto &columns = population.get_neuron_columns();
+    ASSERT_EQ(columns.size(), neurons_count);
+    ASSERT_EQ(columns.potential_[3], 3);
+    columns.potential_[3] = 42;
+    const auto &const_population = population;
+    ASSERT_THROW((void)const_population[3], std::logic_error);
+    population.synchronize_neurons();
+    ASSERT_EQ(const_population[3].potential_, 42);
+
+    // Changes made through per-neuron accessors are visible in columns.
+    population[4].potential_ = 150;
+    population.remove_neurons({0});
+    ASSERT_EQ(population.get_neuron_columns().size(), neurons_count - 1);
+    ASSERT_EQ(population.get_neuron_columns().potential_[3], 150);
+
+    population.set_storage(knp::core::NeuronStorage::array_of_structures);
+    ASSERT_EQ(population[2].potential_, 42);
+    ASSERT_THROW(
+        knp::core::Population<knp::neuron_traits::AltAILIF>(
+            [](size_t) { return knp::neuron_traits::neuron_parameters<knp::neuron_traits::AltAILIF>{}; }, 1)
+            .set_storage(knp::core::NeuronStorage::structure_of_arrays),
+        std::logic_error);
+}
+
+
+TEST(PopulationSuite, SinglePrecisionStorage)
+{
+    knp::core::Population<knp::neuron_traits::BLIFATNeuron> population(neuron_generator, neurons_count);
+    population.set_storage(knp::core::NeuronStorage::single_precision_structure_of_arrays);
+
+    auto &columns = population.get_neuron_columns<float>();
+    ASSERT_EQ(columns.size(), neurons_count);
+    ASSERT_EQ(population.get_neuron_columns<double>().size(), 0);
+    columns.potential_[3] = 0.1F;
+    const auto &const_population = population;
+    population.synchronize_neurons();
+    ASSERT_EQ(const_population[3].potential_, 0.1F);
+
+    // In the validation mode, both column sets are built, and the state is defined by double-precision columns.
+    population.set_storage(knp::core::NeuronStorage::precision_validation);
+    ASSERT_EQ(population.get_neuron_columns<float>().size(), neurons_count);
+    ASSERT_EQ(population.get_neuron_columns<double>().potential_[3], 0.1F);
+    population.get_neuron_columns<double>().potential_[4] = 7;
+    population.get_neuron_columns<float>().potential_[4] = 8;
+    population.synchronize_neurons();
+    ASSERT_EQ(const_population[4].potential_, 7);
+    ASSERT_EQ(population.get_precision_divergence().divergent_spikes_, 0);
+
+    population.set_storage(knp::core::NeuronStorage::array_of_structures);
+    ASSERT_EQ(population[4].potential_, 7);
+}
+
+
+TEST(PopulationSuite, SharedParametersStorage)
+{
+    knp::core::Population<knp::neuron_traits::BLIFATNeuron> population(neuron_generator, neurons_count);
+    population.set_storage(knp::core::NeuronStorage::shared_parameters);
+
+    // Constant parameters are stored once, states are stored per neuron.
+    auto &columns = population.get_neuron_columns();
+    ASSERT_TRUE(columns.has_shared_parameters_);
+    ASSERT_EQ(columns.potential_decay_.size(), 1);
+    ASSERT_EQ(columns.potential_.size(), neurons_count);
+    ASSERT_EQ(population.size(), neurons_count);
+    columns.potential_[3] = 42;
+
+    const auto &const_population = population;
+    population.synchronize_neurons();
+    ASSERT_EQ(const_population[3].potential_, 42);
+    ASSERT_EQ(const_population[3].potential_decay_, BLIFATParams{}.potential_decay_);
+
+    // Neurons with different parameters cannot share them.
+    population[4].potential_decay_ = 0.5;
+    ASSERT_THROW((void)population.get_neuron_columns(), std::logic_error);
+    population.set_storage(knp::core::NeuronStorage::array_of_structures);
+    ASSERT_THROW(population.set_storage(knp::core::NeuronStorage::shared_parameters), std::logic_error);
+    ASSERT_EQ(population.get_storage(), knp::core::NeuronStorage::array_of_structures);
+    ASSERT_EQ(population[4].potential_decay_, 0.5);
+    ASSERT_EQ(population[3].potential_, 42);
+}
+
+
+TEST(PopulationSuite, FeatureDetection)
+{
+    knp::core::Population<knp::neuron_traits::BLIFATNeuron> population(neuron_generator, neurons_count);
+    using knp::core::BLIFATFeatures;
+    const unsigned default_features = population.get_features();
+    ASSERT_EQ(default_features & BLIFATFeatures::inhibitory_conductance, 0);
+
+    // Features are detected again after neurons are changed.
+    population[2].bursting_period_ = 3;
+    population[3].inhibitory_conductance_ = 0.5;
+    ASSERT_EQ(
+        population.get_features(),
+        default_features | BLIFATFeatures::bursting | BLIFATFeatures::inhibitory_conductance);
+
+    // Kernels enable features used by synaptic inputs.
+    population[3].inhibitory_conductance_ = 0;
+    population.enable_features(BLIFATFeatures::inhibitory_conductance);
+    ASSERT_TRUE(population.get_features() & BLIFATFeatures::inhibitory_conductance);
+    ASSERT_EQ(
+        knp::core::Population<knp::neuron_traits::AltAILIF>(
+            [](size_t) { return knp::neuron_traits::neuron_parameters<knp::neuron_traits::AltAILIF>{}; }, 1)
+            .get_features(),
+        BLIFATFeatures::all);
+}
+
+
+TEST(PopulationSuite, EventDrivenUpdating)
+{
+    knp::core::Population<knp::neuron_traits::BLIFATNeuron> population(neuron_generator, neurons_count);
+    population[0].potential_ = 0.5;
+    population[0].potential_decay_ = 0.5;
+    population.set_event_driven(true);
+    ASSERT_TRUE(population.is_event_driven());
+    ASSERT_THROW(population.set_storage(knp::core::NeuronStorage::structure_of_arrays), std::logic_error);
+
+    // A neuron below its threshold sleeps, a neuron above its threshold stays active.
+    auto &active_set = population.get_active_set();
+    ASSERT_EQ(active_set.active_count(), neurons_count);
+    active_set.try_sleep(0, population.get_neuron_states()[0]);
+    active_set.try_sleep(2, population.get_neuron_states()[2]);
+    ASSERT_EQ(active_set.active_count(), neurons_count - 1);
+
+    // Decay of a sleeping neuron is applied when neurons are synchronized.
+    active_set.start_step();
+    active_set.start_step();
+    const auto &const_population = population;
+    ASSERT_THROW((void)const_population.get_neurons_parameters(), std::logic_error);
+    population.synchronize_neurons();
+    ASSERT_DOUBLE_EQ(const_population[0].potential_, 0.125);
+    ASSERT_EQ(const_population[2].potential_, 2);
+
+    // Changing a neuron wakes only that neuron, other neurons keep sleeping.
+    auto neuron = const_population[1];
+    neuron.potential_ = 0.5;
+    neuron.potential_decay_ = 0.5;
+    population.set_neuron_parameters(1, std::move(neuron));
+    active_set.try_sleep(1, population.get_neuron_states()[1]);
+    ASSERT_EQ(active_set.active_count(), neurons_count - 2);
+    population[0].potential_ = 0.75;
+    ASSERT_EQ(active_set.active_count(), neurons_count - 1);
+    active_set.start_step();
+    active_set.finish_inputs();
+    std::vector<size_t> active_neurons;
+    active_set.for_each_active_neuron(0, 2, [&active_neurons](size_t index) { active_neurons.push_back(index); });
+    ASSERT_EQ(active_neurons, std::vector<size_t>{0});
+    population.synchronize_neurons();
+    ASSERT_DOUBLE_EQ(const_population[1].potential_, 0.25);
+
+    population.set_event_driven(false);
+    ASSERT_FALSE(population.is_event_driven());
+    population.set_storage(knp::core::NeuronStorage::structure_of_arrays);
+    ASSERT_THROW(population.set_event_driven(true), std::logic_error);
+    ASSERT_THROW(
+        knp::core::Population<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>(
+            [](size_t)
+            { return knp::neuron_traits::neuron_parameters<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>{}; },
+            1)
+            .set_event_driven(true),
+        std::logic_error);
+}
@@ -24,8 +24,18 @@
 
 #include <tests_common.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <numeric>
 #include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 
 namespace knc = knp::core;
@@ -82,6 +92,50 @@ TEST(ProjectionSuite, Generation)
 }
 
 
+TEST(ProjectionSuite, ParallelGeneration)
+{
+    const uint32_t presynaptic_size = 99;
+    const uint32_t postsynaptic_size = 101;
+    const size_t synapses_per_neuron = 10;
+    const SynapseParameters default_params{0.0F, 1, knp::synapse_traits::OutputType::EXCITATORY};
+    auto cyclic_generator = make_cyclic_generator({presynaptic_size, postsynaptic_size}, default_params);
+    // Every other synapse is skipped to check that synapses are compacted in order.
+    SynapseGenerator generator = [&cyclic_generator](size_t index) -> std::optional<Synapse>
+    {
+        if (index % 2) return std::nullopt;
+        return cyclic_generator(index);
+    };
+    const size_t iterations = presynaptic_size * synapses_per_neuron;
+
+    const DeltaProjection serial_projection{knc::UID{}, knc::UID{}, generator, iterations};
+    DeltaProjection parallel_projection{
+        knc::UID{}, knc::UID{}, generator, iterations, DeltaProjection::ParallelGeneration{4}};
+
+    ASSERT_EQ(parallel_projection.size(), iterations / 2);
+    ASSERT_TRUE(std::equal(
+        serial_projection.begin(), serial_projection.end(), parallel_projection.begin(), parallel_projection.end(),
+        [](const Synapse &synapse1, const Synapse &synapse2)
+        {
+            return std::get<knp::core::source_neuron_id>(synapse1) == std::get<knp::core::source_neuron_id>(synapse2) &&
+                   std::get<knp::core::target_neuron_id>(synapse1) == std::get<knp::core::target_neuron_id>(synapse2);
+        }));
+
+    parallel_projection.add_synapses(cyclic_generator, iterations, DeltaProjection::ParallelGeneration{3});
+    ASSERT_EQ(parallel_projection.size(), iterations / 2 + iterations);
+    for (size_t neuron_index = 0; neuron_index < postsynaptic_size; ++neuron_index)
+    {
+        const auto synapses =
+            parallel_projection.find_synapses(neuron_index, DeltaProjection::Search::by_postsynaptic);
+        ASSERT_TRUE(std::is_sorted(synapses.begin(), synapses.end()));
+        const auto expected_count = std::count_if(
+            parallel_projection.begin(), parallel_projection.end(),
+            [neuron_index](const Synapse &synapse)
+            { return std::get<knp::core::target_neuron_id>(synapse) == neuron_index; });
+        ASSERT_EQ(synapses.size(), expected_count);
+    }
+}
+
+
 TEST(ProjectionSuite, SynapseAddition)
 {
     using SynapseType = knp::synapse_traits::OutputType;
@@ -143,6 +197,37 @@ TEST(ProjectionSuite, SynapseAddition)
 }
 
 
+TEST(ProjectionSuite, PresynapticRangeTest)
+{
+    const uint32_t size_from = 9;
+    const uint32_t size_to = 11;
+    auto generator =
+        make_dense_generator({size_from, size_to}, {0.0F, 1, knp::synapse_traits::OutputType::EXCITATORY});
+    DeltaProjection projection{knc::UID{}, knc::UID{}, generator, size_from * size_to};
+
+    for (size_t neuron_index = 0; neuron_index < size_from; ++neuron_index)
+    {
+        const auto synapses = projection.get_presynaptic_synapses(neuron_index);
+        ASSERT_EQ(synapses.size(), size_to);
+        ASSERT_TRUE(std::is_sorted(synapses.begin(), synapses.end()));
+        for (const auto synapse_index : synapses)
+            ASSERT_EQ(std::get<knp::core::source_neuron_id>(projection[synapse_index]), neuron_index);
+    }
+    // Neurons without synapses have empty ranges.
+    ASSERT_TRUE(projection.get_presynaptic_synapses(size_from + 1).empty());
+
+    // Index is updated after synapses removal.
+    projection.remove_postsynaptic_neuron_synapses(0);
+    const auto synapses = projection.get_presynaptic_synapses(1);
+    ASSERT_EQ(synapses.size(), size_to - 1);
+    for (const auto synapse_index : synapses)
+    {
+        ASSERT_EQ(std::get<knp::core::source_neuron_id>(projection[synapse_index]), 1);
+        ASSERT_NE(std::get<knp::core::target_neuron_id>(projection[synapse_index]), 0);
+    }
+}
+
+
 TEST(ProjectionSuite, DeletePresynapticTest)
 {
     const uint32_t size_from = 99;
@@ -218,6 +303,430 @@ TEST(ProjectionSuite, SynapseRemoval)
 }
 
 
+TEST(ProjectionSuite, BulkRemovalTest)
+{
+    const uint32_t size_from = 9;
+    const uint32_t size_to = 11;
+    auto generator =
+        make_dense_generator({size_from, size_to}, {0.0F, 1, knp::synapse_traits::OutputType::EXCITATORY});
+    DeltaProjection projection{knc::UID{}, knc::UID{}, generator, size_from * size_to};
+    // Build index before removal.
+    ASSERT_EQ(projection.get_presynaptic_synapses(0).size(), size_to);
+
+    // Every third synapse is removed.
+    std::vector<size_t> to_remove;
+    for (size_t i = 0; i < projection.size(); i += 3) to_remove.push_back(i);
+    std::reverse(to_remove.begin(), to_remove.end());
+
+    const size_t count = projection.remove_synapses(to_remove);
+    ASSERT_EQ(count, to_remove.size());
+    ASSERT_EQ(projection.size(), size_from * size_to - to_remove.size());
+    for (size_t i = 0; i < projection.size(); ++i)
+    {
+        // Synapse with index `i` was generated by iteration `i + i / 2 + 1`.
+        const size_t iteration = i + i / 2 + 1;
+        ASSERT_EQ(std::get<knp::core::source_neuron_id>(projection[i]), iteration / size_to);
+        ASSERT_EQ(std::get<knp::core::target_neuron_id>(projection[i]), iteration % size_to);
+    }
+
+    // The index is consistent with the synapses.
+    for (size_t neuron_index = 0; neuron_index < size_to; ++neuron_index)
+    {
+        const auto synapses = projection.find_synapses(neuron_index, DeltaProjection::Search::by_postsynaptic);
+        const auto expected_count = std::count_if(
+            projection.begin(), projection.end(),
+            [neuron_index](const Synapse &synapse)
+            { return std::get<knp::core::target_neuron_id>(synapse) == neuron_index; });
+        ASSERT_EQ(synapses.size(), expected_count);
+        for (const auto synapse_index : synapses)
+            ASSERT_EQ(std::get<knp::core::target_neuron_id>(projection[synapse_index]), neuron_index);
+    }
+}
+
+
+TEST(ProjectionSuite, IncrementalIndexTest)
+{
+    const uint32_t size_from = 9;
+    const uint32_t size_to = 11;
+    auto generator =
+        make_dense_generator({size_from, size_to}, {0.0F, 1, knp::synapse_traits::OutputType::EXCITATORY});
+    DeltaProjection projection{knc::UID{}, knc::UID{}, generator, size_from * size_to};
+    ASSERT_EQ(projection.get_presynaptic_synapses(0).size(), size_to);
+
+    // Synapses are added in small batches, and the index is checked after each one.
+    const size_t batch_size = 7;
+    for (size_t batch = 0; batch < 20; ++batch)
+    {
+        projection.add_synapses(
+            [&generator, batch](size_t index) { return generator(batch * batch_size + index); }, batch_size);
+        if (batch % 5 == 0) projection.remove_presynaptic_neuron_synapses(batch % size_from);
+
+        for (size_t neuron_index = 0; neuron_index < size_from; ++neuron_index)
+        {
+            const auto synapses = projection.get_presynaptic_synapses(neuron_index);
+            const auto expected_count = std::count_if(
+                projection.begin(), projection.end(),
+                [neuron_index](const Synapse &synapse)
+                { return std::get<knp::core::source_neuron_id>(synapse) == neuron_index; });
+            ASSERT_EQ(synapses.size(), expected_count);
+            ASSERT_TRUE(std::is_sorted(synapses.begin(), synapses.end()));
+            for (const auto synapse_index : synapses)
+                ASSERT_EQ(std::get<knp::core::source_neuron_id>(projection[synapse_index]), neuron_index);
+        }
+
+        for (size_t neuron_index = 0; neuron_index < size_to; ++neuron_index)
+        {
+            const auto synapses = projection.get_postsynaptic_synapses(neuron_index);
+            const auto expected_count = std::count_if(
+                projection.begin(), projection.end(),
+                [neuron_index](const Synapse &synapse)
+                { return std::get<knp::core::target_neuron_id>(synapse) == neuron_index; });
+            ASSERT_EQ(synapses.size(), expected_count);
+            ASSERT_TRUE(std::is_sorted(synapses.begin(), synapses.end()));
+        }
+    }
+}
+
+
+TEST(ProjectionSuite, SynapseIndexCompactionTest)
+{
+    knc::SynapseIndex index;
+    const size_t rows_count = 10;
+    const size_t synapses_count = 10 * knc::SynapseIndex::min_compacted_slots;
+    for (size_t synapse_index = 0; synapse_index < synapses_count; ++synapse_index)
+    {
+        index.append(synapse_index, synapse_index % rows_count);
+    }
+
+    ASSERT_LE(index.get_fragmentation(), knc::SynapseIndex::max_fragmentation);
+    ASSERT_EQ(index.rows_count(), rows_count);
+    for (size_t row = 0; row < rows_count; ++row)
+    {
+        const auto synapses = index.find(row);
+        ASSERT_EQ(synapses.size(), synapses_count / rows_count);
+        for (size_t i = 0; i < synapses.size(); ++i) ASSERT_EQ(synapses[i], row + i * rows_count);
+    }
+}
+
+
+TEST(ProjectionSuite, StorageTest)
+{
+    const uint32_t size_from = 9;
+    const uint32_t size_to = 11;
+    auto generator =
+        make_dense_generator({size_from, size_to}, {1.0F, 2, knp::synapse_traits::OutputType::EXCITATORY});
+    DeltaProjection projection{knc::UID{}, knc::UID{}, generator, size_from * size_to};
+    const std::vector<Synapse> synapses(projection.begin(), projection.end());
+
+    projection.set_storage(knc::SynapseStorage::structure_of_arrays);
+    ASSERT_EQ(projection.get_storage(), knc::SynapseStorage::structure_of_arrays);
+    ASSERT_EQ(projection.size(), synapses.size());
+
+    const auto &columns = projection.get_synapse_columns();
+    ASSERT_EQ(columns.size(), synapses.size());
+    for (size_t i = 0; i < synapses.size(); ++i)
+    {
+        ASSERT_EQ(columns.source_neurons_[i], std::get<knp::core::source_neuron_id>(synapses[i]));
+        ASSERT_EQ(columns.target_neurons_[i], std::get<knp::core::target_neuron_id>(synapses[i]));
+        ASSERT_EQ(columns.parameters_[i].delay_, std::get<knp::core::synapse_data>(synapses[i]).delay_);
+    }
+    ASSERT_EQ(projection.get_presynaptic_synapses(1).size(), size_to);
+
+    // Modification through operator[] is visible in columns.
+    std::get<knp::core::synapse_data>(projection[3]).weight_ = 5.0F;
+    ASSERT_EQ(projection.get_synapse_columns().parameters_[3].weight_, 5.0F);
+
+    // Synapses can be modified in the structure of arrays mode.
+    projection.remove_presynaptic_neuron_synapses(0);
+    ASSERT_EQ(projection.size(), synapses.size() - size_to);
+    ASSERT_EQ(projection.get_synapse_columns().source_neurons_.front(), 1);
+    ASSERT_TRUE(projection.get_presynaptic_synapses(0).empty());
+    projection.add_synapses(generator, size_to);
+    ASSERT_EQ(projection.size(), synapses.size());
+    // Added synapses are appended to columns and to the index.
+    ASSERT_EQ(projection.get_synapse_columns().source_neurons_.back(), 0);
+    ASSERT_EQ(projection.get_presynaptic_synapses(0).size(), size_to);
+    ASSERT_EQ(projection.get_presynaptic_synapses(0)[0], synapses.size() - size_to);
+    ASSERT_EQ(projection.get_postsynaptic_synapses(2).size(), size_from);
+
+    // Neuron indexes that don't fit into 32-bit columns are rejected.
+    const size_t huge_index = size_t{std::numeric_limits<uint32_t>::max()} + 1;
+    auto huge_generator = [huge_index](size_t) -> std::optional<Synapse>
+    { return Synapse{{1.0F, 2, knp::synapse_traits::OutputType::EXCITATORY}, huge_index, 0}; };
+    ASSERT_THROW(projection.add_synapses(huge_generator, 1), std::out_of_range);
+    ASSERT_EQ(projection.size(), synapses.size());
+
+    projection.set_storage(knc::SynapseStorage::array_of_structures);
+    ASSERT_EQ(projection.size(), synapses.size());
+    ASSERT_EQ(std::get<knp::core::source_neuron_id>(projection[projection.size() - 1]), 0);
+}
+
+
+TEST(ProjectionSuite, ProceduralTest)
+{
+    const size_t size_from = 9;
+    const size_t size_to = 11;
+    auto generator = make_dense_generator({size_from, size_to}, {1.0F, 2, knp::synapse_traits::OutputType::EXCITATORY});
+    const DeltaProjection dense_projection{knc::UID{}, knc::UID{}, generator, size_from * size_to};
+
+    // Every second synapse is skipped, so rows have different sizes.
+    DeltaProjection::ProceduralConnectivity connectivity{
+        [&generator](size_t neuron_index, std::vector<Synapse> &synapses)
+        {
+            for (size_t i = neuron_index * size_to; i < (neuron_index + 1) * size_to; ++i)
+            {
+                if (i % 2 == 0) synapses.push_back(generator(i).value());
+            }
+        },
+        size_from};
+    DeltaProjection projection{knc::UID{}, knc::UID{}, connectivity};
+    ASSERT_TRUE(projection.is_procedural());
+    ASSERT_EQ(projection.size(), (size_from * size_to + 1) / 2);
+
+    std::vector<Synapse> synapses;
+    ASSERT_EQ(projection.generate_presynaptic_synapses(1, synapses), (size_to + 1) / 2);
+    ASSERT_EQ(synapses.size(), size_to / 2);
+    ASSERT_EQ(std::get<knc::target_neuron_id>(synapses.front()), 1);
+    ASSERT_EQ(projection.generate_presynaptic_synapses(size_from, synapses), projection.size());
+    ASSERT_TRUE(synapses.empty());
+
+    // Indexes are built without storing synapses, and stored synapses are accessible only after materialization.
+    const size_t synapse_index = projection.generate_presynaptic_synapses(4, synapses) + 2;
+    ASSERT_EQ(projection.get_presynaptic_synapses(4)[2], synapse_index);
+    // Synapses of a presynaptic neuron are numbered consecutively.
+    const auto presynaptic_range = projection.get_presynaptic_synapses(4);
+    std::vector<size_t> expected_synapses(synapses.size());
+    std::iota(expected_synapses.begin(), expected_synapses.end(), synapse_index - 2);
+    ASSERT_EQ(std::vector<size_t>(presynaptic_range.begin(), presynaptic_range.end()), expected_synapses);
+    ASSERT_TRUE(projection.get_presynaptic_synapses(size_from).empty());
+    const auto postsynaptic_range = projection.get_postsynaptic_synapses(1);
+    const std::vector<size_t> postsynaptic_synapses(postsynaptic_range.begin(), postsynaptic_range.end());
+    ASSERT_TRUE(projection.is_procedural());
+    ASSERT_THROW((void)std::as_const(projection)[0], std::logic_error);
+    ASSERT_THROW((void)projection.begin(), std::logic_error);
+    ASSERT_TRUE(projection.is_procedural());
+    projection.materialize();
+    ASSERT_FALSE(projection.is_procedural());
+    ASSERT_EQ(projection.get_presynaptic_synapses(4)[2], synapse_index);
+    ASSERT_EQ(
+        postsynaptic_synapses,
+        std::vector<size_t>(
+            projection.get_postsynaptic_synapses(1).begin(), projection.get_postsynaptic_synapses(1).end()));
+    for (const auto index : postsynaptic_synapses) ASSERT_EQ(std::get<knc::target_neuron_id>(projection[index]), 1);
+    ASSERT_EQ(projection.size(), (size_from * size_to + 1) / 2);
+    ASSERT_EQ(std::get<knc::target_neuron_id>(projection[synapse_index]), std::get<knc::target_neuron_id>(synapses[2]));
+    ASSERT_THROW(projection.generate_presynaptic_synapses(0, synapses), std::logic_error);
+
+    projection.remove_presynaptic_neuron_synapses(0);
+    ASSERT_EQ(projection.size(), (size_from * size_to + 1) / 2 - (size_to + 1) / 2);
+    ASSERT_EQ(dense_projection.size(), size_from * size_to);
+}
+
+
+TEST(ProjectionSuite, ConvolutionTest)
+{
+    DeltaProjection::Convolution convolution;
+    convolution.input_width_ = 5;
+    convolution.input_height_ = 4;
+    convolution.input_channels_ = 2;
+    convolution.kernel_width_ = 3;
+    convolution.kernel_height_ = 2;
+    convolution.output_channels_ = 3;
+    convolution.stride_ = 2;
+    const size_t kernel_size = 3 * 2 * 2 * 3;
+    for (size_t i = 0; i < kernel_size; ++i)
+        convolution.kernel_.push_back({static_cast<float>(i), 1, knp::synapse_traits::OutputType::EXCITATORY});
+    ASSERT_EQ(convolution.get_output_width(), 2);
+    ASSERT_EQ(convolution.get_output_height(), 2);
+
+    // Expected synapses as (presynaptic neuron, postsynaptic neuron, kernel element) tuples.
+    std::vector<std::tuple<size_t, size_t, size_t>> expected;
+    size_t kernel_index = 0;
+    for (size_t out_channel = 0; out_channel < 3; ++out_channel)
+        for (size_t in_channel = 0; in_channel < 2; ++in_channel)
+            for (size_t kernel_y = 0; kernel_y < 2; ++kernel_y)
+                for (size_t kernel_x = 0; kernel_x < 3; ++kernel_x, ++kernel_index)
+                    for (size_t out_y = 0; out_y < 2; ++out_y)
+                        for (size_t out_x = 0; out_x < 2; ++out_x)
+                            expected.emplace_back(
+                                (in_channel * 4 + out_y * 2 + kernel_y) * 5 + out_x * 2 + kernel_x,
+                                (out_channel * 2 + out_y) * 2 + out_x, kernel_index);
+
+    DeltaProjection projection{knc::UID{}, knc::UID{}, convolution};
+    ASSERT_NE(projection.get_convolution(), nullptr);
+    ASSERT_TRUE(projection.is_procedural());
+    ASSERT_EQ(projection.size(), expected.size());
+
+    std::vector<std::tuple<size_t, size_t, size_t>> generated;
+    projection.materialize();
+    for (const auto &synapse : projection)
+    {
+        generated.emplace_back(
+            std::get<knc::source_neuron_id>(synapse), std::get<knc::target_neuron_id>(synapse),
+            static_cast<size_t>(std::get<knc::synapse_data>(synapse).weight_));
+    }
+    ASSERT_EQ(projection.get_convolution(), nullptr);
+    std::sort(expected.begin(), expected.end());
+    std::sort(generated.begin(), generated.end());
+    ASSERT_EQ(generated, expected);
+
+    convolution.kernel_.pop_back();
+    ASSERT_THROW((DeltaProjection{knc::UID{}, knc::UID{}, convolution}), std::logic_error);
+}
+
+
+TEST(ProjectionSuite, MappedTest)
+{
+    const size_t size_from = 7;
+    const size_t size_to = 5;
+    // Synapses are generated in the postsynaptic order, so the file index differs from the synapse order.
+    DeltaProjection source_projection{
+        knc::UID{}, knc::UID{},
+        [](size_t index) -> std::optional<Synapse>
+        {
+            if (index % 3 == 0) return std::nullopt;
+            return Synapse{
+                {static_cast<float>(index), 1, knp::synapse_traits::OutputType::EXCITATORY}, index % size_from,
+                index / size_from};
+        },
+        size_from * size_to};
+    const auto path = std::filesystem::temp_directory_path() / "knp_mapped_projection_test.bin";
+    source_projection.save_mapped(path);
+
+    DeltaProjection projection{knc::UID{}, knc::UID{}, DeltaProjection::MappedSynapses{path}};
+    ASSERT_TRUE(projection.is_mapped());
+    ASSERT_EQ(projection.size(), source_projection.size());
+    for (size_t neuron_index = 0; neuron_index <= size_from; ++neuron_index)
+    {
+        const auto expected = source_projection.find_synapses(neuron_index, DeltaProjection::Search::by_presynaptic);
+        const auto range = projection.get_presynaptic_synapses(neuron_index);
+        ASSERT_EQ(std::vector<size_t>(range.begin(), range.end()), expected);
+    }
+    ASSERT_EQ(
+        projection.find_synapses(2, DeltaProjection::Search::by_postsynaptic),
+        source_projection.find_synapses(2, DeltaProjection::Search::by_postsynaptic));
+
+    // Copies share the mapped file.
+    const DeltaProjection projection_copy = projection;
+    ASSERT_EQ(projection_copy.get_mapped_file(), projection.get_mapped_file());
+
+    // Constant access doesn't copy synapses into memory.
+    ASSERT_THROW((void)projection_copy[0], std::logic_error);
+    ASSERT_TRUE(projection_copy.is_mapped());
+
+    // Removing synapses materializes them.
+    ASSERT_EQ(
+        projection.remove_presynaptic_neuron_synapses(1),
+        source_projection.find_synapses(1, DeltaProjection::Search::by_presynaptic).size());
+    ASSERT_FALSE(projection.is_mapped());
+    ASSERT_TRUE(projection_copy.is_mapped());
+    const auto *mapped_file = projection_copy.get_mapped_file();
+    const auto *mapped_parameters = mapped_file->get_parameters<DeltaProjection::SynapseParameters>();
+    for (size_t i = 0; i < projection_copy.size(); ++i)
+    {
+        ASSERT_EQ(mapped_parameters[i].weight_, std::get<knc::synapse_data>(source_projection[i]).weight_);
+        ASSERT_EQ(mapped_file->get_target_neurons()[i], std::get<knc::target_neuron_id>(source_projection[i]));
+    }
+
+    // A mapped projection is saved without materialization.
+    const auto copy_path = std::filesystem::temp_directory_path() / "knp_mapped_projection_copy_test.bin";
+    projection_copy.save_mapped(copy_path);
+    ASSERT_TRUE(projection_copy.is_mapped());
+    ASSERT_EQ(
+        (DeltaProjection{knc::UID{}, knc::UID{}, DeltaProjection::MappedSynapses{copy_path}}.size()),
+        source_projection.size());
+    std::filesystem::remove(copy_path);
+
+    // Synapse indexes are the last file section, so the last index is replaced with an index of a missing synapse.
+    {
+        std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+        const size_t wrong_index = source_projection.size();
+        stream.seekp(-static_cast<std::streamoff>(sizeof(wrong_index)), std::ios::end);
+        stream.write(reinterpret_cast<const char *>(&wrong_index), sizeof(wrong_index));
+    }
+    ASSERT_THROW((DeltaProjection{knc::UID{}, knc::UID{}, DeltaProjection::MappedSynapses{path}}), std::runtime_error);
+
+    // Synapse count follows the magic number and sizes of parameters and indexes in the header, and a count for
+    // which the file size overflows is rejected.
+    {
+        std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+        const uint64_t wrong_count = std::numeric_limits<uint64_t>::max() / 4;
+        stream.seekp(24);
+        stream.write(reinterpret_cast<const char *>(&wrong_count), sizeof(wrong_count));
+    }
+    ASSERT_THROW((DeltaProjection{knc::UID{}, knc::UID{}, DeltaProjection::MappedSynapses{path}}), std::runtime_error);
+
+    std::filesystem::remove(path);
+    ASSERT_THROW((DeltaProjection{knc::UID{}, knc::UID{}, DeltaProjection::MappedSynapses{path}}), std::runtime_error);
+}
+
+
+TEST(ProjectionSuite, QuantizationTest)
+{
+    const size_t size_from = 6;
+    const size_t size_to = 4;
+    const std::vector<float> weights{0.f, 1.f, -0.5f, 2.75f, 0.1f, -12.f};
+    DeltaProjection source_projection{
+        knc::UID{}, knc::UID{},
+        [&weights](size_t index) -> std::optional<Synapse>
+        {
+            return Synapse{
+                {weights[index % weights.size()], static_cast<uint32_t>(index % 3 + 1),
+                 knp::synapse_traits::OutputType::EXCITATORY},
+                index % size_from, index / size_from};
+        },
+        size_from * size_to};
+
+    // Half-precision weights keep about 3 significant decimal digits.
+    DeltaProjection projection = source_projection;
+    projection.quantize_weights(knc::WeightQuantization::float16);
+    ASSERT_EQ(projection.get_weight_quantization(), knc::WeightQuantization::float16);
+    ASSERT_EQ(projection.size(), source_projection.size());
+    const auto *quantized = projection.get_quantized_synapses();
+    ASSERT_NE(quantized, nullptr);
+    for (size_t i = 0; i < quantized->size(); ++i)
+    {
+        const auto expected = std::get<knc::synapse_data>(source_projection[i]);
+        ASSERT_NEAR(quantized->get_weight(i), expected.weight_, std::abs(expected.weight_) / 1024);
+        ASSERT_EQ(quantized->get_parameters(i).delay_, expected.delay_);
+    }
+    const auto range = projection.get_presynaptic_synapses(1);
+    ASSERT_EQ(
+        std::vector<size_t>(range.begin(), range.end()),
+        source_projection.find_synapses(1, DeltaProjection::Search::by_presynaptic));
+
+    // 8-bit weights are scaled, so the largest absolute weight is exact.
+    projection.quantize_weights(knc::WeightQuantization::int8);
+    quantized = projection.get_quantized_synapses();
+    ASSERT_EQ(quantized->quantization_, knc::WeightQuantization::int8);
+    ASSERT_FLOAT_EQ(quantized->scale_, 12.f / 127);
+    for (size_t i = 0; i < quantized->size(); ++i)
+    {
+        ASSERT_NEAR(
+            quantized->get_weight(i), std::get<knc::synapse_data>(source_projection[i]).weight_, quantized->scale_ / 2);
+    }
+    ASSERT_FLOAT_EQ(quantized->get_weight(5), -12.f);
+
+    // Copies share quantized weights. Constant access returns dequantized synapses, and non-constant access
+    // dequantizes the projection.
+    const DeltaProjection projection_copy = projection;
+    ASSERT_EQ(projection_copy.get_quantized_synapses(), quantized);
+    ASSERT_FLOAT_EQ(std::get<knc::synapse_data>(std::as_const(projection)[5]).weight_, -12.f);
+    ASSERT_EQ(projection.get_quantized_synapses(), quantized);
+    ASSERT_EQ(std::get<knc::target_neuron_id>(projection[7]), 1);
+    ASSERT_EQ(projection.get_weight_quantization(), knc::WeightQuantization::none);
+    ASSERT_EQ(projection_copy.get_weight_quantization(), knc::WeightQuantization::int8);
+    ASSERT_EQ(projection.find_synapses(1, DeltaProjection::Search::by_presynaptic).size(), size_to);
+
+    projection.unlock_weights();
+    ASSERT_THROW(projection.quantize_weights(knc::WeightQuantization::float16), std::logic_error);
+
+    ASSERT_EQ(knc::float16_to_float(knc::float_to_float16(65504.f)), 65504.f);
+    ASSERT_TRUE(std::isinf(knc::float16_to_float(knc::float_to_float16(1e6f))));
+    ASSERT_EQ(knc::float16_to_float(knc::float_to_float16(std::ldexp(1.f, -24))), std::ldexp(1.f, -24));
+}
+
+
 TEST(ProjectionSuite, LockTest)
 {
     DeltaProjection projection(knc::UID{}, knc::UID{});
@@ -24,6 +24,7 @@
 
 #include <tests_common.h>
 
+#include <algorithm>
 #include <vector>
 
 
@@ -145,6 +146,97 @@ TEST(ProjectionConnectors, FixedProbability)
 }
 
 
+TEST(ProjectionConnectors, FixedProbabilityParallel)
+{
+    using DeltaProjection = knp::core::Projection<knp::synapse_traits::DeltaSynapse>;
+    constexpr size_t src_pop_size = 30;
+    constexpr size_t dest_pop_size = 50;
+    constexpr uint64_t seed = 42;
+
+    const knp::framework::projection::synapse_generators::FixedProbability<knp::synapse_traits::DeltaSynapse> generator{
+        src_pop_size, dest_pop_size, 0.5,
+        knp::framework::projection::parameters_generators::default_synapse_gen<knp::synapse_traits::DeltaSynapse>,
+        seed};
+
+    const DeltaProjection serial_proj(knp::core::UID(), knp::core::UID(), generator, src_pop_size * dest_pop_size);
+    const DeltaProjection parallel_proj(
+        knp::core::UID(), knp::core::UID(), generator, src_pop_size * dest_pop_size,
+        DeltaProjection::ParallelGeneration{4});
+
+    // Results don't depend on the number of threads.
+    ASSERT_GT(serial_proj.size(), 0);
+    ASSERT_EQ(serial_proj.size(), parallel_proj.size());
+    for (size_t i = 0; i < serial_proj.size(); ++i)
+    {
+        ASSERT_EQ(
+            std::get<knp::core::source_neuron_id>(serial_proj[i]),
+            std::get<knp::core::source_neuron_id>(parallel_proj[i]));
+        ASSERT_EQ(
+            std::get<knp::core::target_neuron_id>(serial_proj[i]),
+            std::get<knp::core::target_neuron_id>(parallel_proj[i]));
+    }
+}
+
+
+TEST(ProjectionConnectors, ProceduralFixedProbability)
+{
+    using DeltaProjection = knp::core::Projection<knp::synapse_traits::DeltaSynapse>;
+    constexpr size_t src_pop_size = 30;
+    constexpr size_t dest_pop_size = 50;
+    constexpr uint64_t seed = 42;
+
+    const auto syn_gen =
+        knp::framework::projection::parameters_generators::default_synapse_gen<knp::synapse_traits::DeltaSynapse>;
+    auto procedural_proj =
+        knp::framework::projection::creators::procedural_fixed_probability<typename knp::synapse_traits::DeltaSynapse>(
+            knp::core::UID(), knp::core::UID(), src_pop_size, dest_pop_size, 0.5, syn_gen, seed);
+    ASSERT_TRUE(procedural_proj.is_procedural());
+    // Expected number of synapses is 750 with standard deviation about 19.
+    ASSERT_GT(procedural_proj.size(), 650);
+    ASSERT_LT(procedural_proj.size(), 850);
+
+    // Synapses of a neuron are the same each time they are generated, and postsynaptic neurons are ascending.
+    std::vector<DeltaProjection::Synapse> synapses;
+    std::vector<DeltaProjection::Synapse> regenerated_synapses;
+    std::vector<size_t> targets;
+    for (size_t neuron_index = 0; neuron_index < src_pop_size; ++neuron_index)
+    {
+        procedural_proj.generate_presynaptic_synapses(neuron_index, synapses);
+        procedural_proj.generate_presynaptic_synapses(neuron_index, regenerated_synapses);
+        ASSERT_EQ(synapses.size(), regenerated_synapses.size());
+        targets.clear();
+        for (size_t pos = 0; pos < synapses.size(); ++pos)
+        {
+            ASSERT_EQ(std::get<knp::core::source_neuron_id>(synapses[pos]), neuron_index);
+            ASSERT_EQ(
+                std::get<knp::core::target_neuron_id>(synapses[pos]),
+                std::get<knp::core::target_neuron_id>(regenerated_synapses[pos]));
+            targets.push_back(std::get<knp::core::target_neuron_id>(synapses[pos]));
+        }
+        ASSERT_TRUE(std::is_sorted(targets.begin(), targets.end()));
+        ASSERT_TRUE(std::adjacent_find(targets.begin(), targets.end()) == targets.end());
+        ASSERT_TRUE(targets.empty() || targets.back() < dest_pop_size);
+    }
+
+    // Probabilities `0` and `1` make no synapses and all synapses.
+    ASSERT_EQ(
+        knp::framework::projection::creators::procedural_fixed_probability<typename knp::synapse_traits::DeltaSynapse>(
+            knp::core::UID(), knp::core::UID(), src_pop_size, dest_pop_size, 0, syn_gen, seed)
+            .size(),
+        0);
+    ASSERT_EQ(
+        knp::framework::projection::creators::procedural_fixed_probability<typename knp::synapse_traits::DeltaSynapse>(
+            knp::core::UID(), knp::core::UID(), src_pop_size, dest_pop_size, 1, syn_gen, seed)
+            .size(),
+        src_pop_size * dest_pop_size);
+
+    const size_t procedural_size = procedural_proj.size();
+    procedural_proj.materialize();
+    ASSERT_FALSE(procedural_proj.is_procedural());
+    ASSERT_EQ(procedural_proj.size(), procedural_size);
+}
+
+
 TEST(ProjectionConnectors, IndexBased)
 {
     constexpr size_t src_pop_size = 5;
@@ -130,3 +130,39 @@ TEST_F(SaveLoadNetworkSuite, SaveLoadTest)
     auto network_loaded = knp::framework::sonata::load_network(path_to_network_);
     ASSERT_TRUE(are_networks_similar(network, network_loaded));
 }
+
+
+TEST_F(SaveLoadNetworkSuite, SaveLoadConvolutionTest)
+{
+    namespace kt = knp::testing;
+    path_to_network_ = ".";
+
+    // Input layer 4x4 is connected to two 3x3 output channels with a 2x2 kernel.
+    kt::DeltaProjection::Convolution convolution;
+    convolution.input_width_ = 4;
+    convolution.input_height_ = 4;
+    convolution.kernel_width_ = 2;
+    convolution.kernel_height_ = 2;
+    convolution.output_channels_ = 2;
+    for (size_t i = 0; i < 8; ++i)
+        convolution.kernel_.push_back({static_cast<float>(i), 1, knp::synapse_traits::OutputType::EXCITATORY});
+
+    kt::BLIFATPopulation input_population{kt::neuron_generator, 16};
+    kt::BLIFATPopulation output_population{kt::neuron_generator, 18};
+    kt::DeltaProjection projection{input_population.get_uid(), output_population.get_uid(), convolution};
+    knp::framework::Network network;
+    network.add_population(input_population);
+    network.add_population(output_population);
+    network.add_projection(projection);
+
+    knp::framework::sonata::save_network(network, path_to_network_);
+    auto network_loaded = knp::framework::sonata::load_network(path_to_network_);
+    ASSERT_TRUE(are_networks_similar(network, network_loaded));
+
+    const auto &loaded_projection =
+        network_loaded.get_projection<knp::synapse_traits::DeltaSynapse>(projection.get_uid());
+    ASSERT_NE(loaded_projection.get_convolution(), nullptr);
+    ASSERT_EQ(loaded_projection.get_convolution()->kernel_.size(), convolution.kernel_.size());
+    ASSERT_EQ(loaded_projection.get_convolution()->get_output_width(), 3);
+    ASSERT_EQ(loaded_projection.size(), projection.size());
+}